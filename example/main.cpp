@@ -6,19 +6,43 @@
 #include <cfg/cfg_include.h>
 #include <cfg/cfg_cppstring.h>
 #include <cfg/cfg_schema.h>
+#include <cfg/cfg_schema_validator.h>
 #include <cfg/parser_file_loader.h>
+#include <cfg/async_file_loader.h>
 #include <cfg/cfg_creator.h>
+#include <cfg/cfg_number.h>
+#include <cfg/cfg_shared_value.h>
+#include <cfg/cfg_frozen.h>
+#include <tml/tml_index.h>
 #include <tml/tml_string.h>
+#include <tml/tml_writer.h>
 #include <json/json_string.h>
 #include <json/json_parser.h>
+#include <json/json_writer.h>
 #include <cfg_cppstring_example.h>
 #include <interpreter/interpreter.h>
 #include <interpreter/interpreter_unit_tests.h>
 #include <btml/btml_stream.h>
 
+#include <set>
 #include <string>
+#include <sstream>
 #include <iostream>
 #include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cmath>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <locale>
+#if defined(_WIN32)
+#include <sys/types.h>
+#include <sys/utime.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
 
 #define INCLUDE_UNIT_TESTS
 
@@ -33,6 +57,7 @@ namespace
 				"------------------\n" <<
 				"  help                         ... print this help\n" <<
 				"  load-tml <filename>          ... check if loading the tml file is successful (no print)\n" <<
+				"  load-tml-parallel <filename> ... same as load-tml but parse chunks of the file by multiple threads\n" <<
 				"  load-btml <filename>         ... check if loading the btml file is successful (no print)\n" <<
 				"  print <filename>             ... print the tml file\n" <<
 				"  print-values <filename>      ... print the tml file without empty lines and comments\n" <<
@@ -48,7 +73,10 @@ namespace
 				"  include-buf <filename>       ... load tml file and include all other tml files and print it (with file buffering)\n" <<
 				"  include-once <filename>      ... load tml file and include all other tml files and print it (only once)\n" <<
 				"  include-once-buf <filename>  ... load tml file and include all other tml files and print it (only once, with file buffering)\n" <<
+				"  include-async <filename>     ... load tml file and include all other tml files and print it (included files are read ahead)\n" <<
 				"  print-tml-entries <filename> ... print each tml entry per line\n" <<
+				"  index <filename>             ... build the index of the top level entries and save it as <filename>.idx\n" <<
+				"  print-indexed <filename> <name> [<child-name>] ... print one entry with the (updated) index\n" <<
 				"  printjson <filename>         ... print the json file\n" <<
 				"  printjson2tml <filename>     ... print the json file as tml\n" <<
 				"  printtml2json <filename>     ... print the tml file as json\n" <<
@@ -60,20 +88,31 @@ namespace
 				"  printcppexample              ... print the cpp example\n" <<
 				"  interpreter-tests            ... some unit-tests for interpreter\n" <<
 				"  interpret <filename>         ... evaluate expressions\n" <<
+				"  interpret-parallel <filename> [<thread-count>] ... evaluate expressions with worker threads\n" <<
+				"  interpret-cache <filename>   ... evaluate expressions with an expression cache and print its statistic\n" <<
 				"  all-features <in-file> [<out-file>]     ... includes, templates, translations, profiles, variables, expressions\n" <<
 				"  validate <schema-filename> <filename>   ... validate\n" <<
+				"  validate-stream <schema-filename> <filename> [first] ... validate while parsing (tml, json or btml)\n" <<
 #ifdef INCLUDE_UNIT_TESTS
-				"  unit-tests <arg>             ... arg: btml, creator\n" <<
+				"  unit-tests <arg>             ... arg: btml, creator, select-rules, tml-parallel, numbers,\n"
+				"                                        shared-value, writers, allocations, frozen,\n"
+				"                                        accessors, numeric-arrays, packed-arrays,\n"
+				"                                        projection, top-level-entries, index, feed,\n"
+				"                                        validate-stream, async-loader\n" <<
 #endif
 				std::endl;
 	}
 
-	int onlyLoadTml(const char* filename, bool inclEmptyLines, bool inclComments)
+	int onlyLoadTml(const char* filename, bool inclEmptyLines, bool inclComments,
+			bool parallel = false)
 	{
 		auto start = std::chrono::steady_clock::now();
 		cfg::TmlParser p(filename);
 		cfg::NameValuePair cvp;
-		if (!p.getAsTree(cvp, inclEmptyLines, inclComments)) {
+		bool success = parallel ?
+				p.getAsTreeParallel(cvp.mValue, inclEmptyLines, inclComments) :
+				p.getAsTree(cvp, inclEmptyLines, inclComments);
+		if (!success) {
 			std::cerr << "parse " << filename << " failed" << std::endl;
 			std::cerr << "error: " << p.getExtendedErrorMsg() << std::endl;
 			return 1;
@@ -181,26 +220,25 @@ namespace
 	int printTmlAsTmlFromStdIn(bool inclEmptyLines, bool inclComments)
 	{
 		std::string line;
-		std::string lines;
 		std::cout << "========================================" << std::endl;
 		std::cout << "Please input tml. Quit input with CTRL+D" << std::endl;
 		std::cout << "========================================" << std::endl;
-		while (std::getline(std::cin, line))
-		{
-			lines += line + "\n";
-		}
-		std::cout << "input:" << std::endl;
-		std::cout << "======" << std::endl;
-		std::cout << lines << std::endl;
-		std::cout << "======" << std::endl;
+		// each line is parsed while the input arrives (no buffering of the full input)
 		cfg::TmlParser p;
-		p.setStringBuffer("standard-input", lines);
+		p.beginFeed("standard-input", inclEmptyLines, inclComments);
 		cfg::NameValuePair cvp;
-		if (!p.getAsTree(cvp, inclEmptyLines, inclComments)) {
+		bool success = true;
+		while (success && std::getline(std::cin, line))
+		{
+			line.push_back('\n');
+			success = p.feed(line.data(), line.size());
+		}
+		if (!success || !p.finish(cvp.mValue)) {
 			std::cerr << "parse from standard input failed" << std::endl;
 			std::cerr << "error: " << p.getExtendedErrorMsg() << std::endl;
 			return 1;
 		}
+		std::cout << "======" << std::endl;
 		//std::string s = cfg::tmlstring::nameValuePairToString(0, cvp);
 		std::string s = cfg::tmlstring::valueToString(0, cvp.mValue);
 		std::cout << s << std::endl;
@@ -350,13 +388,22 @@ namespace
 	}
 
 	int includeAndPrint(const char* filename, bool includeOnce, bool inclEmptyLines,
-			bool inclComments, bool withFileBuffering, bool forceDeepByStoredDeepValue)
+			bool inclComments, bool withFileBuffering, bool forceDeepByStoredDeepValue,
+			bool readAhead = false)
 	{
-		cfg::ParserFileLoader loader(std::unique_ptr<cfg::TmlParser>(new cfg::TmlParser()));
+		std::unique_ptr<cfg::ParserFileLoader> loader;
+		if (readAhead) {
+			loader.reset(new cfg::AsyncFileLoader(
+					std::unique_ptr<cfg::TmlParser>(new cfg::TmlParser()), "include"));
+		}
+		else {
+			loader.reset(new cfg::ParserFileLoader(
+					std::unique_ptr<cfg::TmlParser>(new cfg::TmlParser())));
+		}
 		cfg::Value value;
 		std::string outErrorMsg;
 		cfg::inc::TFileMap includedFiles;
-		if (!cfg::inc::loadAndIncludeFiles(value, includedFiles, filename, loader,
+		if (!cfg::inc::loadAndIncludeFiles(value, includedFiles, filename, *loader,
 				"include", includeOnce, inclEmptyLines, inclComments, withFileBuffering,
 				outErrorMsg)) {
 			std::cerr << "parse/includes for " << filename << " failed" << std::endl;
@@ -380,6 +427,11 @@ namespace
 		for (const auto& v : includedFiles) {
 			std::cout << v.first << ", count: " << v.second << std::endl;
 		}
+		if (readAhead) {
+			std::cout << "read-ahead hits: " <<
+					static_cast<cfg::AsyncFileLoader*>(loader.get())->getReadAheadHitCount() <<
+					std::endl;
+		}
 		return 0;
 	}
 
@@ -409,6 +461,44 @@ namespace
 		return 0;
 	}
 
+	int buildIndex(const char* filename)
+	{
+		cfg::TmlIndex index;
+		std::string errMsg;
+		if (!index.build(filename, errMsg) ||
+				!index.save(cfg::TmlIndex::getIndexFilename(filename), errMsg)) {
+			std::cerr << "error: " << errMsg << std::endl;
+			return 1;
+		}
+		std::cout << index.getEntries().size() << " entries" << std::endl;
+		return 0;
+	}
+
+	int printIndexedEntry(const char* filename, const char* name, const char* childName)
+	{
+		cfg::TmlIndex index;
+		std::string errMsg;
+		if (!index.loadOrBuild(filename, errMsg)) {
+			std::cerr << "error: " << errMsg << std::endl;
+			return 1;
+		}
+		int entryIndex = childName ? index.find(name, childName) : index.find(name);
+		if (entryIndex < 0) {
+			std::cerr << "entry doesn't exist" << std::endl;
+			return 1;
+		}
+		cfg::TmlParser p;
+		cfg::NameValuePair cvp;
+		if (!p.getIndexedEntry(index, static_cast<std::size_t>(entryIndex), cvp)) {
+			std::cerr << "parse " << filename << " failed" << std::endl;
+			std::cerr << "error: " << p.getExtendedErrorMsg() << std::endl;
+			return 1;
+		}
+		std::string s = cfg::cfgstring::nameValuePairToString(0, cvp);
+		std::cout << s << std::endl;
+		return 0;
+	}
+
 	int printJson(const char* filename)
 	{
 		cfg::JsonParser p(filename);
@@ -580,7 +670,8 @@ namespace
 		return 0;
 	}
 
-	int interpret(const char* filename)
+	int interpret(const char* filename, bool parallel, unsigned int threadCount,
+			bool useCache)
 	{
 		cfg::TmlParser p(filename);
 		cfg::NameValuePair cvp;
@@ -595,7 +686,12 @@ namespace
 		std::cout << s << std::endl;
 
 		std::stringstream errMsg;
-		if (cfg::interpreter::interpretAndReplace(value, false, true, true, true, errMsg) == -1) {
+		cfg::interpreter::ExpressionCache cache;
+		cfg::interpreter::ExpressionCache* cachePtr = useCache ? &cache : nullptr;
+		int rv = parallel ?
+				cfg::interpreter::interpretAndReplaceParallel(value, false, true, true, true, threadCount, cachePtr, errMsg) :
+				cfg::interpreter::interpretAndReplace(value, false, true, true, true, cachePtr, errMsg);
+		if (rv == -1) {
 			std::cout << "=========== evaluate expressions FAILED ==========" << std::endl;
 			std::cout << errMsg.str() << std::endl;
 			return 1;
@@ -603,6 +699,11 @@ namespace
 		std::cout << "=========== after evaluate expressions ===========" << std::endl;
 		s = cfg::tmlstring::valueToString(0, value);
 		std::cout << s << std::endl;
+		if (useCache) {
+			std::cout << "============ expression cache statistic ==========" << std::endl;
+			std::cout << "entries: " << cache.size() << ", hits: " << cache.getHitCount() <<
+					", misses: " << cache.getMissCount() << std::endl;
+		}
 		return 0;
 	}
 
@@ -746,7 +847,7 @@ namespace
 		return 0;
 	}
 
-	int validate(const char* schemaFilename, const char* /*filename*/)
+	int validate(const char* schemaFilename, const char* filename)
 	{
 		cfg::TmlParser schemaParser(schemaFilename);
 		cfg::NameValuePair schemaCvp;
@@ -773,13 +874,123 @@ namespace
 		std::cout << "rv: " << (rv ? "true" : "false") << ", err msg: " << errMsg << std::endl;
 		std::cout << cfg::tmlstring::valueToString(0, cfgSchema) << std::endl;
 
-		//bool rv = cfg::schema::validate(value, errMsg);
-		return 0;
+		std::cout << "==================== compile schema ====================" << std::endl;
+		cfg::SchemaValidator validator;
+		errMsg.clear();
+		rv = validator.compile(nvfs, errMsg);
+		std::cout << "rv: " << (rv ? "true" : "false") << ", err msg: " << errMsg << std::endl;
+		if (!rv) {
+			return 1;
+		}
+
+		std::cout << "==================== validate ====================" << std::endl;
+		cfg::TmlParser parser(filename);
+		cfg::NameValuePair cvp;
+		if (!parser.getAsTree(cvp, false, false)) {
+			std::cerr << "parse " << filename << " failed" << std::endl;
+			std::cerr << "error: " << parser.getExtendedErrorMsg() << std::endl;
+			return 1;
+		}
+		auto start = std::chrono::steady_clock::now();
+		rv = validator.validate(cvp.mValue, errMsg);
+		auto end = std::chrono::steady_clock::now();
+		std::cout << "rv: " << (rv ? "true" : "false") << ", violations: " <<
+				validator.getViolationCount() << std::endl;
+		std::cout << errMsg;
+		std::cout << "validation time: " <<
+				std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() <<
+				" us" << std::endl;
+		return rv ? 0 : 1;
+	}
+
+	bool endsWith(const std::string& str, const std::string& ending)
+	{
+		return str.size() >= ending.size() &&
+				str.compare(str.size() - ending.size(), ending.size(), ending) == 0;
+	}
+
+	int validateStream(const char* schemaFilename, const char* filename,
+			bool stopAtFirstViolation)
+	{
+		cfg::TmlParser schemaParser(schemaFilename);
+		cfg::Value schemaValue;
+		if (!schemaParser.getAsTree(schemaValue)) {
+			std::cerr << "parse " << schemaFilename << " failed" << std::endl;
+			std::cerr << "error: " << schemaParser.getExtendedErrorMsg() << std::endl;
+			return 1;
+		}
+		std::string errMsg;
+		cfg::NVFragmentSchema nvfs;
+		cfg::SchemaValidator validator;
+		if (!cfg::schema::getSchemaFromCfgValue(nvfs, schemaValue, errMsg) ||
+				!validator.compile(nvfs, errMsg)) {
+			std::cerr << "load schema " << schemaFilename << " failed" << std::endl;
+			std::cerr << "error: " << errMsg << std::endl;
+			return 1;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		bool rv = false;
+		std::string fname = filename;
+		if (endsWith(fname, ".json")) {
+			cfg::JsonParser parser(fname);
+			rv = parser.validateStream(validator, stopAtFirstViolation, errMsg);
+		}
+		else if (endsWith(fname, ".btml")) {
+			std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+			if (!ifs.is_open() || ifs.fail()) {
+				std::cout << "Can't open " << filename << std::endl;
+				return 1;
+			}
+			std::vector<uint8_t> buf((std::istreambuf_iterator<char>(ifs)),
+					std::istreambuf_iterator<char>());
+			rv = cfg::btmlstream::streamToValidatorWithOptionalHeader(buf.data(),
+					static_cast<unsigned int>(buf.size()), validator,
+					stopAtFirstViolation, errMsg) == buf.size();
+		}
+		else {
+			cfg::TmlParser parser(fname);
+			rv = parser.validateStream(validator, stopAtFirstViolation, errMsg);
+		}
+		auto end = std::chrono::steady_clock::now();
+		std::cout << "rv: " << (rv ? "true" : "false") << ", violations: " <<
+				validator.getViolationCount() << std::endl;
+		std::cout << errMsg;
+		std::cout << "validation time: " <<
+				std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() <<
+				" us" << std::endl;
+		return rv ? 0 : 1;
 	}
 }
 
 #ifdef INCLUDE_UNIT_TESTS
 static int unitTests(const std::string& testName);
+
+// count of all allocations (for unit test allocations)
+static std::atomic<std::size_t> allocationCount(0);
+
+void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* p = std::malloc(size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+// gcc can't see that operator new above uses malloc()
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
 #endif
 
 int main(int argc, char* argv[])
@@ -806,6 +1017,14 @@ int main(int argc, char* argv[])
 		}
 		return onlyLoadTml(argv[2], true, true);
 	}
+	if (command == "load-tml-parallel") {
+		if (argc != 3) {
+			std::cerr << "load-tml-parallel command need exactly one argument/filename" << std::endl;
+			printHelp(argv[0]);
+			return 1;
+		}
+		return onlyLoadTml(argv[2], true, true, true);
+	}
 	if (command == "load-btml") {
 		if (argc != 3) {
 			std::cerr << "load-btml command need exactly one argument/filename" << std::endl;
@@ -897,6 +1116,30 @@ int main(int argc, char* argv[])
 				command == "include-once" || command == "include-once-buf", true, true,
 				command == "include-buf" || command == "include-once-buf", false);
 	}
+	if (command == "index") {
+		if (argc != 3) {
+			std::cerr << "index command need exactly one argument/filename" << std::endl;
+			printHelp(argv[0]);
+			return 1;
+		}
+		return buildIndex(argv[2]);
+	}
+	if (command == "print-indexed") {
+		if (argc != 4 && argc != 5) {
+			std::cerr << "print-indexed command need a filename, a name and optional a child name" << std::endl;
+			printHelp(argv[0]);
+			return 1;
+		}
+		return printIndexedEntry(argv[2], argv[3], argc == 5 ? argv[4] : nullptr);
+	}
+	if (command == "include-async") {
+		if (argc != 3) {
+			std::cerr << "include-async command need exactly one argument/filename" << std::endl;
+			printHelp(argv[0]);
+			return 1;
+		}
+		return includeAndPrint(argv[2], false, true, true, false, false, true);
+	}
 	if (command == "print-tml-entries") {
 		if (argc != 3) {
 			std::cerr << "print-tml-entries command need exactly one argument/filename" << std::endl;
@@ -1021,7 +1264,23 @@ int main(int argc, char* argv[])
 			printHelp(argv[0]);
 			return 1;
 		}
-		return interpret(argv[2]);
+		return interpret(argv[2], false, 1, false);
+	}
+	if (command == "interpret-parallel") {
+		if (argc != 3 && argc != 4) {
+			std::cerr << "interpret-parallel command need a filename and optional thread-count" << std::endl;
+			printHelp(argv[0]);
+			return 1;
+		}
+		return interpret(argv[2], true, argc >= 4 ? static_cast<unsigned int>(atoi(argv[3])) : 0, false);
+	}
+	if (command == "interpret-cache") {
+		if (argc != 3) {
+			std::cerr << "interpret-cache command need exactly one argument/filename" << std::endl;
+			printHelp(argv[0]);
+			return 1;
+		}
+		return interpret(argv[2], false, 1, true);
 	}
 	if (command == "all-features") {
 		if (argc != 3 && argc != 4) {
@@ -1039,6 +1298,14 @@ int main(int argc, char* argv[])
 		}
 		return validate(argv[2], argv[3]);
 	}
+	if (command == "validate-stream") {
+		if (argc != 4 && !(argc == 5 && std::string(argv[4]) == "first")) {
+			std::cerr << "validate-stream command need two arguments (schema-filename and filename) and optional 'first'" << std::endl;
+			printHelp(argv[0]);
+			return 1;
+		}
+		return validateStream(argv[2], argv[3], argc == 5);
+	}
 	if (command == "unit-tests") {
 #ifdef INCLUDE_UNIT_TESTS
 		if (argc != 3) {
@@ -1138,6 +1405,352 @@ static int testBtml()
 	return success ? 0 : 1;
 }
 
+static bool printCheck(bool ok, const std::string& text)
+{
+	std::cout << text << (ok ? " OK" : " FAIL") << std::endl;
+	return ok;
+}
+
+// objectGet() with the rule array and with the compiled rules must be equal
+static bool testSelectRulesWithTml(const std::string& tml,
+		bool allowRandomSequence, bool allowUnusedValuePairs,
+		bool allowEarlyReturn, bool allowDuplicatedNames,
+		bool allowDuplicatedRuleNamesWithDiffTypes)
+{
+	cfg::Value val;
+	std::string errMsg;
+	if (!cfg::tmlparser::getValueFromString(val, tml, true, true, &errMsg)) {
+		std::cout << "'" << tml << "' FAIL: Can't get cfg::Value. err: " << errMsg << std::endl;
+		return false;
+	}
+	int a = 0;
+	std::string b;
+	float c = 0.0f;
+	int dInt = 0;
+	std::string dText;
+	const cfg::SelectRule rules[] = {
+		{"a", &a, cfg::SelectRule::RULE_MUST_EXIST},
+		{"b", &b, cfg::SelectRule::RULE_OPTIONAL},
+		{"c", &c, cfg::SelectRule::RULE_OPTIONAL},
+		{"d", &dInt, cfg::SelectRule::RULE_OPTIONAL},
+		{"d", &dText, cfg::SelectRule::RULE_MUST_EXIST},
+		{""}
+	};
+	const cfg::CompiledSelectRules compiledRules(rules);
+	std::string result[2];
+	for (int i = 0; i < 2; i++) {
+		std::size_t nextIndex = 0;
+		std::string warnings;
+		errMsg.clear();
+		int rv = (i == 0) ?
+				val.objectGet(rules, allowRandomSequence, allowUnusedValuePairs,
+						allowEarlyReturn, allowDuplicatedNames,
+						allowDuplicatedRuleNamesWithDiffTypes, 0, &nextIndex,
+						cfg::EReset::RESET_EVERYTHING_TO_DEFAULTS, &errMsg, &warnings) :
+				val.objectGet(compiledRules, allowRandomSequence, allowUnusedValuePairs,
+						allowEarlyReturn, allowDuplicatedNames,
+						allowDuplicatedRuleNamesWithDiffTypes, 0, &nextIndex,
+						cfg::EReset::RESET_EVERYTHING_TO_DEFAULTS, &errMsg, &warnings);
+		result[i] = std::to_string(rv) + " " + std::to_string(nextIndex) + " " +
+				std::to_string(a) + " " + b + " " + std::to_string(c) + " " +
+				std::to_string(dInt) + " " + dText + " '" + errMsg + "' '" + warnings + "'";
+	}
+	if (result[0] != result[1]) {
+		std::cout << "'" << tml << "' FAIL: '" << result[0] << "' != '" << result[1] << "'" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// return 0 for success, 1 for fail
+static int testSelectRules()
+{
+	bool success = true;
+	std::cout << "*** test select rules ***" << std::endl;
+	const char* tmls[] = {
+		"a = 1\nb = x\nc = 1.5\nd = text",
+		"a = 1\nd = 2\nd = text",
+		"d = text\nc = 2.5\na = 3",
+		"a = 1\nb = x\nb = y\nd = text",
+		"a = 1\ne = 5\nd = text",
+		"a = 1\nd = text\ne = 5\nb = x",
+		"b = x",
+		"a = 1\nd = 2",
+		"a = text\nd = text",
+		"",
+	};
+	unsigned int okCount = 0;
+	unsigned int testCount = 0;
+	for (const char* tml : tmls) {
+		// all combinations of the allow... parameters
+		for (unsigned int flags = 0; flags < 32; flags++) {
+			if (testSelectRulesWithTml(tml, flags & 1, flags & 2,
+					flags & 4, flags & 8, flags & 16)) {
+				++okCount;
+			}
+			++testCount;
+		}
+	}
+	std::cout << okCount << " of " << testCount << " rule tests OK" << std::endl;
+	success = (okCount == testCount) && success;
+
+	// more than 64 rules
+	const int ruleCount = 100;
+	int values[ruleCount] = {};
+	std::vector<cfg::SelectRule> rules;
+	std::string tml;
+	for (int i = 0; i < ruleCount; i++) {
+		std::string name = "r" + std::to_string(i);
+		rules.push_back(cfg::SelectRule(name, &values[i], cfg::SelectRule::RULE_MUST_EXIST));
+		tml += name + " = " + std::to_string(i) + "\n";
+	}
+	rules.push_back(cfg::SelectRule(""));
+	cfg::Value val;
+	std::string errMsg;
+	cfg::tmlparser::getValueFromString(val, tml, false, false, &errMsg);
+	const cfg::CompiledSelectRules compiledRules(rules.data());
+	int rv = val.objectGet(rules.data(), false, false, false, false, false, 0, nullptr,
+			cfg::EReset::RESET_EVERYTHING_TO_DEFAULTS, &errMsg);
+	int compiledRv = val.objectGet(compiledRules, false, false, false, false, false, 0, nullptr,
+			cfg::EReset::RESET_EVERYTHING_TO_DEFAULTS, &errMsg);
+	if (rv != ruleCount || compiledRv != ruleCount || values[ruleCount - 1] != ruleCount - 1) {
+		std::cout << ruleCount << " rules FAIL: " << rv << ", " << compiledRv <<
+				", err: " << errMsg << std::endl;
+		success = false;
+	}
+	else {
+		std::cout << ruleCount << " rules OK" << std::endl;
+	}
+
+	// an int64 isn't clamped into an int rule, an uint rule takes it if it fits
+	cfg::Value bigVal;
+	cfg::tmlparser::getValueFromString(bigVal, "port = 3000000000", false, false, &errMsg);
+	int port = 0;
+	unsigned int uport = 0;
+	int64_t port64 = 0;
+	const cfg::SelectRule intRules[] = {{"port", &port, cfg::SelectRule::RULE_MUST_EXIST}, {""}};
+	const cfg::SelectRule uintRules[] = {{"port", &uport, cfg::SelectRule::RULE_MUST_EXIST}, {""}};
+	const cfg::SelectRule int64Rules[] = {{"port", &port64, cfg::SelectRule::RULE_MUST_EXIST}, {""}};
+	errMsg.clear();
+	rv = bigVal.objectGet(intRules, false, false, false, false, false, 0, nullptr,
+			cfg::EReset::RESET_EVERYTHING_TO_DEFAULTS, &errMsg);
+	compiledRv = bigVal.objectGet(cfg::CompiledSelectRules(intRules), false, false, false,
+			false, false, 0, nullptr, cfg::EReset::RESET_EVERYTHING_TO_DEFAULTS, nullptr);
+	success = printCheck(rv == -5 && compiledRv == -5 && port == 0 &&
+			errMsg.find("out of range") != std::string::npos, "int64 into int rule") && success;
+	rv = bigVal.objectGet(uintRules, false, false, false, false, false, 0, nullptr);
+	success = printCheck(rv == 1 && uport == 3000000000u, "int64 into uint rule") && success;
+	rv = bigVal.objectGet(int64Rules, false, false, false, false, false, 0, nullptr);
+	success = printCheck(rv == 1 && port64 == 3000000000LL, "int64 into int64 rule") && success;
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+static std::string getJsonText(const cfg::Value& val)
+{
+	std::ostringstream oss;
+	cfg::jsonstring::valueToStream(0, val, oss, -2, false, false);
+	return oss.str();
+}
+
+// the number must have the expected type and must be the same after
+// tml -> btml -> tml and after json -> json
+static bool testNumberWithText(const std::string& number, cfg::Value::EValueType type)
+{
+	cfg::Value root;
+	std::string errMsg;
+	if (!cfg::tmlparser::getValueFromString(root, number, false, false, &errMsg) ||
+			root.mObject.size() != 1 || root.mObject[0].mName.mType != type) {
+		std::cout << "'" << number << "' FAIL: wrong type " << errMsg << std::endl;
+		return false;
+	}
+	// the number is the name of the single line
+	const cfg::Value& val = root.mObject[0].mName;
+	if (!testBtmlWithTml(number)) {
+		return false;
+	}
+	std::istringstream iss("{\"n\": " + number + "}");
+	cfg::Value jsonVal;
+	unsigned int lineNumber = 0;
+	if (!cfg::JsonParser::getAsTree(jsonVal, "numbers.json", iss, lineNumber, errMsg) ||
+			jsonVal.mObject.size() != 1 || jsonVal.mObject[0].mValue.mType != type ||
+			jsonVal.mObject[0].mValue.getInteger64() != val.getInteger64() ||
+			getJsonText(jsonVal.mObject[0].mValue) != number) {
+		std::cout << "'" << number << "' FAIL: json " << errMsg << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// decimal point of e.g. a german locale
+class CommaNumpunct : public std::numpunct<char>
+{
+protected:
+	virtual char do_decimal_point() const override { return ','; }
+};
+
+// return 0 for success, 1 for fail
+static int testNumbers()
+{
+	bool success = true;
+	std::cout << "*** test numbers ***" << std::endl;
+	success = testNumberWithText("2147483647", cfg::Value::TYPE_INT) && success;
+	success = testNumberWithText("-2147483648", cfg::Value::TYPE_INT) && success;
+	success = testNumberWithText("2147483648", cfg::Value::TYPE_INT64) && success;
+	success = testNumberWithText("-2147483649", cfg::Value::TYPE_INT64) && success;
+	success = testNumberWithText("9223372036854775807", cfg::Value::TYPE_INT64) && success;
+	success = testNumberWithText("-9223372036854775808", cfg::Value::TYPE_INT64) && success;
+	success = testNumberWithText("1.5", cfg::Value::TYPE_FLOAT) && success;
+	success = testNumberWithText("-0.123457", cfg::Value::TYPE_FLOAT) && success;
+	success = testNumberWithText("0.1234567", cfg::Value::TYPE_DOUBLE) && success;
+	success = testNumberWithText("3.141592653589793", cfg::Value::TYPE_DOUBLE) && success;
+	success = testNumberWithText("-123456789012.5", cfg::Value::TYPE_DOUBLE) && success;
+	success = testNumberWithText("1000000.0", cfg::Value::TYPE_DOUBLE) && success;
+	success = testNumberWithText("0.00001", cfg::Value::TYPE_DOUBLE) && success;
+	success = testBtmlWithTml("0.1 0.2 0.30000000000000004") && success;
+
+	// JSON: exponent, integer out of the int64_t range
+	const char* jsonNumbers[] = {
+		"1e300", "1.0e+300",
+		"-2.5E-10", "-2.5e-10",
+		"12345678901234567890", "12345678901234567000.0",
+		"0.1e1", "1",
+	};
+	for (std::size_t i = 0; i < sizeof(jsonNumbers) / sizeof(jsonNumbers[0]); i += 2) {
+		std::istringstream iss(std::string("[") + jsonNumbers[i] + "]");
+		cfg::Value jsonVal;
+		unsigned int lineNumber = 0;
+		std::string errMsg;
+		std::string result;
+		if (cfg::JsonParser::getAsTree(jsonVal, "numbers.json", iss, lineNumber, errMsg) &&
+				jsonVal.mArray.size() == 1) {
+			result = getJsonText(jsonVal.mArray[0]);
+		}
+		if (result != jsonNumbers[i + 1]) {
+			std::cout << "'" << jsonNumbers[i] << "' FAIL: json '" << result <<
+					"' != '" << jsonNumbers[i + 1] << "' " << errMsg << std::endl;
+			success = false;
+		}
+	}
+
+	// the global locale must not change the numbers (more than 19 digits
+	// are not parsed by the fast path)
+	std::locale previousLocale = std::locale::global(
+			std::locale(std::locale::classic(), new CommaNumpunct()));
+	const std::string longNumber = "0.12345678901234567890123";
+	cfg::Value longVal;
+	bool parsed = cfg::number::parseNumber(longNumber.data(),
+			longNumber.data() + longNumber.size(), true, longVal);
+	std::string longText = cfg::number::doubleToString(longVal.mDouble, true);
+	std::string floatText = cfg::number::doubleToString(1.5, false);
+	double outOfRange = cfg::number::stringToDouble("-1e400");
+	std::locale::global(previousLocale);
+	success = printCheck(parsed && longVal.isDouble() &&
+			longText == "0.12345678901234568" && floatText == "1.5" &&
+			std::isinf(outOfRange) && outOfRange < 0.0,
+			"independent of the locale") && success;
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// values must be equal including the positions (line numbers, offsets, deeps)
+static bool isEqualWithPositions(const cfg::Value& a, const cfg::Value& b)
+{
+	if (a.mLineNumber != b.mLineNumber || a.mOffset != b.mOffset ||
+			a.mNvpDeep != b.mNvpDeep || a.mObject.size() != b.mObject.size() ||
+			a.mArray.size() != b.mArray.size()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < a.mObject.size(); ++i) {
+		if (a.mObject[i].mDeep != b.mObject[i].mDeep ||
+				!isEqualWithPositions(a.mObject[i].mName, b.mObject[i].mName) ||
+				!isEqualWithPositions(a.mObject[i].mValue, b.mObject[i].mValue)) {
+			return false;
+		}
+	}
+	for (std::size_t i = 0; i < a.mArray.size(); ++i) {
+		if (!isEqualWithPositions(a.mArray[i], b.mArray[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// getAsTree() and getAsTreeParallel() must be equal
+static bool testTmlParallelWithTml(const std::string& testName, const std::string& tml)
+{
+	cfg::TmlParser p;
+	cfg::Value val;
+	p.setStringBuffer("parallel.tml", tml);
+	bool success = p.getAsTree(val, true, true);
+	std::string errMsg = p.getExtendedErrorMsg();
+	cfg::Value parallelVal;
+	bool parallelSuccess = p.getAsTreeParallel(parallelVal, true, true, 8);
+	std::string parallelErrMsg = p.getExtendedErrorMsg();
+	if (success != parallelSuccess || errMsg != parallelErrMsg) {
+		std::cout << testName << " FAIL: '" << errMsg << "' != '" << parallelErrMsg << "'" << std::endl;
+		return false;
+	}
+	if (cfg::tmlstring::valueToString(0, val) != cfg::tmlstring::valueToString(0, parallelVal) ||
+			!isEqualWithPositions(val, parallelVal)) {
+		std::cout << testName << " FAIL: different values" << std::endl;
+		return false;
+	}
+	std::cout << testName << " OK" << std::endl;
+	return true;
+}
+
+// return 0 for success, 1 for fail
+static int testTmlParallel()
+{
+	bool success = true;
+	std::cout << "*** test tml parallel ***" << std::endl;
+	// comments and empty lines which are moved to the parent or to the child
+	const std::string block =
+			"a-object\n"
+			"\ts = x\n"
+			"# asdf\n"
+			"\tentry1\n"
+			"\t\t# asdf asdf\n"
+			"\n"
+			"\t\tasdf\n"
+			"\taa\n"
+			"\ttrue = false\n"
+			"\t\t# moved to the root\n"
+			"\n"
+			"array-by-multiple-rows = []\n"
+			"\tentry1\n"
+			"\t{}\n"
+			"\t\ta = 1\n"
+			"\t# comment in array\n"
+			"\taa\n"
+			"\t\t\t# moved\n"
+			"null\n"
+			"abc = 1 2 3\n";
+	std::string tml;
+	std::string spaceTml;
+	for (int i = 0; tml.size() < 1024 * 1024; ++i) {
+		tml += block;
+		tml += "entry" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+	}
+	for (char ch : tml) {
+		if (ch == '\t') {
+			spaceTml += "    ";
+		}
+		else {
+			spaceTml += ch;
+		}
+	}
+	success = testTmlParallelWithTml("small", block) && success;
+	success = testTmlParallelWithTml("tabs", tml) && success;
+	success = testTmlParallelWithTml("spaces", spaceTml) && success;
+	success = testTmlParallelWithTml("no line break at the end", tml + "last") && success;
+	success = testTmlParallelWithTml("error", tml + "\t\t\twrong deep\n" + tml) && success;
+	success = testTmlParallelWithTml("wrong indention", spaceTml + "  two spaces\n") && success;
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
 // return 0 for success, 1 for fail
 static int testCreator()
 {
@@ -1203,6 +1816,1274 @@ static int testCreator()
 	else {
 		std::cout << "no warnings" << std::endl;
 	}
+
+	// takeCfg() moves the same config out and starts with an empty root
+	cfg::Value taken = cc.takeCfg();
+	success = printCheck(cfg::tmlstring::valueToString(0, taken) == s &&
+			cc.getCfg().isObject() && cc.getCfg().mObject.empty(),
+			"takeCfg") && success;
+
+	// many entries (linear time), rvalue texts are moved
+	const int entryCount = 100000;
+	std::string movedText = "a text which is longer than the small string buffer";
+	cc.pushArray("entries");
+	for (int i = 0; i < entryCount; ++i) {
+		cc.pushObject("").nvpInt("i", i).nvpText("t", std::to_string(i)).popObject();
+	}
+	cc.popArray().nvpText("moved", std::move(movedText)).nvpNull("null");
+	taken = cc.takeCfg();
+	const cfg::Value* entries = taken.objectGetValue("entries");
+	success = printCheck(entries && entries->mArray.size() == entryCount &&
+			entries->mArray.back().objectGetInteger("i") == entryCount - 1 &&
+			entries->mArray.back().objectGetText("t") == std::to_string(entryCount - 1) &&
+			taken.objectGetText("moved") == "a text which is longer than the small string buffer" &&
+			taken.objectGetValue("null") && taken.objectGetValue("null")->isNull() &&
+			!cc.warningsExist(),
+			"many entries") && success;
+
+	// a move keeps the open containers (e.g. a creator returned by a function)
+	cfg::CfgCreator first;
+	first.nvpInt("a", 1).pushObject("sub").pushArray("list").valInt(1);
+	cfg::CfgCreator moved(std::move(first));
+	moved.valInt(2).popArray().nvpInt("b", 2).popObject().nvpInt("c", 3);
+	cfg::CfgCreator assigned;
+	assigned = std::move(moved);
+	assigned.nvpInt("d", 4);
+	first.nvpInt("x", 0);
+	cfg::Value movedCfg = assigned.getCfg();
+	const cfg::Value* sub = movedCfg.objectGetValue("sub");
+	success = printCheck(movedCfg.mObject.size() == 4 && sub &&
+			sub->objectGetValue("list") && sub->objectGetValue("list")->mArray.size() == 2 &&
+			sub->objectGetInteger("b") == 2 && movedCfg.objectGetInteger("d") == 4 &&
+			first.getCfg().mObject.size() == 1 && moved.getCfg().mObject.empty() &&
+			!assigned.warningsExist(), "move") && success;
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// return 0 for success, 1 for fail
+static int testSharedValue()
+{
+	bool success = true;
+	std::cout << "*** test shared value ***" << std::endl;
+	const std::string tml =
+			"a\n"
+			"\tposition = 1 2 3\n"
+			"\tscale = 2\n"
+			"b\n"
+			"\tposition = 4 5 6\n"
+			"\tsub\n"
+			"\t\tx = 1\n";
+	cfg::Value value = cfg::tmlparser::getValueFromString(tml);
+	cfg::SharedValue original(value);
+	success = printCheck(cfg::tmlstring::valueToString(0, original.toValue()) ==
+			cfg::tmlstring::valueToString(0, value), "toValue") && success;
+
+	// all members of the heads (e.g. parse base, quotes, int64, packed)
+	cfg::Value heads = cfg::tmlparser::getValueFromString(
+			"hex = 0x1F\nquoted = \"text\"\nbig = 3000000000\npi = 3.141592653589793\n"
+			"packed = 1 2 3\n");
+	heads.mObject[4].mValue.packArray();
+	success = printCheck(cfg::cfgstring::valueToString(0, cfg::SharedValue(heads).toValue()) ==
+			cfg::cfgstring::valueToString(0, heads) &&
+			cfg::SharedValue(heads).objectAt(4).mValue.head().isPackedArray(),
+			"toValue keeps the heads") && success;
+
+	cfg::SharedValue copy = original;
+	success = printCheck(copy.isSameNode(original) && copy.isShared(),
+			"copy shares the root") && success;
+
+	// change b/sub/x --> only root, b and sub are cloned
+	copy.mutableObjectAt(1).mValue.mutableObjectAt(1).mValue
+			.mutableObjectAt(0).mValue.mutableHead().setInteger(7);
+	const cfg::SharedValue& origB = original.objectAt(1).mValue;
+	const cfg::SharedValue& copyB = copy.objectAt(1).mValue;
+	success = printCheck(!copy.isSameNode(original) &&
+			copy.objectAt(0).mValue.isSameNode(original.objectAt(0).mValue) &&
+			!copyB.isSameNode(origB) &&
+			copyB.objectAt(0).mValue.isSameNode(origB.objectAt(0).mValue) &&
+			!copyB.objectAt(1).mValue.isSameNode(origB.objectAt(1).mValue),
+			"only the changed path is cloned") && success;
+	success = printCheck(
+			origB.objectAt(1).mValue.objectAt(0).mValue.head().mInteger == 1 &&
+			copyB.objectAt(1).mValue.objectAt(0).mValue.head().mInteger == 7,
+			"original is unchanged") && success;
+
+	cfg::Value changed = copy.toValue();
+	const cfg::Value* x = changed.mObject[1].mValue.objectGetValue("sub");
+	success = printCheck(x && x->objectGetInteger("x") == 7 &&
+			original.toValue().mObject[1].mValue.objectGetValue("sub")->objectGetInteger("x") == 1,
+			"changed toValue") && success;
+
+	// a not shared node isn't cloned
+	cfg::SharedValue single(std::move(value));
+	const cfg::Value* headBefore = &single.head();
+	single.mutableHead().mLineNumber = 100;
+	success = printCheck(headBefore == &single.head(), "no clone if not shared") && success;
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// same calls for CfgCreator and ValueWriter
+template<class T>
+static void createWriterTestCfg(T& c)
+{
+	c
+		.nvpInt("a", 1)
+		.comment("comment")
+		.empty()
+		.valText("without-assign")
+		.valNull().assign().valText("foo")
+		.valInt(1).assign().valBool(true)
+		.valText("text name").assign().valFloat(1.5f)
+		.nvpText("quotes", "a \"text\"\twith\\escapes")
+		.nvpText("number-text", "12")
+		.pushObject("empty-object").popObject()
+		.pushArray("empty-array").popArray()
+		.pushArray("simple-array").valInt(1).valText("two").valNull().valFloat(3.0f).popArray()
+		.pushObject("sub")
+			.nvpBool("b", false)
+			.pushObject("sub2")
+				.pushArray("array").valInt(1).valInt(2).popArray()
+				.nvpNull("n")
+			.popObject()
+		.popObject()
+		.pushArray("complex-array")
+			.valInt(1)
+			.valText("x")
+			.nvpInt("nvp", 2)
+			.pushArray("").popArray()
+			.pushObject("").popObject()
+			.pushArray("").valInt(3).valInt(4).popArray()
+			.pushArray("")
+				.pushArray("").pushObject("").popObject().popArray()
+				.comment("in array")
+			.popArray()
+			.pushObject("")
+				.nvpInt("i", 5)
+				.pushArray("deep").valInt(6).popArray()
+			.popObject()
+			.valBool(true)
+		.popArray()
+		.pushArray("json-simple-array")
+			.valInt(1)
+			.pushArray("").popArray()
+			.pushObject("").popObject()
+		.popArray()
+		.pushArray("array-after-comment").comment("c", false).valInt(1).popArray()
+		.configParseTextWithQuotes(true)
+		.nvpText("with-quotes", "text")
+		.configParseTextWithQuotes(false)
+		.nvpInt("last", 7)
+	;
+}
+
+// return 0 for success, 1 for fail
+static int testWriters()
+{
+	bool success = true;
+	std::cout << "*** test writers ***" << std::endl;
+	cfg::CfgCreator cc;
+	createWriterTestCfg(cc);
+	cfg::Value cfg = cc.takeCfg();
+
+	std::ostringstream tmlStream;
+	cfg::TmlWriter tmlWriter(tmlStream);
+	createWriterTestCfg(tmlWriter);
+	tmlWriter.finish();
+	std::string tml = cfg::tmlstring::valueToString(0, cfg);
+	success = printCheck(tmlStream.str() == tml && !tmlWriter.warningsExist(),
+			"tml writer") && success;
+	if (tmlStream.str() != tml) {
+		std::cout << tml << "---\n" << tmlStream.str() << "---" << std::endl;
+	}
+
+	const int indentModes[] = {-2, -1, 0, 3};
+	for (int indentMode : indentModes) {
+		std::ostringstream jsonStream;
+		cfg::JsonWriter jsonWriter(jsonStream, indentMode);
+		createWriterTestCfg(jsonWriter);
+		jsonWriter.finish();
+		std::string json = cfg::jsonstring::valueToString(0, cfg, indentMode);
+		success = printCheck(jsonStream.str() == json && !jsonWriter.warningsExist(),
+				"json writer, indent mode " + std::to_string(indentMode)) && success;
+		if (jsonStream.str() != json) {
+			std::cout << json << "---\n" << jsonStream.str() << "---" << std::endl;
+		}
+	}
+
+	// empty document
+	std::ostringstream emptyTml;
+	cfg::TmlWriter emptyTmlWriter(emptyTml);
+	emptyTmlWriter.finish();
+	std::ostringstream emptyJson;
+	cfg::JsonWriter emptyJsonWriter(emptyJson, 0);
+	emptyJsonWriter.finish();
+	cfg::Value emptyCfg;
+	emptyCfg.setObject();
+	success = printCheck(emptyTml.str() == cfg::tmlstring::valueToString(0, emptyCfg) &&
+			emptyJson.str() == cfg::jsonstring::valueToString(0, emptyCfg, 0),
+			"empty document") && success;
+
+	// open objects and arrays are closed by finish()
+	std::ostringstream openTml;
+	cfg::TmlWriter openTmlWriter(openTml);
+	openTmlWriter.pushObject("o").pushArray("a").valInt(1);
+	openTmlWriter.finish();
+	success = printCheck(openTml.str() == "o\n\ta = 1\n", "finish closes") && success;
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// return 0 for success, 1 for fail
+static int testFrozen()
+{
+	bool success = true;
+	std::cout << "*** test frozen document ***" << std::endl;
+	const std::string tml =
+			"# comment\n"
+			"server\n"
+			"\thost = localhost\n"
+			"\tport = 8080\n"
+			"\tratio = 0.5\n"
+			"\tbig = 10000000000\n"
+			"\tenabled = true\n"
+			"\tlist = 1 2 \"three\"\n"
+			"twice = 1\n"
+			"twice = 2\n"
+			"\n"
+			"1 2 = names are an array\n";
+	cfg::Value value = cfg::tmlparser::getValueFromString(tml);
+	cfg::FrozenDocument doc = cfg::freeze(value);
+	cfg::FrozenValue root = doc.root();
+	success = printCheck(cfg::tmlstring::valueToString(0, root.toValue()) ==
+			cfg::tmlstring::valueToString(0, value) &&
+			getJsonText(root.toValue()) == getJsonText(value), "toValue") && success;
+
+	cfg::FrozenValue server = root.objectGetValue("server");
+	float ratio = 0.0f;
+	const cfg::Value* origServer = value.objectGetValue("server");
+	success = printCheck(server.isObject() && origServer &&
+			server.objectGetText("host") == origServer->objectGetText("host") &&
+			server.objectGetInteger("port") == 8080 &&
+			std::abs(server.objectGetFloat("ratio", false) - 0.5f) < 0.0001f &&
+			std::abs(server.objectGetFloat("port", true) - 8080.0f) < 0.0001f &&
+			!server.objectGetFloat("port", false, ratio) &&
+			server.objectGetBool("enabled") &&
+			server.objectGetValue("big").getInteger64() == 10000000000LL &&
+			server.objectGetValue("big").getParseBase() == 10, "objectGet...") && success;
+	cfg::FrozenValue list = server.objectGetValue("list");
+	success = printCheck(list.arraySize() == 3 && list.arrayAt(1).getInteger() == 2 &&
+			list.arrayAt(2).isTextEqual("three") && !list.arrayAt(3).isValid(),
+			"array") && success;
+	success = printCheck(!root.objectGetValue("twice").isValid() &&
+			!value.objectGetValue("twice") &&
+			root.objectGetAttrIndex("twice") == value.objectGetAttrIndex("twice") &&
+			!root.objectGetValue("missing").isValid() &&
+			!root.objectGetValue("missing").objectGetValue("x").isValid() &&
+			root.objectGetInteger("missing") == 0, "duplicated and missing names") && success;
+
+	// many pairs with names which are found by the hash index
+	cfg::Value many;
+	many.setObject();
+	const int count = 10000;
+	for (int i = 0; i < count; ++i) {
+		many.mObject.emplace_back();
+		many.mObject.back().setTextInt("name-" + std::to_string(i), i);
+	}
+	cfg::FrozenDocument manyDoc = cfg::freeze(many);
+	bool found = manyDoc.getNodeCount() == 1 + 2 * static_cast<std::size_t>(count);
+	for (int i = 0; i < count && found; ++i) {
+		found = manyDoc.root().objectGetInteger("name-" + std::to_string(i)) == i &&
+				manyDoc.root().objectGetAttrIndex("name-" + std::to_string(i)) == i;
+	}
+	success = printCheck(found, "many names") && success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// return 0 for success, 1 for fail
+static int testAccessors()
+{
+	bool success = true;
+	std::cout << "*** test accessors without allocations ***" << std::endl;
+	const std::string tml =
+			"name = \"a long text which doesn't fit into a small string buffer\"\n"
+			"count = 12\n"
+			"scale = 1.5\n"
+			"visible = true\n"
+			"point = 1 2\n"
+			"point = 3 4\n"
+			"point = 5 6\n";
+	cfg::Value value = cfg::tmlparser::getValueFromString(tml);
+	const cfg::Value& obj = value;
+
+	std::size_t before = allocationCount.load();
+	const std::string* name = obj.objectGetTextPtr("name");
+	int count = obj.objectGetInteger("count");
+	float scale = obj.objectGetFloat("scale", false);
+	bool visible = obj.objectGetBool("visible");
+	int pointIndex = obj.objectGetAttrIndex("point");
+	const cfg::Value* missing = obj.objectGetValue("missing");
+	const cfg::Value* point = obj.objectGetValue("point"); // more than once
+	int sum = 0;
+	std::size_t pointCount = 0;
+	for (const cfg::NameValuePair& nvp : obj.objectGetPairRange("point")) {
+		++pointCount;
+		for (const cfg::Value& element : nvp.mValue.mArray) {
+			sum += element.mInteger;
+		}
+	}
+	std::size_t allocations = allocationCount.load() - before;
+
+	success = printCheck(name && *name == obj.objectGetText(std::string("name")) &&
+			count == 12 && std::abs(scale - 1.5f) < 0.0001f && visible &&
+			pointIndex == 4 && !missing && !point, "results") && success;
+	success = printCheck(pointCount == 3 && sum == 21 &&
+			obj.objectGetPairRange("point").size() == obj.objectGetValuePairs("point").size() &&
+			obj.objectGetPairRange("missing").empty(), "pair range") && success;
+	success = printCheck(allocations == 0, "no allocations (" +
+			std::to_string(allocations) + ")") && success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// return 0 for success, 1 for fail
+static int testNumericArrays()
+{
+	bool success = true;
+	std::cout << "*** test numeric arrays ***" << std::endl;
+	const std::string tml =
+			"floats = 1.5 -2.25 3.0\n"
+			"ints = 1 2 -3 4\n"
+			"mixed = 1 2.5 10000000000\n"
+			"texts = 1 a 3\n"
+			"single = 5\n";
+	cfg::Value value = cfg::tmlparser::getValueFromString(tml);
+	const cfg::Value* floats = value.objectGetValue("floats");
+	const cfg::Value* ints = value.objectGetValue("ints");
+	const cfg::Value* mixed = value.objectGetValue("mixed");
+	const cfg::Value* texts = value.objectGetValue("texts");
+	if (!floats || !ints || !mixed || !texts) {
+		std::cout << "parse FAIL" << std::endl;
+		return 1;
+	}
+
+	success = printCheck(floats->arrayGetElementType() == cfg::Value::TYPE_FLOAT &&
+			ints->arrayGetElementType() == cfg::Value::TYPE_INT &&
+			mixed->arrayGetElementType() == cfg::Value::TYPE_NONE &&
+			value.objectGetValue("single")->arrayGetElementType() == cfg::Value::TYPE_NONE,
+			"element type") && success;
+
+	float fbuf[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	std::size_t count = 0;
+	success = printCheck(floats->arrayGetFloats(fbuf, 4, false, count) && count == 3 &&
+			std::abs(fbuf[0] - 1.5f) < 0.0001f && std::abs(fbuf[1] + 2.25f) < 0.0001f &&
+			std::abs(fbuf[2] - 3.0f) < 0.0001f, "floats") && success;
+	success = printCheck(!floats->arrayGetFloats(fbuf, 2, false, count) && count == 0,
+			"buffer too small") && success;
+	success = printCheck(!ints->arrayGetFloats(fbuf, 4, false, count) &&
+			ints->arrayGetFloats(fbuf, 4, true, count) && count == 4 &&
+			std::abs(fbuf[2] + 3.0f) < 0.0001f, "ints as floats") && success;
+
+	std::vector<int> iv;
+	std::vector<int64_t> i64v;
+	std::vector<double> dv;
+	success = printCheck(ints->arrayGetIntegers(iv) && iv.size() == 4 && iv[3] == 4 &&
+			!mixed->arrayGetIntegers(iv) && iv.empty() &&
+			!mixed->arrayGetInteger64s(i64v) &&
+			mixed->arrayGetDoubles(dv, true) && dv.size() == 3 &&
+			std::abs(dv[2] - 10000000000.0) < 0.5 &&
+			!texts->arrayGetDoubles(dv, true), "vectors") && success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+static int testPackedArrays()
+{
+	bool success = true;
+	std::cout << "*** test packed arrays ***" << std::endl;
+	const std::string tml =
+			"floats = 1.5 -2.25 3.0\n"
+			"ints = 1 2 -3 4\n"
+			"doubles = 3.141592653589793 -123456789012.5\n"
+			"mixed = 1 2.5\n"
+			"texts = 1 a 3\n"
+			"object\n"
+			"\tinner = 7 8 9\n";
+	cfg::Value value = cfg::tmlparser::getValueFromString(tml);
+	cfg::Value packed = value;
+	cfg::packNumericArrays(packed);
+	const cfg::Value* floats = packed.objectGetValue("floats");
+	const cfg::Value* ints = packed.objectGetValue("ints");
+	const cfg::Value* object = packed.objectGetValue("object");
+	if (!floats || !ints || !object || !object->objectGetValue("inner")) {
+		std::cout << "parse FAIL" << std::endl;
+		return 1;
+	}
+	success = printCheck(floats->isPackedArray() && ints->isPackedArray() &&
+			packed.objectGetValue("doubles")->isPackedArray() &&
+			object->objectGetValue("inner")->isPackedArray() &&
+			!packed.objectGetValue("mixed")->isPackedArray() &&
+			!packed.objectGetValue("texts")->isPackedArray() &&
+			floats->mArray.empty() && floats->arraySize() == 3, "pack") && success;
+	success = printCheck(cfg::tmlstring::valueToString(0, packed) ==
+			cfg::tmlstring::valueToString(0, value) &&
+			getJsonText(packed) == getJsonText(value), "tml and json output") && success;
+
+	float fbuf[3] = {0.0f, 0.0f, 0.0f};
+	std::size_t count = 0;
+	std::vector<int> iv;
+	success = printCheck(floats->arrayGetElementType() == cfg::Value::TYPE_FLOAT &&
+			floats->arrayGetFloats(fbuf, 3, false, count) && count == 3 &&
+			std::abs(fbuf[1] + 2.25f) < 0.0001f &&
+			ints->arrayGetIntegers(iv) && iv.size() == 4 && iv[2] == -3,
+			"bulk extraction") && success;
+
+	std::vector<uint8_t> packedStream;
+	std::vector<uint8_t> stream;
+	cfg::btmlstream::valueToStream(packed, packedStream);
+	cfg::btmlstream::valueToStream(value, stream);
+	cfg::Value btmlValue;
+	unsigned int bytes = cfg::btmlstream::streamToValue(packedStream.data(),
+			static_cast<unsigned int>(packedStream.size()), btmlValue, nullptr);
+	success = printCheck(bytes == packedStream.size() && packedStream.size() < stream.size() &&
+			btmlValue.objectGetValue("ints")->isPackedArray() &&
+			getJsonText(btmlValue) == getJsonText(value), "btml") && success;
+
+	cfg::Value unpacked = btmlValue;
+	cfg::Value& unpackedInts = unpacked.mObject[1].mValue;
+	unpackedInts.unpackArray();
+	success = printCheck(!unpackedInts.isPackedArray() && unpackedInts.mArray.size() == 4 &&
+			unpackedInts.mArray[3].isInteger() && unpackedInts.mArray[3].mInteger == 4 &&
+			btmlValue.objectGetValue("ints")->isPackedArray(), "unpack") && success;
+
+	cfg::JsonParser jsonParser;
+	jsonParser.setPackNumericArrays(true);
+	cfg::Value jsonValue;
+	success = printCheck(jsonParser.setStringBuffer("packed.json",
+			"{\"a\": [1, 2, 3], \"b\": [1, \"x\"]}") &&
+			jsonParser.getAsTree(jsonValue) &&
+			jsonValue.objectGetValue("a")->isPackedArray() &&
+			!jsonValue.objectGetValue("b")->isPackedArray(), "parser option") && success;
+
+	// the parsers pack while parsing, the result must be the same as of
+	// packNumericArrays() after parsing
+	const std::string json = "{\"a\": [1, 2, 3], \"b\": [1, 2, \"x\", 4], "
+			"\"c\": [[1.5, 2.5], []], \"d\": {\"e\": [3.25]}}";
+	cfg::JsonParser unpackedJsonParser;
+	cfg::Value expectedJson;
+	unpackedJsonParser.setStringBuffer("packed.json", json);
+	unpackedJsonParser.getAsTree(expectedJson);
+	cfg::packNumericArrays(expectedJson);
+	jsonParser.setStringBuffer("packed.json", json);
+	success = printCheck(jsonParser.getAsTree(jsonValue) &&
+			jsonValue.objectGetValue("b")->mArray.size() == 4 &&
+			jsonValue.objectGetValue("b")->mArray[2].isText() &&
+			jsonValue.objectGetValue("c")->mArray[0].isPackedArray() &&
+			getJsonText(jsonValue) == getJsonText(expectedJson) &&
+			cfg::cfgstring::valueToString(0, jsonValue) ==
+			cfg::cfgstring::valueToString(0, expectedJson), "json parser packs") && success;
+
+	const std::string packedTml = tml +
+			"list = []\n"
+			"\t1 2\n"
+			"\t3 4\n"
+			"numbers = []\n"
+			"\t5\n"
+			"\t6\n";
+	cfg::TmlParser tmlParser;
+	tmlParser.setPackNumericArrays(true);
+	tmlParser.setStringBuffer("packed.tml", packedTml);
+	cfg::Value tmlValue;
+	cfg::Value expectedTml = cfg::tmlparser::getValueFromString(packedTml);
+	cfg::packNumericArrays(expectedTml);
+	success = printCheck(tmlParser.getAsTree(tmlValue) &&
+			tmlValue.objectGetValue("list")->mArray[1].isPackedArray() &&
+			tmlValue.objectGetValue("numbers")->isPackedArray() &&
+			cfg::tmlstring::valueToString(0, tmlValue) ==
+			cfg::tmlstring::valueToString(0, expectedTml), "tml parser packs") && success;
+	cfg::TmlParser parentParser;
+	parentParser.setPackNumericArrays(true);
+	parentParser.setStringBuffer("packed.tml", "a = 1 2 3\n\tb = 1\n");
+	bool parentFailed = !parentParser.getAsTree(tmlValue);
+	success = printCheck(parentFailed && parentParser.getLineNumber() == 2,
+			"tml packed array as parent: " + parentParser.getExtendedErrorMsg()) && success;
+
+	cfg::Value btmlPacked;
+	bytes = cfg::btmlstream::streamToValue(stream.data(),
+			static_cast<unsigned int>(stream.size()), btmlPacked, nullptr, true);
+	success = printCheck(bytes == stream.size() &&
+			btmlPacked.objectGetValue("ints")->isPackedArray() &&
+			!btmlPacked.objectGetValue("texts")->isPackedArray() &&
+			getJsonText(btmlPacked) == getJsonText(value), "btml parser packs") && success;
+
+	// the elements are stored as little endian on each host
+	cfg::Value littleEndian;
+	littleEndian.setArray();
+	littleEndian.mArray.emplace_back();
+	littleEndian.mArray.back().setInteger(0x01020304);
+	littleEndian.packArray();
+	std::vector<uint8_t> littleEndianStream;
+	cfg::btmlstream::valueToStream(littleEndian, littleEndianStream);
+	const uint8_t expectedBytes[] = {0x20 | cfg::Value::TYPE_ARRAY, cfg::Value::TYPE_INT,
+			1, 4, 3, 2, 1};
+	success = printCheck(littleEndianStream.size() == sizeof(expectedBytes) &&
+			std::equal(littleEndianStream.begin(), littleEndianStream.end(), expectedBytes),
+			"btml little endian") && success;
+
+	// mArray of a packed array is empty --> no array pointer
+	const std::vector<cfg::Value>* intsArray = nullptr;
+	const cfg::SelectRule rules[] = {
+		{"ints", &intsArray, cfg::SelectRule::RULE_MUST_EXIST},
+		{""}
+	};
+	std::string errMsg;
+	int rv = packed.objectGet(rules, true, true, false, false, false, 0, nullptr,
+			cfg::EReset::RESET_POINTERS_TO_NULL, &errMsg);
+	success = printCheck(rv < 0 && !intsArray, "select rule: " + errMsg) && success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// only the top level pairs of value with one of the names
+static cfg::Value getProjectedValue(const cfg::Value& value,
+		const std::set<std::string>& names)
+{
+	cfg::Value projected;
+	projected.setObject();
+	for (const cfg::NameValuePair& nvp : value.mObject) {
+		if (nvp.mName.isText() && names.count(nvp.mName.mText)) {
+			projected.mObject.push_back(nvp);
+		}
+	}
+	return projected;
+}
+
+static int testProjection()
+{
+	bool success = true;
+	std::cout << "*** test projection ***" << std::endl;
+	const std::string tml =
+			"skipped-first\n"
+			"    a = 1\n"
+			"    inner\n"
+			"        b = \"text = with # chars\"\n"
+			"render\n"
+			"    width = 800\n"
+			"    size = 1 2 3\n"
+			"    pipeline\n"
+			"        stage = shadow\n"
+			"# a comment between the sections\n"
+			"\n"
+			"other = 1 2 3\n"
+			"audio = 44100\n"
+			"skipped-last\n"
+			"    c = true\n";
+	const std::vector<std::string> names = {"render", "audio"};
+	const std::set<std::string> nameSet(names.begin(), names.end());
+	cfg::Value full = cfg::tmlparser::getValueFromString(tml);
+	std::string expected = getJsonText(getProjectedValue(full, nameSet));
+
+	cfg::TmlParser tmlParser;
+	tmlParser.setProjection(names);
+	tmlParser.setStringBuffer("projection.tml", tml);
+	cfg::Value tmlValue;
+	success = printCheck(tmlParser.getAsTree(tmlValue) && tmlValue.mObject.size() == 2 &&
+			getJsonText(tmlValue) == expected, "tml") && success;
+	cfg::Value tmlParallelValue;
+	success = printCheck(tmlParser.getAsTreeParallel(tmlParallelValue, false, false, 4) &&
+			getJsonText(tmlParallelValue) == expected, "tml parallel") && success;
+
+	// a skipped section isn't parsed --> an error in it is not found
+	cfg::TmlParser skipErrorParser;
+	skipErrorParser.setProjection(names);
+	skipErrorParser.setStringBuffer("error.tml", "broken\n\t\t\tx = \"no end\naudio = 1\n");
+	cfg::Value skipErrorValue;
+	success = printCheck(skipErrorParser.getAsTree(skipErrorValue) &&
+			skipErrorValue.objectGetInteger("audio") == 1, "tml skipped error") && success;
+
+	std::string json = getJsonText(full);
+	cfg::JsonParser jsonParser;
+	jsonParser.setProjection(names);
+	jsonParser.setStringBuffer("projection.json", json);
+	cfg::Value jsonValue;
+	success = printCheck(jsonParser.getAsTree(jsonValue) && jsonValue.mObject.size() == 2 &&
+			getJsonText(jsonValue) == expected, "json") && success;
+	cfg::JsonParser jsonErrorParser;
+	jsonErrorParser.setProjection(names);
+	jsonErrorParser.setStringBuffer("error.json", "{\"audio\": [1, 2}");
+	success = printCheck(!jsonErrorParser.getAsTree(jsonValue), "json error") && success;
+
+	std::vector<uint8_t> btml;
+	cfg::btmlstream::valueToStreamWithHeader(full, btml, true);
+	cfg::Value btmlValue;
+	unsigned int bytes = cfg::btmlstream::streamToProjectedValueWithOptionalHeader(
+			btml.data(), static_cast<unsigned int>(btml.size()), btmlValue, nameSet);
+	success = printCheck(bytes == btml.size() && btmlValue.mObject.size() == 2 &&
+			getJsonText(btmlValue) == expected, "btml") && success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// return count of lines
+static std::size_t createDeepTml(std::string& outTml, int deep, int siblingCount)
+{
+	std::stringstream ss;
+	std::size_t lineCount = 0;
+	for (int d = 0; d < deep; ++d) {
+		ss << std::string(static_cast<std::size_t>(d), '\t') << "level-" << d << "\n";
+		++lineCount;
+	}
+	// the siblings are added after the deep child is complete
+	// --> each growing parent must move (not copy) its deep child
+	for (int d = deep - 1; d >= 0; --d) {
+		for (int i = 0; i < siblingCount; ++i) {
+			ss << std::string(static_cast<std::size_t>(d), '\t') <<
+					"sibling-" << i << " = " << i << " \"some text\"\n";
+			++lineCount;
+		}
+	}
+	outTml = ss.str();
+	return lineCount;
+}
+
+// the top level entries of getNextTopLevelEntry() must be the same as of getAsTree()
+static bool checkTopLevelEntries(const std::string& tml, bool inclEmptyLines,
+		bool inclComments, const std::string& text)
+{
+	cfg::TmlParser treeParser;
+	treeParser.setStringBuffer("entries.tml", tml);
+	cfg::Value root;
+	bool treeSuccess = treeParser.getAsTree(root, inclEmptyLines, inclComments);
+
+	cfg::TmlParser parser;
+	parser.setStringBuffer("entries.tml", tml);
+	cfg::Value entries;
+	entries.setObject();
+	entries.mLineNumber = 1;
+	entries.mOffset = 0;
+	int rv = -1;
+	if (parser.beginTopLevelEntries()) {
+		cfg::NameValuePair entry;
+		while ((rv = parser.getNextTopLevelEntry(entry, inclEmptyLines, inclComments)) == 0) {
+			entries.mObject.push_back(std::move(entry));
+		}
+	}
+	bool ok = false;
+	if (treeSuccess) {
+		ok = rv == -2 && cfg::cfgstring::valueToString(0, entries) ==
+				cfg::cfgstring::valueToString(0, root);
+	}
+	else {
+		ok = rv == -1 && parser.getExtendedErrorMsg() == treeParser.getExtendedErrorMsg();
+	}
+	return printCheck(ok, text);
+}
+
+static int testTopLevelEntries()
+{
+	bool success = true;
+	std::cout << "*** test top level entries ***" << std::endl;
+	const std::string tml =
+			"# leading comment\n"
+			"\n"
+			"entity\n"
+			"\t# comment of the entity\n"
+			"\n"
+			"\tname = first\n"
+			"\tpos = 1 2 3\n"
+			"\t\t# trailing comment of the entity\n"
+			"entity\n"
+			"\tname = second\n"
+			"\tchildren\n"
+			"\t\tchild = 1\n"
+			"\t\t# moved to the parents\n"
+			"\n"
+			"# comment of the root\n"
+			"count = 2\n"
+			"list = []\n"
+			"\t1\n"
+			"\t2\n";
+	success = checkTopLevelEntries(tml, false, false, "entries") && success;
+	success = checkTopLevelEntries(tml, true, true, "entries with empty lines and comments") && success;
+	std::string deepTml;
+	createDeepTml(deepTml, 10, 3);
+	success = checkTopLevelEntries(deepTml + deepTml, true, true, "deep entries") && success;
+	success = checkTopLevelEntries("a\n\tb = 1\nc\n\t\t\td = 2\n", false, false,
+			"error with line number") && success;
+
+	// the lines of only one top level entry are stored
+	std::stringstream ss;
+	const int entityCount = 1000;
+	for (int i = 0; i < entityCount; ++i) {
+		ss << "entity\n\tid = " << i << "\n\tpos = 1.0 2.0 3.0\n";
+	}
+	cfg::TmlParser parser;
+	parser.setStringBuffer("entities.tml", ss.str());
+	cfg::NameValuePair entry;
+	int count = 0;
+	int idSum = 0;
+	if (parser.beginTopLevelEntries()) {
+		while (parser.getNextTopLevelEntry(entry) == 0) {
+			idSum += entry.mValue.objectGetInteger("id");
+			++count;
+		}
+	}
+	success = printCheck(count == entityCount &&
+			idSum == entityCount * (entityCount - 1) / 2 &&
+			entry.mName.mLineNumber == 3 * entityCount - 2, "entities") && success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// each indexed entry must be the same as the entry of getAsTree()
+static bool checkIndexedEntries(const std::string& filename, const cfg::TmlIndex& index,
+		const std::string& text)
+{
+	cfg::TmlParser treeParser(filename);
+	cfg::Value root;
+	bool ok = treeParser.getAsTree(root);
+	cfg::TmlParser parser;
+	std::size_t entryIndex = 0;
+	for (const cfg::TmlIndex::Entry& indexEntry : index.getEntries()) {
+		cfg::NameValuePair entry;
+		ok = ok && parser.getIndexedEntry(index, entryIndex, entry);
+		const cfg::Value* parent = &root;
+		if (ok && indexEntry.mParentIndex >= 0) {
+			parent = root.objectGetValue(index.getEntries()[
+					static_cast<std::size_t>(indexEntry.mParentIndex)].mName);
+		}
+		const cfg::NameValuePair* expected = ok && parent ?
+				parent->objectGetValuePair(indexEntry.mName) : nullptr;
+		ok = expected && cfg::cfgstring::nameValuePairToString(0, *expected) ==
+				cfg::cfgstring::nameValuePairToString(0, entry) &&
+				cfg::cfgstring::valueToString(0, expected->mValue) ==
+				cfg::cfgstring::valueToString(0, entry.mValue);
+		++entryIndex;
+	}
+	return printCheck(ok && entryIndex > 0, text);
+}
+
+/**
+ * Set the modification time of a file explicitly, a rewrite can have the
+ * same time stamp (coarse time stamps of the file system).
+ * @return false if the time isn't stored exactly (e.g. no sub second
+ *         resolution of the file system)
+ */
+static bool setModificationTime(const std::string& filename, int64_t seconds,
+		long nanoseconds)
+{
+#if defined(_WIN32)
+	// only seconds
+	struct __utimbuf64 times;
+	times.actime = seconds;
+	times.modtime = seconds;
+	return _utime64(filename.c_str(), &times) == 0 && nanoseconds == 0;
+#else
+	struct timespec times[2];
+	times[0].tv_sec = static_cast<time_t>(seconds);
+	times[0].tv_nsec = nanoseconds;
+	times[1] = times[0];
+	struct stat st;
+	if (utimensat(AT_FDCWD, filename.c_str(), times, 0) != 0 ||
+			stat(filename.c_str(), &st) != 0) {
+		return false;
+	}
+#if defined(__APPLE__)
+	return st.st_mtimespec.tv_sec == times[1].tv_sec && st.st_mtimespec.tv_nsec == nanoseconds;
+#else
+	return st.st_mtim.tv_sec == times[1].tv_sec && st.st_mtim.tv_nsec == nanoseconds;
+#endif
+#endif
+}
+
+// rewrite the file with the same size
+static void replaceInFile(const std::string& filename, const std::string& from,
+		const std::string& to)
+{
+	std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+	std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	ifs.close();
+	content.replace(content.find(from), from.size(), to);
+	std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	ofs << content;
+}
+
+static int testIndex()
+{
+	bool success = true;
+	std::cout << "*** test index ***" << std::endl;
+	const std::string filename = "index-test.tml";
+	const std::string indexFilename = cfg::TmlIndex::getIndexFilename(filename);
+	{
+		std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		ofs << "# settings\n"
+				"render\n"
+				"  window\n"
+				"    width = 800\n"
+				"    height = 600\n"
+				"  # comment of the render entry\n"
+				"\n"
+				"  vsync = true\n"
+				"list = []\n"
+				"  1 2\n"
+				"  3\n"
+				"audio\n"
+				"  volume = 0.5\n"
+				"  device = \"default\"";
+	}
+	const int64_t modificationTime = 1600000000;
+	setModificationTime(filename, modificationTime, 0);
+	cfg::TmlIndex index;
+	std::string errMsg;
+	bool built = index.build(filename, errMsg);
+	success = printCheck(built && index.getEntries().size() == 7 &&
+			index.getIndentChar() == ' ' && index.getIndentCharCount() == 2,
+			"build " + errMsg) && success;
+	success = printCheck(index.find("render") == 0 && index.find("render", "vsync") == 2 &&
+			index.find("audio", "device") == 6 && index.find("audio", "vsync") < 0 &&
+			index.find("window") < 0, "find") && success;
+	success = checkIndexedEntries(filename, index, "indexed entries") && success;
+
+	cfg::TmlIndex loaded;
+	bool saved = index.save(indexFilename, errMsg) && loaded.load(indexFilename, errMsg);
+	success = printCheck(saved && loaded.isUpToDate() &&
+			loaded.getEntries().size() == index.getEntries().size() &&
+			loaded.getEntries()[1].mLineNumber == 3 && loaded.getEntries()[1].mParentIndex == 0,
+			"save and load " + errMsg) && success;
+	success = checkIndexedEntries(filename, loaded, "entries of loaded index") && success;
+
+	// a rewrite with the same size, the times are set because a fast
+	// rewrite can have the same time stamp
+	replaceInFile(filename, "800", "640");
+	setModificationTime(filename, modificationTime + 2, 0);
+	success = printCheck(!loaded.isUpToDate(), "changed file with the same size") && success;
+	// a rewrite within the same second
+	bool rebuiltIndex = index.build(filename, errMsg) && index.isUpToDate();
+	replaceInFile(filename, "640", "800");
+	if (setModificationTime(filename, modificationTime + 2, 500000000)) {
+		success = printCheck(rebuiltIndex && !index.isUpToDate(),
+				"changed file within the same second") && success;
+	}
+	else {
+		std::cout << "changed file within the same second skipped (no sub second time stamps)" << std::endl;
+	}
+
+	// a parse error inside the block (only the lines with a deep of 0 and 1
+	// are parsed by build()) has the line number of the file
+	{
+		std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		ofs << "a = 1\n"
+				"b\n"
+				"\tc\n"
+				"\t\td = \"not closed\n";
+	}
+	cfg::TmlParser parser;
+	cfg::NameValuePair entry;
+	bool changed = !parser.getIndexedEntry(index, 0, entry) && !index.isUpToDate();
+	success = printCheck(changed, "changed file") && success;
+	bool rebuilt = index.build(filename, errMsg) && index.find("b") == 1;
+	bool error = rebuilt && !parser.getIndexedEntry(index, 1, entry) &&
+			parser.getLineNumber() == 4;
+	success = printCheck(error, "error line number: " + parser.getExtendedErrorMsg()) && success;
+
+	std::remove(filename.c_str());
+	std::remove(indexFilename.c_str());
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// feed chunks of chunkSize bytes, the result must be the same as of getAsTree()
+static bool checkTmlFeed(const std::string& tml, std::size_t chunkSize,
+		bool inclComments, const std::string& text)
+{
+	cfg::TmlParser treeParser;
+	treeParser.setStringBuffer("feed.tml", tml);
+	cfg::Value root;
+	bool treeSuccess = treeParser.getAsTree(root, inclComments, inclComments);
+
+	cfg::TmlParser parser;
+	parser.beginFeed("feed.tml", inclComments, inclComments);
+	cfg::Value fed;
+	bool success = true;
+	for (std::size_t i = 0; success && i < tml.size(); i += chunkSize) {
+		success = parser.feed(tml.data() + i, std::min(chunkSize, tml.size() - i));
+	}
+	success = success && parser.finish(fed);
+	bool ok = false;
+	if (treeSuccess) {
+		ok = success && cfg::cfgstring::valueToString(0, fed) ==
+				cfg::cfgstring::valueToString(0, root);
+	}
+	else {
+		ok = !success && parser.getExtendedErrorMsg() == treeParser.getExtendedErrorMsg();
+	}
+	return printCheck(ok, text + " (chunk size " + std::to_string(chunkSize) + ")");
+}
+
+static bool checkJsonFeed(const std::string& json, std::size_t chunkSize,
+		const std::string& text)
+{
+	cfg::JsonParser treeParser;
+	treeParser.setStringBuffer("feed.json", json);
+	cfg::Value root;
+	bool treeSuccess = treeParser.getAsTree(root);
+
+	cfg::JsonParser parser;
+	parser.beginFeed("feed.json");
+	cfg::Value fed;
+	bool success = true;
+	for (std::size_t i = 0; success && i < json.size(); i += chunkSize) {
+		success = parser.feed(json.data() + i, std::min(chunkSize, json.size() - i));
+	}
+	success = success && parser.finish(fed);
+	bool ok = false;
+	if (treeSuccess) {
+		ok = success && cfg::cfgstring::valueToString(0, fed) ==
+				cfg::cfgstring::valueToString(0, root);
+	}
+	else {
+		ok = !success && parser.getLineNumber() == treeParser.getLineNumber();
+	}
+	return printCheck(ok, text + " (chunk size " + std::to_string(chunkSize) + ")");
+}
+
+static int testFeed()
+{
+	bool success = true;
+	std::cout << "*** test feed ***" << std::endl;
+	const std::string tml =
+			"# leading comment\n"
+			"\n"
+			"entity\n"
+			"\t# comment of the entity\n"
+			"\tname = \"first entity\"\n"
+			"\tpos = 1 2 3\n"
+			"\t\t# trailing comment of the entity\n"
+			"entity\n"
+			"\tchildren\n"
+			"\t\tchild = 1\n"
+			"\n"
+			"list = []\n"
+			"\t1\n"
+			"\t2\n"
+			"count = 2";
+	std::string deepTml;
+	createDeepTml(deepTml, 10, 3);
+	const std::size_t chunkSizes[] = {1, 3, 16, 1000};
+	for (std::size_t chunkSize : chunkSizes) {
+		success = checkTmlFeed(tml, chunkSize, false, "tml") && success;
+		success = checkTmlFeed(tml, chunkSize, true, "tml with comments") && success;
+		success = checkTmlFeed(deepTml, chunkSize, true, "deep tml") && success;
+		success = checkTmlFeed("a\n\tb = 1\nc\n\t\t\td = 2\n", chunkSize, false,
+				"tml error") && success;
+	}
+	success = checkTmlFeed("", 1, true, "empty tml") && success;
+
+	const std::string json =
+			"{\n"
+			"  \"name\": \"a, b and {c}\",\n"
+			"  \"escaped\": \"quote \\\" and ]\",\n"
+			"  \"list\": [1, 2.5, [true, null], {\"x\": -3}],\n"
+			"  \"object\": {\"a\": {\"b\": [\"c\"]}},\n"
+			"  \"empty\": {}\n"
+			"}\n";
+	for (std::size_t chunkSize : chunkSizes) {
+		success = checkJsonFeed(json, chunkSize, "json") && success;
+		success = checkJsonFeed("[1, \"[\", {\"a\": 2}, []]", chunkSize, "json array") && success;
+		success = checkJsonFeed("{\"a\": 1,\n\"b\": [1,\n2 3]}", chunkSize, "json error") && success;
+	}
+	success = checkJsonFeed(" \"text\" ", 2, "json text") && success;
+	success = checkJsonFeed("{\"a\": 1} x", 1, "json text after the root") && success;
+	success = checkJsonFeed("{\"a\": 1}}", 1, "json bracket after the root") && success;
+	success = checkJsonFeed("[1]\n]", 3, "json bracket after the root array") && success;
+	success = checkJsonFeed("{\"a\": 1}\n\n ", 1, "json white spaces after the root") &&
+			success;
+	success = checkJsonFeed("{}", 1, "empty json object") && success;
+
+	cfg::JsonParser parser;
+	parser.setProjection({"list"});
+	parser.beginFeed("feed.json");
+	cfg::Value projected;
+	bool fed = parser.feed(json.data(), json.size()) && parser.finish(projected);
+	success = printCheck(fed && projected.mObject.size() == 1 &&
+			projected.objectGetValue("list") != nullptr, "json projection") && success;
+
+	cfg::JsonParser shortParser;
+	shortParser.beginFeed("feed.json");
+	cfg::Value incomplete;
+	bool tooShort = shortParser.feed(json.data(), json.size() / 2) &&
+			!shortParser.finish(incomplete);
+	success = printCheck(tooShort, "incomplete json: " + shortParser.getExtendedErrorMsg()) &&
+			success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// a parse error of validateStream() must be the same as of getAsTree()
+static bool checkTmlValidateStream(cfg::SchemaValidator& validator, const std::string& tml,
+		const std::string& text)
+{
+	cfg::TmlParser treeParser;
+	treeParser.setStringBuffer("validate.tml", tml);
+	cfg::Value root;
+	bool treeSuccess = treeParser.getAsTree(root);
+
+	cfg::TmlParser parser;
+	parser.setStringBuffer("validate.tml", tml);
+	std::string errMsg;
+	bool valid = parser.validateStream(validator, false, errMsg);
+	return printCheck(!treeSuccess && !valid && validator.getViolationCount() == 0 &&
+			errMsg == treeParser.getExtendedErrorMsg(), text + ": " + errMsg);
+}
+
+static bool checkJsonValidateStream(cfg::SchemaValidator& validator, const std::string& json,
+		bool stopAtFirstViolation, bool expectedValid, std::size_t expectedViolationCount,
+		const std::string& text)
+{
+	cfg::JsonParser parser;
+	parser.setStringBuffer("validate.json", json);
+	std::string errMsg;
+	bool valid = parser.validateStream(validator, stopAtFirstViolation, errMsg);
+	return printCheck(valid == expectedValid &&
+			validator.getViolationCount() == expectedViolationCount,
+			text + (errMsg.empty() ? "" : ": " + errMsg));
+}
+
+static int testValidateStream()
+{
+	bool success = true;
+	std::cout << "*** test validate-stream ***" << std::endl;
+	cfg::TmlParser schemaParser;
+	schemaParser.setStringBuffer("validate.schema.tml",
+			"type string : value a = type integer\n"
+			"type string : value b\n"
+			"\ttype string : value c = type integer\n");
+	cfg::Value schemaValue;
+	std::string errMsg;
+	cfg::NVFragmentSchema nvfs;
+	cfg::SchemaValidator validator;
+	if (!schemaParser.getAsTree(schemaValue) ||
+			!cfg::schema::getSchemaFromCfgValue(nvfs, schemaValue, errMsg) ||
+			!validator.compile(nvfs, errMsg)) {
+		return printCheck(false, "compile schema: " + errMsg) ? 0 : 1;
+	}
+
+	success = checkTmlValidateStream(validator, "a = 1\n\tc = 2\n",
+			"tml child of a pair with a value") && success;
+	success = checkTmlValidateStream(validator, "[] = 1\n", "tml array as name") && success;
+	success = checkTmlValidateStream(validator, "b\n\t[] = 1\n",
+			"tml array as name of a child") && success;
+	success = checkTmlValidateStream(validator, "b\n\tc = 1\n\t\td = 2\n",
+			"tml nested child of a pair with a value") && success;
+	success = checkTmlValidateStream(validator, "b\n\tc = [1]\n\t\t2\n",
+			"tml elements of a not empty array") && success;
+
+	// the root object has no name --> the filename is the position
+	cfg::TmlParser missingParser;
+	missingParser.setStringBuffer("validate.tml", "b\n\tc = 1\n");
+	cfg::Value missingRoot;
+	std::string treeErrMsg;
+	bool treeValid = missingParser.getAsTree(missingRoot) &&
+			validator.validate(missingRoot, treeErrMsg);
+	missingParser.setStringBuffer("validate.tml", "b\n\tc = 1\n");
+	std::string streamErrMsg;
+	bool streamValid = missingParser.validateStream(validator, false, streamErrMsg);
+	cfg::JsonParser missingJsonParser;
+	missingJsonParser.setStringBuffer("validate.json", "{\"b\": {\"c\": 1}}");
+	std::string jsonErrMsg;
+	bool jsonValid = missingJsonParser.validateStream(validator, false, jsonErrMsg);
+	success = printCheck(!treeValid && !streamValid && !jsonValid &&
+			treeErrMsg == "validate.tml:1:0: name 'a' is missing\n" &&
+			streamErrMsg == "validate.tml: name 'a' is missing\n" &&
+			jsonErrMsg == "validate.json: name 'a' is missing\n",
+			"missing root member: " + treeErrMsg + streamErrMsg + jsonErrMsg) && success;
+
+	const std::string json = "{\"a\": 1, \"b\": {\"c\": 2}}";
+	success = checkJsonValidateStream(validator, json, false, true, 0, "json valid") && success;
+	const std::string invalidJson = "{\"a\": \"x\", \"b\": {\"c\": \"y\"}}";
+	success = checkJsonValidateStream(validator, invalidJson, false, false, 2,
+			"json violations") && success;
+	success = checkJsonValidateStream(validator, invalidJson, true, false, 1,
+			"json stop at first violation") && success;
+	success = checkJsonValidateStream(validator, "{\"a\": 1,\n\"b\": [}", false, false, 0,
+			"json parse error") && success;
+	success = checkJsonValidateStream(validator, "[1]", false, false, 0,
+			"json root array") && success;
+	success = checkJsonValidateStream(validator, "{\"a\": 1", false, false, 0,
+			"json too short") && success;
+	success = checkJsonValidateStream(validator, "{\"a\": 1} x", false, false, 0,
+			"json text after the root") && success;
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+// return 0 for success, 1 for fail
+static int testAllocations()
+{
+	bool success = true;
+	static_assert(std::is_nothrow_move_constructible<cfg::Value>::value,
+			"Value must be nothrow move constructible");
+	static_assert(std::is_nothrow_move_assignable<cfg::Value>::value,
+			"Value must be nothrow move assignable");
+	static_assert(std::is_nothrow_move_constructible<cfg::NameValuePair>::value,
+			"NameValuePair must be nothrow move constructible");
+	static_assert(std::is_nothrow_move_assignable<cfg::NameValuePair>::value,
+			"NameValuePair must be nothrow move assignable");
+
+	const int deeps[] = {25, 50, 100, 200};
+	for (int deep : deeps) {
+		std::string tml;
+		std::size_t lineCount = createDeepTml(tml, deep, 20);
+		cfg::TmlParser p;
+		p.setStringBuffer("deep.tml", tml);
+		cfg::Value root;
+		std::size_t before = allocationCount.load();
+		bool parsed = p.getAsTree(root);
+		std::size_t count = allocationCount.load() - before;
+		// A copy of the deep children at each level would grow with
+		// O(deep * size). Without copies the allocations per line are
+		// constant (values, texts and the growing vectors).
+		bool ok = parsed && count < 8 * lineCount;
+		success = printCheck(ok, "deep " + std::to_string(deep) + ": " +
+				std::to_string(count) + " allocations for " +
+				std::to_string(lineCount) + " lines") && success;
+	}
+
+	// return 0 for success, 1 for fail
+	return success ? 0 : 1;
+}
+
+static void writeTextFile(const std::string& filename, const std::string& content)
+{
+	std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	ofs << content;
+}
+
+// load a single file (without its includes), rv is the loaded tree as text or
+// the error message
+static bool loadSingleFile(cfg::FileLoader& loader, const std::string& filename,
+		std::string& outText)
+{
+	cfg::Value value;
+	std::string fullFilename;
+	std::string errMsg;
+	if (!loader.loadAndPush(value, fullFilename, filename, false, false, errMsg)) {
+		outText = errMsg;
+		return false;
+	}
+	loader.pop();
+	outText = cfg::cfgstring::valueToString(0, value);
+	return true;
+}
+
+static int testAsyncFileLoader()
+{
+	bool success = true;
+	std::cout << "*** test async-loader ***" << std::endl;
+	const std::string mainFilename = "async-loader-main.tml";
+	const std::string subFilename = "async-loader-sub.tml";
+	const std::string missingFilename = "async-loader-missing.tml";
+	writeTextFile(mainFilename, "include async-loader-sub.tml\n"
+			"include async-loader-sub.tml\n"
+			"b = 2\n");
+	writeTextFile(subFilename, "a = 1\n");
+	auto newParser = []() { return std::unique_ptr<cfg::ValueParser>(new cfg::TmlParser()); };
+
+	std::string expected;
+	cfg::ParserFileLoader syncLoader(newParser());
+	bool loaded = loadSingleFile(syncLoader, subFilename, expected);
+	cfg::AsyncFileLoader loader(newParser());
+
+	// the I/O thread reads the file while the loader waits
+	bool hit = false;
+	for (int i = 0; loaded && !hit && i < 10; ++i) {
+		loader.reset();
+		loader.readAhead(loader.getFullFilename(subFilename));
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		std::string text;
+		hit = loadSingleFile(loader, subFilename, text) && text == expected &&
+				loader.getReadAheadHitCount() == 1;
+	}
+	success = printCheck(hit, "read-ahead hit") && success;
+
+	// the loader takes the request before or while an I/O thread reads it
+	bool taken = loaded;
+	for (int i = 0; taken && i < 20; ++i) {
+		loader.reset();
+		loader.readAhead(loader.getFullFilename(subFilename));
+		std::string text;
+		taken = loadSingleFile(loader, subFilename, text) && text == expected;
+	}
+	success = printCheck(taken, "read without waiting for the I/O thread") && success;
+
+	// a failed read is loaded as usual --> same error message
+	{
+		std::string syncErrMsg;
+		std::string errMsg;
+		loader.reset();
+		loader.readAhead(loader.getFullFilename(missingFilename));
+		bool failed = !loadSingleFile(syncLoader, missingFilename, syncErrMsg) &&
+				!loadSingleFile(loader, missingFilename, errMsg);
+		success = printCheck(failed && !errMsg.empty() && errMsg == syncErrMsg,
+				"failed read: " + errMsg) && success;
+	}
+
+	// reset() drops the requests, the files are read again
+	{
+		loader.reset();
+		for (int i = 0; i < 10; ++i) {
+			loader.readAhead(loader.getFullFilename(subFilename));
+			loader.readAhead(loader.getFullFilename(mainFilename));
+			loader.readAhead(loader.getFullFilename(missingFilename));
+			loader.reset();
+		}
+		std::string text;
+		bool ok = loadSingleFile(loader, subFilename, text) && text == expected &&
+				loader.getReadAheadHitCount() == 0;
+		success = printCheck(ok, "reset while reading") && success;
+	}
+
+	// includes are read ahead, the result is the same as without read-ahead
+	{
+		cfg::Value syncValue;
+		cfg::Value value;
+		cfg::inc::TFileMap syncIncludedFiles;
+		cfg::inc::TFileMap includedFiles;
+		std::string errMsg;
+		loader.reset();
+		bool ok = cfg::inc::loadAndIncludeFiles(syncValue, syncIncludedFiles, mainFilename,
+				syncLoader, "include", true, false, false, false, errMsg) &&
+				cfg::inc::loadAndIncludeFiles(value, includedFiles, mainFilename,
+				loader, "include", true, false, false, false, errMsg) &&
+				cfg::cfgstring::valueToString(0, value) ==
+				cfg::cfgstring::valueToString(0, syncValue) &&
+				loader.getNestedDeep() == 0;
+		success = printCheck(ok, "includes " + errMsg) && success;
+
+		// the includes are read ahead but not loaded, their content isn't
+		// kept after the top-level file --> a changed file is read again
+		std::string text;
+		ok = loadSingleFile(loader, mainFilename, text);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		writeTextFile(subFilename, "a = 3\n");
+		unsigned int hitCount = loader.getReadAheadHitCount();
+		ok = ok && loadSingleFile(loader, subFilename, text) && text != expected &&
+				loader.getReadAheadHitCount() == hitCount;
+		success = printCheck(ok, "not loaded read-ahead dropped") && success;
+	}
+
+	std::remove(mainFilename.c_str());
+	std::remove(subFilename.c_str());
 	// return 0 for success, 1 for fail
 	return success ? 0 : 1;
 }
@@ -1216,6 +3097,54 @@ static int unitTests(const std::string& testName)
 	else if (testName == "creator") {
 		fail = testCreator() || fail;
 	}
+	else if (testName == "select-rules") {
+		fail = testSelectRules() || fail;
+	}
+	else if (testName == "tml-parallel") {
+		fail = testTmlParallel() || fail;
+	}
+	else if (testName == "numbers") {
+		fail = testNumbers() || fail;
+	}
+	else if (testName == "shared-value") {
+		fail = testSharedValue() || fail;
+	}
+	else if (testName == "writers") {
+		fail = testWriters() || fail;
+	}
+	else if (testName == "allocations") {
+		fail = testAllocations() || fail;
+	}
+	else if (testName == "frozen") {
+		fail = testFrozen() || fail;
+	}
+	else if (testName == "accessors") {
+		fail = testAccessors() || fail;
+	}
+	else if (testName == "numeric-arrays") {
+		fail = testNumericArrays() || fail;
+	}
+	else if (testName == "packed-arrays") {
+		fail = testPackedArrays() || fail;
+	}
+	else if (testName == "projection") {
+		fail = testProjection() || fail;
+	}
+	else if (testName == "top-level-entries") {
+		fail = testTopLevelEntries() || fail;
+	}
+	else if (testName == "index") {
+		fail = testIndex() || fail;
+	}
+	else if (testName == "feed") {
+		fail = testFeed() || fail;
+	}
+	else if (testName == "validate-stream") {
+		fail = testValidateStream() || fail;
+	}
+	else if (testName == "async-loader") {
+		fail = testAsyncFileLoader() || fail;
+	}
 	else {
 		fail = 1;
 		std::cout << "'" << testName << "' is not supported" << std::endl;
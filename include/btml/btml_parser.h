@@ -27,8 +27,8 @@ namespace cfg
 		virtual void reset() override;
 		virtual bool setFilename(const std::string& filename) override;
 		// strBuffer must contain the btml binary format!!!
-		bool setStringBuffer(const std::string& pseudoFilename,
-				const std::string& strBuffer);
+		virtual bool setStringBuffer(const std::string& pseudoFilename,
+				const std::string& strBuffer) override;
 		// If this is used then only the pointer is copied!
 		// --> buf must live as long as BtmlParser object!
 		bool setCustomBuffer(const std::string& pseudoFilename,
@@ -2,6 +2,7 @@
 #define CFG_BTML_STREAM_H
 
 #include <cfg/export.h>
+#include <set>
 #include <vector>
 #include <string>
 #include <stdint.h>
@@ -50,6 +51,8 @@
   Value::TYPE_BOOL:  - Type byte. All flags are 0. 1 byte for data (0 = false, 1 = true). --> Total 2 byte
   Value::TYPE_FLOAT: - Type byte. All flags are 0. 4 byte for float data. --> Total 5 byte
   Value::TYPE_INT:   - Type byte. All flags are 0. 4 byte for int data (little endian). --> Total 5 byte
+  Value::TYPE_INT64: - Type byte. All flags are 0. 8 byte for int64 data (little endian). --> Total 9 byte
+  Value::TYPE_DOUBLE: - Type byte. All flags are 0. 8 byte for double data. --> Total 9 byte
   Value::TYPE_TEXT / Value::TYPE_COMMENT:
     Type byte: Bits 3 - 0 stores TYPE_TEXT or TYPE_COMMENT.
                Bits 7 - 4 stores the flags. All 0 for TYPE_COMMENT.
@@ -63,9 +66,16 @@
     String-data: Data of string incl 0 termination. No data if it is a string reference.
                In this case the data are loaded from the string lookup table.
   Value::TYPE_ARRAY:
-    Type byte: All flags are 0. Stores type TYPE_ARRAY.
-    Data: 1 or 5 bytes for array element count (element count and NOT size in bytes!)
+    Type byte: Bits 3 - 0 stores TYPE_ARRAY.
+               Flag 5: stores if the array is a packed array (see Value::mPackedArray).
+    Data (flag 5 is 0):
+          1 or 5 bytes for array element count (element count and NOT size in bytes!)
           btml encoded values for array elements.
+    Data (flag 5 is 1):
+          1 byte for the element type (TYPE_INT, TYPE_FLOAT or TYPE_DOUBLE).
+          1 or 5 bytes for array element count (element count and NOT size in bytes!)
+          Element data without type bytes. 4 bytes (TYPE_INT, TYPE_FLOAT) or
+          8 bytes (TYPE_DOUBLE) per element (little endian).
   Value::TYPE_OBJECT:
     Type byte: All flags are 0. Stores type TYPE_ARRAY.
     Data: 1 or 5 bytes for object's name-value pair count (pair count and NOT size in bytes!)
@@ -78,6 +88,7 @@ namespace cfg
 {
 	class Value;
 	class NameValuePair;
+	class SchemaValidator;
 
 	namespace btmlstream
 	{
@@ -92,10 +103,15 @@ namespace cfg
 		unsigned int valueToStreamWithHeader(const Value& cfgValue,
 				std::vector<uint8_t>& s, bool useStringTable);
 
-		// return count of used bytes, 0 for error
+		/**
+		 * packNumericArrays: the arrays with only numbers of one type
+		 * are packed while they are read (see
+		 * ValueParser::setPackNumericArrays()).
+		 * @return count of used bytes, 0 for error
+		 */
 		CFG_API
 		unsigned int streamToValue(const void* stream, unsigned int n,
-				Value& cfgValue, std::string* errMsg);
+				Value& cfgValue, std::string* errMsg, bool packNumericArrays = false);
 
 		// return count of used bytes, 0 for error
 		CFG_API
@@ -103,7 +119,7 @@ namespace cfg
 				Value& cfgValue, std::string* errMsg,
 				bool& stringTableExist,
 				unsigned int& stringTableEntryCount,
-				unsigned int& stringTableSize);
+				unsigned int& stringTableSize, bool packNumericArrays = false);
 
 		// return count of used bytes, 0 for error
 		CFG_API
@@ -116,7 +132,35 @@ namespace cfg
 				Value& cfgValue, std::string* errMsg,
 				bool& headerExist, bool& stringTableExist,
 				unsigned int& stringTableEntryCount,
-				unsigned int& stringTableSize);
+				unsigned int& stringTableSize, bool packNumericArrays = false);
+
+		/**
+		 * Same as streamToValueWithOptionalHeader() but only the top level
+		 * pairs with a name of projection are converted. The other values
+		 * are skipped by their stored counts and sizes without creating
+		 * them. The root value must be an object.
+		 * @return count of used bytes, 0 for error
+		 */
+		CFG_API
+		unsigned int streamToProjectedValueWithOptionalHeader(const void* stream,
+				unsigned int n, Value& cfgValue,
+				const std::set<std::string>& projection,
+				std::string* errMsg = nullptr, bool packNumericArrays = false);
+
+		/**
+		 * Validate the stream with the (compiled) validator without building
+		 * the full tree. The root value must be an object. Its members
+		 * are passed one by one to the validator.
+		 * @param stopAtFirstViolation If true then validation is stopped
+		 *        at the first member which causes a violation.
+		 * @param outErrorMsg Contains the violations or the error message.
+		 * @return count of used bytes, 0 for error or a violation.
+		 *         For a violation validator.getViolationCount() is > 0.
+		 */
+		CFG_API
+		unsigned int streamToValidatorWithOptionalHeader(const void* stream,
+				unsigned int n, SchemaValidator& validator,
+				bool stopAtFirstViolation, std::string& outErrorMsg);
 	}
 }
 
@@ -22,6 +22,9 @@ namespace cfg
 				bool inclEmptyLines, bool inclComments) override;
 		// return filename with linenumber and error message
 		virtual std::string getExtendedErrorMsg() const override;
+		// also set for the internal parsers
+		virtual void setPackNumericArrays(bool enable) override;
+		virtual void setProjection(const std::vector<std::string>& topLevelNames) override;
 	protected:
 		// 0 for none, 1 for tml parser, 2 for btml parser
 		static int getParserSelectionForFilename(const std::string& filename,
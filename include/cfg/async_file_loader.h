@@ -0,0 +1,112 @@
+#ifndef CFG_ASYNC_FILE_LOADER_H
+#define CFG_ASYNC_FILE_LOADER_H
+
+#include <cfg/parser_file_loader.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cfg
+{
+	/**
+	 * A ParserFileLoader which reads included files ahead.
+	 *
+	 * After a file is loaded by loadAndPush() all include statements of
+	 * the file are searched (e.g. "include sub.tml") and the content of
+	 * the included files is read by background I/O threads. When the
+	 * include is processed by loadAndPush() the content is parsed from
+	 * memory (see ValueParser::setStringBuffer()). Therefore parsing
+	 * overlaps with the file reads, and reads of different files can
+	 * overlap each other (which helps with a high latency, e.g. network
+	 * mounted volumes).
+	 *
+	 * If the read-ahead of a file hasn't started yet, or failed, or the
+	 * parser doesn't support a string buffer then the file is loaded
+	 * the same way as ParserFileLoader loads it (same error messages).
+	 *
+	 * The loader itself must be used by one thread (like ParserFileLoader).
+	 */
+	class CFG_API AsyncFileLoader: public ParserFileLoader
+	{
+	public:
+		/**
+		 * @param includeKeyword Same keyword as used for
+		 *        cfg::inc::includeFiles(). Only these include statements
+		 *        are read ahead.
+		 * @param ioThreadCount Count of background threads for reading
+		 *        files. At least one thread is used.
+		 */
+		AsyncFileLoader(std::unique_ptr<ValueParser> parser,
+				const std::string& includeKeyword = "include",
+				unsigned int ioThreadCount = 2);
+		virtual ~AsyncFileLoader();
+		virtual void reset() override;
+		virtual bool loadAndPush(Value& outValue, std::string& outFullFilename,
+				const std::string& includeFilename,
+				bool inclEmptyLines, bool inclComments,
+				std::string& outErrorMsg) override;
+		/**
+		 * After the top-level file is popped, read-ahead content which
+		 * wasn't loaded (e.g. an include processed only once, or includes
+		 * behind an error) is dropped.
+		 */
+		virtual bool pop() override;
+
+		/**
+		 * Start reading the file in the background.
+		 * Is called by loadAndPush() for each include statement.
+		 */
+		void readAhead(const std::string& fullFilename);
+
+		// count of files which were parsed from read-ahead content
+		unsigned int getReadAheadHitCount() const { return mReadAheadHitCount; }
+	protected:
+		virtual bool parseFile(Value& outValue, const std::string& fullFilename,
+				bool inclEmptyLines, bool inclComments,
+				std::string& outErrorMsg) override;
+	private:
+		enum class EReadState
+		{
+			QUEUED,
+			READING,
+			DONE,
+			// taken by the loader before an I/O thread has started reading
+			TAKEN,
+		};
+
+		struct ReadRequest
+		{
+			std::string mFullFilename;
+			EReadState mState = EReadState::QUEUED;
+			bool mSuccess = false;
+			std::string mContent;
+		};
+		typedef std::shared_ptr<ReadRequest> ReadRequestPtr;
+
+		std::string mIncludeKeyword;
+		unsigned int mIoThreadCount;
+		std::vector<std::thread> mIoThreads;
+
+		// protects all members below
+		std::mutex mMutex;
+		// signals new requests (for I/O threads)
+		std::condition_variable mQueueCondition;
+		// signals finished reads (for the loader)
+		std::condition_variable mDoneCondition;
+		std::deque<ReadRequestPtr> mQueue;
+		std::map<std::string, ReadRequestPtr> mRequests;
+		bool mStopThreads = false;
+
+		unsigned int mReadAheadHitCount = 0;
+
+		void readAheadIncludes(const Value& value);
+		void ioThreadLoop();
+	};
+}
+
+#endif
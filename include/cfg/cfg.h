@@ -3,6 +3,10 @@
 
 #include <cfg/export.h>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
 #include <fstream>
 #include <memory>
@@ -15,7 +19,10 @@
 namespace cfg
 {
 	class NameValuePair;
+	class ObjectPairRange;
+	class PackedArray;
 	class SelectRule;
+	class CompiledSelectRules;
 
 	enum class EReset
 	{
@@ -30,7 +37,8 @@ namespace cfg
 	public:
 		// if changes at EValueType is necessary don't forget do update
 		// the function getValueTypeAsString() at cfg_enum_string.h
-		enum EValueType
+		// uint8_t to keep sizeof(Value) small (cast it to int for streams)
+		enum EValueType : uint8_t
 		{
 			TYPE_NONE  = 0, // none, nothing, empty (empty line)
 			TYPE_NULL,
@@ -41,6 +49,10 @@ namespace cfg
 			TYPE_COMMENT, // use mText, e.g. # comment text
 			TYPE_ARRAY,
 			TYPE_OBJECT,
+			// added after TYPE_OBJECT to keep the values of the other
+			// types (e.g. used by btml)
+			TYPE_INT64, // integer which doesn't fit into int
+			TYPE_DOUBLE, // floating point with more precision than float
 		};
 
 		// use a shared_ptr instead of direct a std::string to only have one string instance per file
@@ -69,8 +81,20 @@ namespace cfg
 		 * if mType is TYPE_BOOL then mBool stores the value. mFloatingPoint
 		 * and mInteger would be also 1.0 and 1 for true or 0.0 and 0 for false.
 		 *
-		 * if mType is TYPE_BOOL, TYPE_FLOAT or TYPE_INT then mText is always
-		 * empty (--> "").
+		 * if mType is TYPE_INT64 then the integer value is stored at
+		 * mInteger64. mInteger is the value clamped to the range of int,
+		 * mFloatingPoint and mBool are set as for TYPE_INT.
+		 *
+		 * if mType is TYPE_DOUBLE then the value is stored at mDouble.
+		 * mFloatingPoint is the value as float (less precision), mInteger
+		 * and mBool are set as for TYPE_FLOAT.
+		 *
+		 * mInteger64 and mDouble share their memory (see below). For all
+		 * number types getInteger64() and getDouble() return the value
+		 * without loss.
+		 *
+		 * if mType is TYPE_BOOL, TYPE_FLOAT, TYPE_INT, TYPE_INT64 or
+		 * TYPE_DOUBLE then mText is always empty (--> "").
 		 */
 		EValueType mType;
 
@@ -78,10 +102,12 @@ namespace cfg
 		 * only for additional informations for TYPE_INT. if mType is
 		 * TYPE_INT then mParseBase give infos if it was a dec, octal or
 		 * hex string to parse.
-		 * if mType is TYPE_FLOAT then mParseBase is always 10.
+		 * if mType is TYPE_INT64 then mParseBase is the same as for TYPE_INT.
+		 * if mType is TYPE_FLOAT or TYPE_DOUBLE then mParseBase is always 10.
 		 * if mType is TYPE_BOOL then mParseBase is always 2.
+		 * uint8_t to keep sizeof(Value) small (cast it to int for streams).
 		 */
-		unsigned int mParseBase;
+		uint8_t mParseBase;
 		/**
 		 * only for additional informations for TYPE_TEXT. if mType is
 		 * TYPE_TEXT then mParseTextWithQuotes give infos if the text parsed
@@ -98,6 +124,36 @@ namespace cfg
 		bool mBool;
 		float mFloatingPoint;
 		int mInteger;
+		/**
+		 * Only one member of 64 bit is stored (mType selects it). Other
+		 * types don't use them. Therefore they don't make each Value
+		 * (e.g. texts, objects, comments) greater.
+		 */
+		union
+		{
+			// only for TYPE_INT64
+			int64_t mInteger64;
+			// only for TYPE_DOUBLE
+			double mDouble;
+			/**
+			 * only for TYPE_ARRAY: Optional packed storage of numbers of
+			 * one type (see packArray()). If it is set then mArray is
+			 * empty and the elements are stored here. The packed array
+			 * isn't changed after it is set --> copies of the Value share
+			 * it (the Value owns a reference, never assign it directly,
+			 * see setPackedArray()). Read it with getPackedArray().
+			 * Functions which use mArray directly don't see the elements.
+			 * Use arraySize(), arrayGetElementType() and arrayGetFloats()
+			 * ... or unpackArray() before if necessary. Supported are the
+			 * serializers (tmlstring, jsonstring, cfgstring, btmlstream),
+			 * SharedValue, FrozenDocument and the schema validation.
+			 * objectGet() fails for a SelectRule with an array pointer
+			 * (use a rule for the Value). The includes, templates,
+			 * translations and the interpreter only handle texts and
+			 * therefore skip them.
+			 */
+			const PackedArray* mPackedArray;
+		};
 		std::string mText;
 		std::vector<Value> mArray;
 		std::vector<NameValuePair> mObject;
@@ -121,11 +177,20 @@ namespace cfg
 		explicit Value(const std::vector<NameValuePair>& object,
 				int lineNumber = -1, int offset = -1, int nvpDeep = -1,
 				const std::shared_ptr<const std::string>& filename = nullptr);
-		Value(Value&& other);
-		Value& operator=(Value&& other);
-		Value(const Value& other) = default;
-		Value& operator=(const Value& other) = default;
-		//~Value(); // default destructor is enougth
+		// noexcept --> std::vector moves the children instead of copying them
+		// on reallocation.
+		Value(Value&& other) noexcept;
+		Value& operator=(Value&& other) noexcept;
+		Value(const Value& other);
+		Value& operator=(const Value& other);
+		// releases the reference of mPackedArray
+		~Value();
+		/**
+		 * Copy all members of other except the children. mArray and
+		 * mObject are not changed. The copy constructor uses it too,
+		 * therefore it's the only list of the copied members.
+		 */
+		void copyWithoutChildren(const Value& other);
 
 		// return line number and offset as :<line-number>:<offset>
 		// If only a line number is set then :<line-number> is returned.
@@ -139,17 +204,23 @@ namespace cfg
 		void setBool(bool value);
 		void setFloatingPoint(float value);
 		void setInteger(int value, unsigned int parseBase = 10);
+		void setInteger64(int64_t value, unsigned int parseBase = 10);
+		void setDouble(double value);
 		void setText(const std::string& text, bool parseTextWithQuotes = false);
+		void setText(std::string&& text, bool parseTextWithQuotes = false);
 		// set text from textBegin (incl.) to textEndExclusive (excl.).
 		// This version has the advantage that at the position textEndExclusive
 		// can be any character. Can be but need not to be a null termination.
 		void setTextEx(const char* textBegin, const char* textEndExclusive, bool parseTextWithQuotes = false);
 		void setComment(const std::string& text);
+		void setComment(std::string&& text);
 		// set text from textBegin (incl.) to textEndExclusive (excl.).
 		// This version has the advantage that at the position textEndExclusive
 		// can be any character. Can be but need not to be a null termination.
 		void setCommentEx(const char* textBegin, const char* textEndExclusive);
 		void setArray();
+		// array with packed elements (see mPackedArray), the Value takes the ownership
+		void setPackedArray(std::unique_ptr<const PackedArray> packedArray);
 		void setObject();
 		bool equalText(const std::string& text) const;
 
@@ -159,8 +230,20 @@ namespace cfg
 		bool isBool() const { return mType == TYPE_BOOL; }
 		bool isFloat() const { return mType == TYPE_FLOAT; }
 		bool isInteger() const { return mType == TYPE_INT; }
-		bool isNumber() const { return isInteger() || isFloat(); }
+		bool isInteger64() const { return mType == TYPE_INT64; }
+		bool isDouble() const { return mType == TYPE_DOUBLE; }
+		bool isNumber() const { return isInteger() || isFloat() ||
+				isInteger64() || isDouble(); }
 		bool isText() const { return mType == TYPE_TEXT; }
+		/**
+		 * The number of TYPE_BOOL, TYPE_INT, TYPE_INT64, TYPE_FLOAT and
+		 * TYPE_DOUBLE (0 for the other types). getInteger64() rounds a
+		 * floating point (same as mInteger) and clamps it to the range
+		 * of int64_t. getDouble() is exact except for an int64 which has
+		 * more than 53 significant bits.
+		 */
+		int64_t getInteger64() const;
+		double getDouble() const;
 		/**
 		 * Check if it is a "simple" value.
 		 * A simple value is != a primitive value.
@@ -171,13 +254,9 @@ namespace cfg
 		 * @return Return true if it is simple.
 		 */
 		bool isSimple() const { return mType == TYPE_NULL ||
-					mType == TYPE_BOOL || mType == TYPE_FLOAT ||
-					mType == TYPE_INT || mType == TYPE_TEXT; }
+					mType == TYPE_BOOL || isNumber() || mType == TYPE_TEXT; }
 		bool isArray() const { return mType == TYPE_ARRAY; }
-		bool isNoObject() const { return mType == TYPE_NONE || mType == TYPE_NULL ||
-				mType == TYPE_BOOL || mType == TYPE_FLOAT ||
-				mType == TYPE_INT || mType == TYPE_TEXT ||
-				mType == TYPE_COMMENT || mType == TYPE_ARRAY; }
+		bool isNoObject() const { return mType != TYPE_OBJECT; }
 		bool isObject() const { return mType == TYPE_OBJECT; }
 
 		/**
@@ -189,6 +268,52 @@ namespace cfg
 		 *         or all elements of the array are simple.
 		 */
 		bool isComplexArray() const;
+		bool isPackedArray() const { return mType == TYPE_ARRAY && mPackedArray; }
+		// mPackedArray or nullptr if it is no packed array
+		const PackedArray* getPackedArray() const { return isPackedArray() ? mPackedArray : nullptr; }
+		// element count of an array (also for packed arrays)
+		std::size_t arraySize() const;
+		/**
+		 * Store the elements of an array in mPackedArray if all elements
+		 * are TYPE_INT, all are TYPE_FLOAT or all are TYPE_DOUBLE. The
+		 * positions (line number, ...) of the elements are lost.
+		 * @return Return true if the array is packed (also if it was
+		 *         already packed).
+		 */
+		bool packArray();
+		// move the elements of a packed array back to mArray
+		void unpackArray();
+
+		/**
+		 * Type of all elements of an array.
+		 * @return Return TYPE_NONE if it is no array, the array is empty
+		 *         or the elements have different types.
+		 */
+		EValueType arrayGetElementType() const;
+		/**
+		 * Copy all numbers of an array into a buffer of the caller.
+		 * Nothing is copied if it is no array, the array has more than
+		 * maxCount elements or at least one element has a not allowed
+		 * type. The allowed types are the same as for objectGetFloat()
+		 * (TYPE_FLOAT and TYPE_DOUBLE and with allowInteger also TYPE_INT
+		 * and TYPE_INT64) and objectGetInteger() (only TYPE_INT).
+		 * arrayGetInteger64s() allows TYPE_INT and TYPE_INT64.
+		 * @param outCount Count of copied elements (size of the array).
+		 * @return Return true if all elements are copied.
+		 */
+		bool arrayGetFloats(float* outValues, std::size_t maxCount,
+				bool allowInteger, std::size_t& outCount) const;
+		bool arrayGetDoubles(double* outValues, std::size_t maxCount,
+				bool allowInteger, std::size_t& outCount) const;
+		bool arrayGetIntegers(int* outValues, std::size_t maxCount,
+				std::size_t& outCount) const;
+		bool arrayGetInteger64s(int64_t* outValues, std::size_t maxCount,
+				std::size_t& outCount) const;
+		// same as above but resize the vector to the size of the array
+		bool arrayGetFloats(std::vector<float>& outValues, bool allowInteger) const;
+		bool arrayGetDoubles(std::vector<double>& outValues, bool allowInteger) const;
+		bool arrayGetIntegers(std::vector<int>& outValues) const;
+		bool arrayGetInteger64s(std::vector<int64_t>& outValues) const;
 
 		bool attributeExist(const std::string& attrName,
 				bool recursive, bool searchInclObjects, bool searchInclArrays) const;
@@ -226,12 +351,46 @@ namespace cfg
 				const std::string &attrName) const;
 		std::vector<int> objectGetIntegers(const std::string &attrName) const;
 		int objectGetAttrIndex(const std::string &attrName) const;
+
+		/**
+		 * Same as the functions above but without allocations. The name
+		 * is a 0-terminated text (e.g. a literal) which doesn't create a
+		 * temporary std::string. objectGetTextPtr() returns a pointer to
+		 * the stored text instead of a copy (nullptr if not exist or no
+		 * text).
+		 */
+		const NameValuePair* objectGetValuePair(const char* attrName) const;
+		const Value* objectGetValue(const char* attrName) const;
+		const std::string* objectGetTextPtr(const char* attrName) const;
+		const std::string* objectGetTextPtr(const std::string &attrName) const;
+		bool objectGetText(const char* attrName, std::string &attrValue) const;
+		bool objectGetInteger(const char* attrName, int &attrValue) const;
+		int objectGetInteger(const char* attrName) const;
+		bool objectGetFloat(const char* attrName, bool allowInteger, float &attrValue) const;
+		float objectGetFloat(const char* attrName, bool allowInteger) const;
+		bool objectGetBool(const char* attrName, bool &attrValue) const;
+		bool objectGetBool(const char* attrName) const;
+		int objectGetAttrIndex(const char* attrName) const;
+		/**
+		 * All pairs of the object with this name as lazy filtered range
+		 * (the same pairs as objectGetValuePairs() but without creating
+		 * a vector). The name must exist as long as the range is used.
+		 *
+		 * e.g.
+		 *   for (const NameValuePair& nvp : value.objectGetPairRange("point")) {
+		 *       ...
+		 *   }
+		 */
+		ObjectPairRange objectGetPairRange(const char* attrName) const;
+		ObjectPairRange objectGetPairRange(const std::string &attrName) const;
 		/**
 		 * objectGet() is to check and get various name value pairs of the object
 		 * by a rule-based schema.
 		 *
-		 * @param rules The size limit is 64 without the termination rule
-		 *              (64 rules + 1 termination rule)
+		 * @param rules Array of rules which is terminated by a rule with
+		 *              the type SelectRule::TYPE_UNKNOWN (e.g. SelectRule("")).
+		 *              If the same rules are used often then
+		 *              CompiledSelectRules should be used instead.
 		 * @param allowRandomSequence If true then the name-value pairs don't
 		 *        need the same order as the select rules. If false then
 		 *        the name-value pair must have the same order as the select rules.
@@ -290,6 +449,27 @@ namespace cfg
 				EReset reset = EReset::RESET_POINTERS_TO_NULL,
 				std::string* errMsg = nullptr,
 				std::string* warnings = nullptr) const;
+		/**
+		 * Same as objectGet() above but with compiled rules. The rules
+		 * are not counted, and a name is looked up by hash and not by
+		 * comparing it with each rule name.
+		 */
+		int objectGet(const CompiledSelectRules& rules, bool allowRandomSequence,
+				bool allowUnusedValuePairs, bool allowEarlyReturn,
+				bool allowDuplicatedNames,
+				bool allowDuplicatedRuleNamesWithDiffTypes,
+				std::size_t startIndex,
+				std::size_t *outNextIndex,
+				EReset reset = EReset::RESET_POINTERS_TO_NULL,
+				std::string* errMsg = nullptr,
+				std::string* warnings = nullptr) const;
+	private:
+		// copy mInteger64, mDouble or mPackedArray (a reference more) of other
+		void copyUnionMember(const Value& other);
+		// move mInteger64, mDouble or mPackedArray of other (other keeps 0)
+		void moveUnionMember(Value& other);
+		// release the reference of mPackedArray (if it is a packed array)
+		void releasePackedArray();
 	};
 
 	Value none(int lineNumber = -1, int offset = -1, int nvpDeep = -1,
@@ -305,6 +485,12 @@ namespace cfg
 	Value intValue(int integerValue, unsigned int parseBase = 10,
 			int lineNumber = -1, int offset = -1, int nvpDeep = -1,
 			const std::shared_ptr<const std::string>& filename = nullptr);
+	Value int64Value(int64_t integerValue, unsigned int parseBase = 10,
+			int lineNumber = -1, int offset = -1, int nvpDeep = -1,
+			const std::shared_ptr<const std::string>& filename = nullptr);
+	Value doubleValue(double doubleValue,
+			int lineNumber = -1, int offset = -1, int nvpDeep = -1,
+			const std::shared_ptr<const std::string>& filename = nullptr);
 	Value text(const std::string& text,
 			int lineNumber = -1, int offset = -1, int nvpDeep = -1,
 			const std::shared_ptr<const std::string>& filename = nullptr);
@@ -337,6 +523,16 @@ namespace cfg
 			EReset reset = EReset::RESET_POINTERS_TO_NULL,
 			std::string* errMsg = nullptr,
 			std::string* warnings = nullptr);
+	int objectGet(const std::vector<NameValuePair>& nvpairsOfObject,
+			const CompiledSelectRules& rules, bool allowRandomSequence,
+			bool allowUnusedValuePairs, bool allowEarlyReturn,
+			bool allowDuplicatedNames,
+			bool allowDuplicatedRuleNamesWithDiffTypes,
+			std::size_t startIndex,
+			std::size_t *outNextIndex,
+			EReset reset = EReset::RESET_POINTERS_TO_NULL,
+			std::string* errMsg = nullptr,
+			std::string* warnings = nullptr);
 
 	/**
 	 * A name value pair has a name and a value. But this name value pair type
@@ -357,8 +553,9 @@ namespace cfg
 
 		NameValuePair();
 		NameValuePair(const Value& name, const Value& value, int deep = -1);
-		NameValuePair(NameValuePair&& other);
-		NameValuePair& operator=(NameValuePair&& other);
+		NameValuePair(Value&& name, Value&& value, int deep = -1);
+		NameValuePair(NameValuePair&& other) noexcept;
+		NameValuePair& operator=(NameValuePair&& other) noexcept;
 		NameValuePair(const NameValuePair& other) = default;
 		NameValuePair& operator=(const NameValuePair& other) = default;
 		//~NameValuePair(); // default destructor is enough
@@ -389,6 +586,109 @@ namespace cfg
 					mValue.isObject() && mValue.mObject.empty(); }
 	};
 
+	/**
+	 * Elements of a packed array (see Value::mPackedArray). Only the
+	 * vector of mElementType is used.
+	 */
+	class CFG_API PackedArray
+	{
+	public:
+		// TYPE_INT, TYPE_FLOAT or TYPE_DOUBLE
+		Value::EValueType mElementType = Value::TYPE_NONE;
+		std::vector<int32_t> mIntegers;
+		std::vector<float> mFloats;
+		std::vector<double> mDoubles;
+
+		std::size_t size() const;
+		// element as Value (same as before packing but without position)
+		void getElement(std::size_t index, Value& outValue) const;
+		/**
+		 * Append the number of element. The first element defines
+		 * mElementType.
+		 * @return false if element is no TYPE_INT, TYPE_FLOAT or
+		 *         TYPE_DOUBLE or if it has another type than the previous
+		 *         elements (nothing is appended).
+		 */
+		bool add(const Value& element);
+	private:
+		friend class Value;
+		// count of Values which share this packed array (see Value::mPackedArray)
+		mutable std::atomic<unsigned int> mRefCount{0};
+	};
+
+	/**
+	 * Builds an array while its elements are parsed. If pack is true then
+	 * the elements are stored in a PackedArray as long as they are numbers
+	 * of one type. Only at the first other element the numbers are moved
+	 * to Value::mArray. Therefore a numeric array never exists as
+	 * std::vector<Value>.
+	 */
+	class CFG_API ArrayBuilder
+	{
+	public:
+		// array is set to an empty array, count is the expected element count
+		ArrayBuilder(Value& array, std::size_t count, bool pack);
+		void add(Value&& element);
+		// set the packed elements (if the array isn't empty)
+		void finish();
+	private:
+		Value& mValue;
+		std::size_t mCount;
+		std::unique_ptr<PackedArray> mPacked;
+	};
+
+	// pack all arrays of value and its children (see Value::packArray())
+	CFG_API void packNumericArrays(Value& value);
+
+	/**
+	 * Range over the pairs of an object which have a text name equal to
+	 * the searched name (see Value::objectGetPairRange()). The pairs are
+	 * filtered while iterating.
+	 */
+	class CFG_API ObjectPairRange
+	{
+	public:
+		class CFG_API const_iterator
+		{
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef NameValuePair value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const NameValuePair* pointer;
+			typedef const NameValuePair& reference;
+
+			const_iterator(const NameValuePair* pos, const NameValuePair* end,
+					const char* name, std::size_t nameLength);
+			reference operator*() const { return *mPos; }
+			pointer operator->() const { return mPos; }
+			const_iterator& operator++();
+			const_iterator operator++(int);
+			bool operator==(const const_iterator& other) const { return mPos == other.mPos; }
+			bool operator!=(const const_iterator& other) const { return mPos != other.mPos; }
+		private:
+			const NameValuePair* mPos;
+			const NameValuePair* mEnd;
+			const char* mName;
+			std::size_t mNameLength;
+
+			// move to the next pair with the name (starts at mPos)
+			void skip();
+		};
+
+		ObjectPairRange(const NameValuePair* begin, const NameValuePair* end,
+				const char* name, std::size_t nameLength)
+				:mBegin(begin), mEnd(end), mName(name), mNameLength(nameLength) {}
+		const_iterator begin() const;
+		const_iterator end() const;
+		bool empty() const { return begin() == end(); }
+		std::size_t size() const;
+	private:
+		const NameValuePair* mBegin;
+		const NameValuePair* mEnd;
+		const char* mName;
+		std::size_t mNameLength;
+	};
+
 	NameValuePair empty(int deep = -1);
 	NameValuePair comment(const std::string& comment, int deep = -1);
 	NameValuePair single(const Value& name, int deep = -1);
@@ -409,6 +709,7 @@ namespace cfg
 			TYPE_DOUBLE,
 			TYPE_INT,
 			TYPE_UINT,
+			TYPE_INT64,
 			TYPE_STRING,
 			TYPE_ARRAY,
 			TYPE_OBJECT,
@@ -424,6 +725,7 @@ namespace cfg
 			double* mDouble;
 			int* mInt;
 			unsigned int* mUInt;
+			int64_t* mInt64;
 			std::string* mStr;
 			const std::vector<Value>** mArray;
 			const std::vector<NameValuePair>** mObject;
@@ -557,6 +859,21 @@ namespace cfg
 				mUsedCount(usedCount)
 				{ mStorePtr.mUInt = uintPtr; }
 
+		SelectRule(const char* name, int64_t* int64Ptr, ERule rule,
+				unsigned int typeFlags = ALLOW_INT, unsigned int* usedCount = nullptr)
+				:mName(name),
+				mType(TYPE_INT64), mRule(rule),
+				mAllowedTypes(typeFlags),
+				mUsedCount(usedCount)
+				{ mStorePtr.mInt64 = int64Ptr; }
+		SelectRule(const std::string& name, int64_t* int64Ptr, ERule rule,
+				unsigned int typeFlags = ALLOW_INT, unsigned int* usedCount = nullptr)
+				:mName(name),
+				mType(TYPE_INT64), mRule(rule),
+				mAllowedTypes(typeFlags),
+				mUsedCount(usedCount)
+				{ mStorePtr.mInt64 = int64Ptr; }
+
 		SelectRule(const char* name, std::string* strPtr, ERule rule,
 				unsigned int typeFlags = ALLOW_TEXT, unsigned int* usedCount = nullptr)
 				:mName(name),
@@ -575,7 +892,8 @@ namespace cfg
 		/**
 		 * Select rule for a value which holds an array. The array of the value
 		 * Value::mArray can be referenced by arrayPtr (after a successful
-		 * objectGet() call).
+		 * objectGet() call). objectGet() fails for a packed array (see
+		 * Value::mPackedArray).
 		 */
 		SelectRule(const char* name, const std::vector<Value>** arrayPtr, ERule rule,
 				unsigned int typeFlags = ALLOW_ARRAY, unsigned int* usedCount = nullptr)
@@ -661,5 +979,80 @@ namespace cfg
 				 mUsedCount(usedCount)
 		{ mStorePtr.mValuePair = valuePairPtr; }
 	};
+
+	/**
+	 * A rule array (see objectGet()) which is prepared once and can be
+	 * used for many objectGet() calls. The count of rules, the count of
+	 * "must exist" rules and a bitset of the "must exist" rules are
+	 * precomputed. The rule names are stored in a hash table. Rules with
+	 * the same name (different types) are stored in order of the rule array.
+	 * There is no limit of the rule count.
+	 *
+	 * The rule array is referenced and not copied. Therefore the rule array
+	 * must exist as long as the compiled rules are used.
+	 * objectGet() doesn't change the compiled rules (the used counts
+	 * are stored on the stack or for more than 64 rules in a temporary
+	 * vector).
+	 *
+	 * e.g.
+	 *   const cfg::SelectRule rules[] = { {"a", &a, ...}, {"b", &b, ...}, {""} };
+	 *   const cfg::CompiledSelectRules compiledRules(rules);
+	 *   for (...) {
+	 *       value.objectGet(compiledRules, ...);
+	 *   }
+	 */
+	class CFG_API CompiledSelectRules
+	{
+	public:
+		CompiledSelectRules();
+		explicit CompiledSelectRules(const SelectRule *rules);
+
+		/**
+		 * @param rules Array of rules which is terminated by a rule with
+		 *        the type SelectRule::TYPE_UNKNOWN. A previous compiled
+		 *        rule array is replaced.
+		 */
+		void compile(const SelectRule *rules);
+
+		const SelectRule* getRules() const { return mRules; }
+		// count of rules without the termination rule
+		std::size_t size() const { return mRulesSize; }
+		unsigned int getMustExistCount() const { return mMustExistCount; }
+
+		/**
+		 * Same search order as used by objectGet(). First the rule at
+		 * curRuleIndex, then the rules after curRuleIndex and if
+		 * allowRandomSequence is true the rules before curRuleIndex.
+		 * @return -1 for not found or not allowed
+		 */
+		int getRuleIndex(const std::string& ruleName, std::size_t curRuleIndex,
+				bool allowRandomSequence) const;
+		/**
+		 * @param usedRuleCounts Array with size() elements.
+		 * @return Index of the first "must exist" rule with a zero
+		 *         used count or -1 if all "must exist" rules are used.
+		 */
+		int getUnusedMustExistIndex(const std::size_t* usedRuleCounts) const;
+
+	private:
+		struct NameEntry
+		{
+			unsigned int mHash;
+			// rule indices are stored at mRuleIndices (ascending)
+			unsigned int mIndexBegin;
+			unsigned int mIndexCount;
+		};
+
+		const SelectRule* mRules;
+		std::size_t mRulesSize;
+		unsigned int mMustExistCount;
+		std::vector<uint64_t> mMustExistBits;
+		std::vector<NameEntry> mNameEntries;
+		std::vector<unsigned int> mRuleIndices;
+		// hash table. Size is mSlotMask + 1 (power of 2).
+		// Each slot contains index + 1 of mNameEntries or 0 for free.
+		std::vector<unsigned int> mNameSlots;
+		unsigned int mSlotMask;
+	};
 }
 #endif
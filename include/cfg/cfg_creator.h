@@ -4,6 +4,7 @@
 #include <cfg/export.h>
 #include <cfg/cfg.h>
 #include <string>
+#include <vector>
 
 namespace cfg
 {
@@ -48,6 +49,13 @@ namespace cfg
 	{
 	public:
 		CfgCreator();
+		// not copyable (the stack points into the own config)
+		CfgCreator(const CfgCreator&) = delete;
+		CfgCreator& operator=(const CfgCreator&) = delete;
+		// movable with the open containers, other starts again with an
+		// empty root object (same as after takeCfg())
+		CfgCreator(CfgCreator&& other);
+		CfgCreator& operator=(CfgCreator&& other);
 
 		CfgCreator& configParseTextWithQuotes(bool enable);
 		CfgCreator& configParseTextWithQuotesForName(bool enable);
@@ -55,33 +63,42 @@ namespace cfg
 
 		// for empty line
 		CfgCreator& empty();
-		CfgCreator& comment(const std::string& comment, bool withSpace = true);
+		CfgCreator& comment(std::string comment, bool withSpace = true);
 
-		CfgCreator& pushObject(const std::string& name);
+		CfgCreator& pushObject(std::string name);
 		CfgCreator& popObject();
 
-		CfgCreator& pushArray(const std::string& name);
+		CfgCreator& pushArray(std::string name);
 		CfgCreator& popArray();
 
+		// The texts are taken by value. Therefore a temporary or a
+		// std::move()'d string is moved into the config (no copy).
 		// nvp ... name value pair
-		CfgCreator& nvpNull(const std::string& name);
-		CfgCreator& nvpBool(const std::string& name, bool value);
-		CfgCreator& nvpFloat(const std::string& name, float value);
-		CfgCreator& nvpInt(const std::string& name, int value);
-		CfgCreator& nvpText(const std::string& name, const std::string& value);
+		CfgCreator& nvpNull(std::string name);
+		CfgCreator& nvpBool(std::string name, bool value);
+		CfgCreator& nvpFloat(std::string name, float value);
+		CfgCreator& nvpInt(std::string name, int value);
+		CfgCreator& nvpText(std::string name, std::string value);
 
 		// val ... value
 		CfgCreator& valNull();
 		CfgCreator& valBool(bool value);
 		CfgCreator& valFloat(float value);
 		CfgCreator& valInt(int value);
-		CfgCreator& valText(const std::string& value);
+		CfgCreator& valText(std::string value);
 
 		// assign can be used to create name value pairs where the name has a non text type.
 		// e.g. valInt(10).assign().valInt(7)
 		CfgCreator& assign();
 
+		// copy of the created config
 		Value getCfg() const;
+		/**
+		 * Move the created config out of the creator (no copy). After
+		 * the call the creator starts again with an empty root object
+		 * (the config...() settings and the warnings are kept).
+		 */
+		Value takeCfg();
 		bool warningsExist() const { return !mWarnings.empty(); }
 		std::string getWarningsAsString() const;
 	private:
@@ -89,13 +106,24 @@ namespace cfg
 		bool isParseTextWithQuotesForValue = false;
 
 		Value mCfg;
-		unsigned int mDeep = 0;
+		/**
+		 * The open containers (objects and arrays). The first entry is
+		 * mCfg, the last entry is the current container. Only the current
+		 * container is changed. Therefore the pointers to the parents stay
+		 * valid (a parent's last child is the next entry of the stack).
+		 */
+		std::vector<Value*> mStack;
 		bool mAssign = false;
 		std::vector<std::string> mWarnings;
 
-		cfg::Value& getCurrent();
+		Value& getCurrent() { return *mStack.back(); }
+		// add a name value pair to the current object or (inside a new
+		// object) to the current array. nullptr if there is no container.
+		NameValuePair* addNameValuePair();
 		void addWarning(const std::string& warning);
 		void checkForResetAssign();
+		// empty root object as the current container
+		void restart();
 	};
 }
 
@@ -0,0 +1,169 @@
+#ifndef CFG_CFG_FROZEN_H
+#define CFG_CFG_FROZEN_H
+
+#include <cfg/export.h>
+#include <cfg/cfg.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cfg
+{
+	class FrozenDocument;
+
+	/**
+	 * Read only handle of a value inside a FrozenDocument. Is only valid
+	 * as long as the document exists. Is small (pointer and index) and
+	 * can be copied.
+	 */
+	class CFG_API FrozenValue
+	{
+	public:
+		// invalid value (e.g. return value if a name doesn't exist)
+		FrozenValue() = default;
+
+		bool isValid() const { return mDoc != nullptr; }
+		Value::EValueType getType() const;
+
+		bool isEmpty() const { return getType() == Value::TYPE_NONE; }
+		bool isComment() const { return getType() == Value::TYPE_COMMENT; }
+		bool isNull() const { return getType() == Value::TYPE_NULL; }
+		bool isBool() const { return getType() == Value::TYPE_BOOL; }
+		bool isFloat() const { return getType() == Value::TYPE_FLOAT; }
+		bool isInteger() const { return getType() == Value::TYPE_INT; }
+		bool isInteger64() const { return getType() == Value::TYPE_INT64; }
+		bool isDouble() const { return getType() == Value::TYPE_DOUBLE; }
+		bool isText() const { return getType() == Value::TYPE_TEXT; }
+		bool isArray() const { return getType() == Value::TYPE_ARRAY; }
+		bool isObject() const { return getType() == Value::TYPE_OBJECT; }
+
+		// same meaning as mBool, mFloatingPoint, ... of Value
+		bool getBool() const;
+		float getFloatingPoint() const;
+		int getInteger() const;
+		int64_t getInteger64() const;
+		double getDouble() const;
+		// text of TYPE_TEXT or TYPE_COMMENT (0-terminated, stored at the
+		// string pool of the document), "" for all other types
+		const char* getText() const;
+		std::size_t getTextLength() const;
+		bool isTextEqual(const std::string& text) const;
+		bool getParseTextWithQuotes() const;
+		unsigned int getParseBase() const;
+
+		std::size_t arraySize() const;
+		FrozenValue arrayAt(std::size_t index) const;
+
+		// pairs in the same order as in Value::mObject
+		std::size_t objectSize() const;
+		FrozenValue objectNameAt(std::size_t index) const;
+		FrozenValue objectValueAt(std::size_t index) const;
+
+		/**
+		 * Same as Value::objectGetValue(). Return an invalid value if
+		 * none or more than one pair with this name exist.
+		 * The pair is searched by the sorted hash index of the object
+		 * (O(log n) instead of O(n)).
+		 */
+		FrozenValue objectGetValue(const std::string& attrName) const;
+		int objectGetAttrIndex(const std::string& attrName) const;
+		bool objectGetText(const std::string& attrName, std::string& attrValue) const;
+		// if not exist it return ""
+		std::string objectGetText(const std::string& attrName) const;
+		bool objectGetInteger(const std::string& attrName, int& attrValue) const;
+		// if not exist it return 0
+		int objectGetInteger(const std::string& attrName) const;
+		bool objectGetFloat(const std::string& attrName, bool allowInteger, float& attrValue) const;
+		// if not exist it return 0
+		float objectGetFloat(const std::string& attrName, bool allowInteger) const;
+		bool objectGetBool(const std::string& attrName, bool& attrValue) const;
+		bool objectGetBool(const std::string& attrName) const;
+
+		// deep copy as Value (without file positions)
+		Value toValue() const;
+	private:
+		friend class FrozenDocument;
+		const FrozenDocument* mDoc = nullptr;
+		uint32_t mIndex = 0;
+
+		FrozenValue(const FrozenDocument* doc, uint32_t index)
+				:mDoc(doc), mIndex(index) {}
+		void toValue(Value& outValue) const;
+	};
+
+	/**
+	 * Immutable, flat copy of a Value tree for configs which are only
+	 * read after loading.
+	 *
+	 * All values are stored in one array (the children of an array or
+	 * an object are stored contiguous), all texts in one string pool and
+	 * the names of each object are additionally stored as a sorted
+	 * (hash, pair index) index. Therefore a lookup by name is a binary
+	 * search and reading needs much less pointer chasing than a Value
+	 * tree. The document can't be changed after it is created and can be
+	 * read by multiple threads without synchronisation.
+	 *
+	 * e.g.
+	 *   FrozenDocument doc = freeze(value);
+	 *   int port = doc.root().objectGetValue("server").objectGetInteger("port");
+	 */
+	class CFG_API FrozenDocument
+	{
+	public:
+		FrozenDocument();
+		explicit FrozenDocument(const Value& value);
+		// the values have a pointer to the document
+		FrozenDocument(const FrozenDocument&) = delete;
+		FrozenDocument& operator=(const FrozenDocument&) = delete;
+		FrozenDocument(FrozenDocument&& other) noexcept;
+		FrozenDocument& operator=(FrozenDocument&& other) noexcept;
+
+		FrozenValue root() const { return FrozenValue(this, 0); }
+		std::size_t getNodeCount() const { return mNodes.size(); }
+		std::size_t getStringPoolSize() const { return mStrings.size(); }
+	private:
+		friend class FrozenValue;
+		struct Node
+		{
+			int64_t mInteger64;
+			double mDouble;
+			float mFloatingPoint;
+			int mInteger;
+			// TYPE_TEXT, TYPE_COMMENT: offset at mStrings
+			// TYPE_ARRAY: index of the first element at mNodes
+			// TYPE_OBJECT: index of the first name at mNodes (name and
+			// value of each pair are stored one after the other)
+			uint32_t mBegin;
+			// text length, element count or pair count
+			uint32_t mSize;
+			// TYPE_OBJECT: entries at mMembers (pairs with a text name)
+			uint32_t mMemberBegin;
+			uint32_t mMemberCount;
+			uint8_t mType;
+			uint8_t mParseBase;
+			bool mBool;
+			bool mParseTextWithQuotes;
+		};
+		struct Member
+		{
+			uint32_t mHash;
+			// pair index inside the object
+			uint32_t mPairIndex;
+		};
+		std::vector<Node> mNodes;
+		std::vector<Member> mMembers;
+		std::string mStrings;
+
+		void setNode(uint32_t index, const Value& value);
+		// return -1 if not found (or found more than once if unique is true)
+		int findPair(const Node& object, const std::string& attrName,
+				bool unique) const;
+	};
+
+	inline FrozenDocument freeze(const Value& value)
+	{
+		return FrozenDocument(value);
+	}
+}
+
+#endif
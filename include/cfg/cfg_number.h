@@ -0,0 +1,59 @@
+#ifndef CFG_CFG_NUMBER_H
+#define CFG_CFG_NUMBER_H
+
+#include <cfg/export.h>
+#include <cfg/cfg.h>
+#include <string>
+
+namespace cfg
+{
+	/**
+	 * Number parsing and printing which is shared by the TML and the
+	 * JSON parser/writer.
+	 */
+	namespace number
+	{
+		/**
+		 * Parse a decimal number [+-]digits[.digits][(e|E)[+-]digits]
+		 * from begin to end (exclusive, no null termination necessary).
+		 * At least one digit must exist (e.g. 5, -5, 5., .5).
+		 * The number is stored with the smallest type which holds it
+		 * exactly:
+		 *   integer: Value::TYPE_INT or Value::TYPE_INT64
+		 *            (a greater integer is stored as Value::TYPE_DOUBLE)
+		 *   floating point: Value::TYPE_FLOAT for at most 6 significant
+		 *            digits and 0.0001 <= |number| < 1000000 (text ->
+		 *            float -> text is the same number, without exponent)
+		 *            otherwise Value::TYPE_DOUBLE.
+		 * Most numbers are parsed without a copy, the others with
+		 * stringToDouble(). Both are independent of the locale.
+		 * @param allowExponent false for TML (1e5 is a text in TML).
+		 * @return false if it isn't a number. outValue isn't changed then.
+		 */
+		CFG_API
+		bool parseNumber(const char* begin, const char* end,
+				bool allowExponent, Value& outValue);
+
+		/**
+		 * Shortest text for value which is parsed back to the same double.
+		 * A dot is always included (1.0 instead of 1) that it isn't
+		 * parsed as integer. Independent of the locale.
+		 * @param allowExponent If false then the number is printed
+		 *        without exponent (TML), e.g. 100000000000000000000.0
+		 *        instead of 1e+20.
+		 */
+		CFG_API
+		std::string doubleToString(double value, bool allowExponent);
+
+		/**
+		 * Same as strtod() but always with the "C" locale (a dot is the
+		 * decimal point). Parses the longest prefix of text which is a
+		 * number. Out of range numbers are +-HUGE_VAL. Returns 0.0 if
+		 * text doesn't begin with a number.
+		 */
+		CFG_API
+		double stringToDouble(const std::string& text);
+	}
+}
+
+#endif
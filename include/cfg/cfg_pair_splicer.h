@@ -0,0 +1,63 @@
+#ifndef CFG_CFG_PAIR_SPLICER_H
+#define CFG_CFG_PAIR_SPLICER_H
+
+#include <cfg/export.h>
+#include <cfg/cfg.h>
+#include <vector>
+
+namespace cfg
+{
+	/**
+	 * Replace name-value pairs of an object by none, one or more
+	 * name-value pairs (e.g. for includes and templates) in linear time.
+	 *
+	 * Instead of pairs.insert() or pairs.erase() for each replacement
+	 * (which moves all following pairs) the pairs are moved into a new
+	 * vector at the first replacement which changes the count of pairs.
+	 * The vector is swapped with the pairs by finish().
+	 *
+	 * Until finish() is called the pairs are not reallocated. Therefore
+	 * references to pairs which are not already replaced stay valid.
+	 * replace() and erase() must be called with ascending indices.
+	 *
+	 * e.g.
+	 *   PairSplicer splicer(pairs);
+	 *   for (std::size_t i = 0; i < pairs.size(); ++i) {
+	 *       if (...) {
+	 *           splicer.replace(i, newPairs);
+	 *       }
+	 *   }
+	 *   splicer.finish();
+	 */
+	class CFG_API PairSplicer
+	{
+	public:
+		explicit PairSplicer(std::vector<NameValuePair>& pairs);
+
+		/**
+		 * Replace pairs[index] by newPairs. The pairs of newPairs are moved.
+		 * @param index Must be greater than the index of the previous call.
+		 */
+		void replace(std::size_t index, std::vector<NameValuePair>& newPairs);
+		// Same as replace() with no new pairs.
+		void erase(std::size_t index);
+
+		/**
+		 * Must be called after the last replace() or erase() call.
+		 * If finish() isn't called (e.g. after an error) then already
+		 * replaced pairs are in a moved-from state.
+		 */
+		void finish();
+
+	private:
+		std::vector<NameValuePair>& mPairs;
+		std::vector<NameValuePair> mNewPairs;
+		// index of the first pair which is not moved to mNewPairs
+		std::size_t mNextIndex;
+		bool mIsUsed;
+
+		void moveUntil(std::size_t index);
+	};
+}
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef CFG_CFG_SCHEMA_VALIDATOR_H
+#define CFG_CFG_SCHEMA_VALIDATOR_H
+
+#include <cfg/export.h>
+#include <cfg/cfg.h>
+#include <cfg/cfg_schema.h>
+#include <string>
+#include <vector>
+
+namespace cfg
+{
+	/**
+	 * Validator for a cfg value tree. The NVFragmentSchema is compiled
+	 * into flat tables (type masks, ranges, allowed values, members and
+	 * a name hash table per object). After compiling, validate() can be
+	 * called for any count of cfg values.
+	 *
+	 * Rules for a member (NVPSchema) of an object:
+	 * - If the name schema has a text value (keyword 'value') then the
+	 *   member is looked up by this name. Such a member is required
+	 *   if the value schema has no default (keyword 'default') and
+	 *   doesn't allow the type 'none'.
+	 * - All other members are checked in order of the schema and the
+	 *   first member with a matching name schema is used.
+	 * - A name-value-pair of the cfg value which matches no member is
+	 *   a violation.
+	 * - A member without a value schema only allows an empty value.
+	 * - A value schema with an object validates the value recursively.
+	 *
+	 * validate() doesn't allocate memory if no violation exists.
+	 * All violations are reported (not only the first).
+	 *
+	 * @note A validator has internal state which is used by validate().
+	 *       Therefore one validator can't be used by several threads
+	 *       at the same time.
+	 */
+	class CFG_API SchemaValidator
+	{
+	public:
+		/**
+		 * Compile the schema. A previous compiled schema is replaced.
+		 * @param nvfs Schema. Must be an object schema (created by
+		 *        schema::getSchemaFromCfgValue()).
+		 */
+		bool compile(const NVFragmentSchema& nvfs, std::string& outErrorMsg);
+
+		bool isCompiled() const { return !mObjects.empty(); }
+
+		/**
+		 * Validate the cfg value (must be an object).
+		 * @param outErrorMsg Is cleared and contains one line per
+		 *        violation (with file position) if false is returned.
+		 * @return true if the cfg value is valid.
+		 */
+		bool validate(const Value& cfgValue, std::string& outErrorMsg);
+
+		/**
+		 * @return Count of violations of the last validate() call
+		 *         or of the current/last streaming validation.
+		 */
+		unsigned int getViolationCount() const { return mViolationCount; }
+
+		/**
+		 * Streaming validation. Instead of a full cfg value tree the
+		 * validator is fed with the name-value-pairs of the root object
+		 * (e.g. line by line from a parser). A name-value-pair which has
+		 * an object as value can be passed with streamBeginObject(),
+		 * streamNameValuePair() for its members and streamEndObject().
+		 * Then only the currently open objects are stored by the validator.
+		 *
+		 * The stream functions append violations to outErrorMsg and
+		 * return false if the call has caused one or more violations.
+		 * A missing required member is reported by streamEndObject()
+		 * and endStream() (for the root object). The root object has no
+		 * name --> its violations are reported with the filename of
+		 * beginStream() (can be nullptr).
+		 *
+		 * e.g.
+		 *   validator.beginStream();
+		 *   validator.streamNameValuePair(nvp1, errMsg);
+		 *   validator.streamBeginObject(name2, errMsg);
+		 *   validator.streamNameValuePair(nvp3, errMsg);
+		 *   validator.streamEndObject(errMsg);
+		 *   bool isValid = validator.endStream(errMsg);
+		 */
+		void beginStream(const std::shared_ptr<const std::string>& filename = nullptr);
+		bool streamNameValuePair(const NameValuePair& nvp, std::string& outErrorMsg);
+		bool streamBeginObject(const Value& name, std::string& outErrorMsg);
+		bool streamEndObject(std::string& outErrorMsg);
+		/**
+		 * Closes all open objects.
+		 * @return true if no violation happened since beginStream().
+		 */
+		bool endStream(std::string& outErrorMsg);
+
+	private:
+		enum
+		{
+			FLAG_INT_MIN   = 1,
+			FLAG_INT_MAX   = 2,
+			FLAG_FLOAT_MIN = 4,
+			FLAG_FLOAT_MAX = 8,
+			FLAG_VALUE     = 16,
+		};
+
+		struct Fragment
+		{
+			// 0 for all types are allowed
+			unsigned int mAllowedTypes = 0;
+			unsigned int mFlags = 0;
+			int mIntMin = 0;
+			int mIntMax = 0;
+			float mFloatMin = 0;
+			float mFloatMax = 0;
+			// allowed values (keyword 'value') are stored at mConstants
+			unsigned int mConstBegin = 0;
+			unsigned int mConstCount = 0;
+			// -1 if no object schema is used
+			int mObjectIndex = -1;
+		};
+
+		struct Member
+		{
+			Fragment mName;
+			Fragment mValue;
+			bool mRequired = false;
+		};
+
+		struct NameEntry
+		{
+			unsigned int mHash = 0;
+			unsigned int mMemberIndex = 0;
+			// index of the name text at mConstants
+			unsigned int mConstIndex = 0;
+		};
+
+		struct Frame
+		{
+			// -1 if the content of the object is not checked
+			int mObjectIndex = -1;
+			unsigned int mStamp = 0;
+			unsigned int mRequiredFound = 0;
+			// only the file position is used (for streaming)
+			Value mPosition;
+		};
+
+		struct Object
+		{
+			unsigned int mMemberBegin = 0;
+			unsigned int mMemberCount = 0;
+			unsigned int mRequiredCount = 0;
+			// hash table at mNameSlots. Size is mSlotMask + 1 (power of 2).
+			// Each slot contains index + 1 of mNameEntries or 0 for free.
+			unsigned int mSlotBegin = 0;
+			unsigned int mSlotMask = 0;
+			// members which are not looked up by hash are stored at mPatternMembers
+			unsigned int mPatternBegin = 0;
+			unsigned int mPatternCount = 0;
+		};
+
+		std::vector<Object> mObjects;
+		std::vector<Member> mMembers;
+		std::vector<Value> mConstants;
+		std::vector<NameEntry> mNameEntries;
+		std::vector<unsigned int> mNameSlots;
+		std::vector<unsigned int> mPatternMembers;
+
+		// used by validate() to detect missing and duplicate members.
+		// A member is used for the current object if its stamp is equal.
+		std::vector<unsigned int> mMemberStamps;
+		unsigned int mStamp = 0;
+		unsigned int mViolationCount = 0;
+		// open objects of the streaming validation
+		std::vector<Frame> mStreamStack;
+
+		bool compileFragment(Fragment& outFragment, const NVFragmentSchema& nvfs,
+				bool valueIsUsed, std::string& outErrorMsg);
+		bool compileObject(unsigned int& outObjectIndex, const NVFragmentSchema& nvfs,
+				std::string& outErrorMsg);
+
+		bool checkFragment(const Fragment& fragment, const Value& value,
+				const Value& positionValue, bool reportViolation,
+				std::string& outErrorMsg);
+		void beginObject(Frame& frame, int objectIndex);
+		// return member index or -1
+		int useMember(Frame& frame, const Value& name, std::string& outErrorMsg);
+		void endObject(const Frame& frame, const Value& positionValue,
+				std::string& outErrorMsg);
+		void validateObject(unsigned int objectIndex, const Value& obj,
+				const Value& positionValue, std::string& outErrorMsg);
+		int findMember(const Object& object, const Value& name,
+				std::string& outErrorMsg);
+		void addViolation(const Value& positionValue, const std::string& msg,
+				std::string& outErrorMsg);
+	};
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef CFG_CFG_SHARED_VALUE_H
+#define CFG_CFG_SHARED_VALUE_H
+
+#include <cfg/export.h>
+#include <cfg/cfg.h>
+#include <memory>
+#include <vector>
+
+namespace cfg
+{
+	class SharedPair;
+
+	/**
+	 * Copy-on-write version of a Value tree (opt-in, Value itself is
+	 * unchanged).
+	 *
+	 * Each node of the tree is shared (std::shared_ptr). A copy of a
+	 * SharedValue is O(1), the copy and the original share all nodes.
+	 * Before a node is changed by one of the mutable...() functions
+	 * it is cloned if it is shared. Only the node is cloned, its children
+	 * are still shared (the child handles are copied). Therefore a change
+	 * of a deep child clones only the nodes on the path from the root
+	 * to the child.
+	 *
+	 * e.g. keep a snapshot and change one value:
+	 *   SharedValue snapshot(std::move(value));
+	 *   SharedValue changed = snapshot; // O(1)
+	 *   changed.mutableObjectAt(3).mValue.mutableObjectAt(0).mValue
+	 *           .mutableHead().setInteger(5);
+	 *   // snapshot is unchanged and shares all other subtrees with changed
+	 *
+	 * The nodes are immutable after they are shared. Therefore copies can
+	 * be read by multiple threads. A single SharedValue isn't thread safe.
+	 */
+	class CFG_API SharedValue
+	{
+	public:
+		// TYPE_NONE
+		SharedValue();
+		explicit SharedValue(const Value& value);
+		explicit SharedValue(Value&& value);
+
+		// deep copy as Value
+		Value toValue() const;
+
+		/**
+		 * The value without its children (mArray and mObject of the head
+		 * are always empty). Use arraySize(), arrayAt(), objectSize()
+		 * and objectAt() for the children.
+		 */
+		const Value& head() const { return mNode->mHead; }
+		Value::EValueType getType() const { return mNode->mHead.mType; }
+		std::size_t arraySize() const { return mNode->mArray.size(); }
+		const SharedValue& arrayAt(std::size_t index) const { return mNode->mArray[index]; }
+		std::size_t objectSize() const;
+		const SharedPair& objectAt(std::size_t index) const;
+
+		/**
+		 * Mutable access. The node is cloned before if it is shared.
+		 * mArray and mObject of the head must not be used (they are
+		 * ignored). setArray() and setObject() of the head don't clear
+		 * the children. Use mutableArray().clear() or
+		 * mutableObject().clear() instead.
+		 */
+		Value& mutableHead();
+		std::vector<SharedValue>& mutableArray();
+		std::vector<SharedPair>& mutableObject();
+		SharedValue& mutableArrayAt(std::size_t index) { return mutableArray()[index]; }
+		SharedPair& mutableObjectAt(std::size_t index);
+
+		// true if both use the same node (e.g. unchanged after a copy)
+		bool isSameNode(const SharedValue& other) const { return mNode == other.mNode; }
+		// true if the node is used by another SharedValue
+		bool isShared() const { return mNode.use_count() > 1; }
+	private:
+		struct Node
+		{
+			Value mHead;
+			std::vector<SharedValue> mArray;
+			std::vector<SharedPair> mObject;
+		};
+		std::shared_ptr<const Node> mNode;
+
+		Node& makeUnique();
+		void toValue(Value& outValue) const;
+	};
+
+	/**
+	 * Name-value pair of a SharedValue object (see NameValuePair).
+	 */
+	class CFG_API SharedPair
+	{
+	public:
+		SharedValue mName;
+		SharedValue mValue;
+		// -1 for no deep specified
+		int mDeep = -1;
+
+		SharedPair() = default;
+		explicit SharedPair(const NameValuePair& nvp);
+		explicit SharedPair(NameValuePair&& nvp);
+		NameValuePair toNameValuePair() const;
+	};
+
+	inline std::size_t SharedValue::objectSize() const
+	{
+		return mNode->mObject.size();
+	}
+
+	inline const SharedPair& SharedValue::objectAt(std::size_t index) const
+	{
+		return mNode->mObject[index];
+	}
+
+	inline SharedPair& SharedValue::mutableObjectAt(std::size_t index)
+	{
+		return mutableObject()[index];
+	}
+}
+
+#endif
@@ -22,10 +22,20 @@ namespace cfg
 		std::size_t getParameterCount() const { return mParameters.size(); }
 		const std::vector<std::string>& getParameters() const { return mParameters; }
 		std::string toString() const;
+		/**
+		 * Move the deep of the pairs (and their children) so that the
+		 * lowest deep is 0. Then a template which is used at the root
+		 * can be copied without correcting the deep of each pair.
+		 * The moved count is stored for toString().
+		 */
+		void moveDeepToZero();
+		int getDeepOffset() const { return mDeepOffset; }
 	private:
 		std::string mName;
 		std::vector<std::string> mParameters;
 		std::vector<NameValuePair> mObject;
+		// count of deeps which are removed by moveDeepToZero()
+		int mDeepOffset;
 	};
 
 	namespace cfgtemp
@@ -29,10 +29,20 @@ namespace cfg
 		void setBuffering(bool buffering) { mBuffering = buffering; }
 		void clearBufferedFiles() { mBufferedFiles.clear(); }
 		void clearAndResetBuffering() { mBufferedFiles.clear(); mBuffering = false; }
+	protected:
+		std::unique_ptr<ValueParser> mParser;
+
+		/**
+		 * Parse the file with mParser. Is called by loadAndPush() if the
+		 * file is not buffered. Can be overridden to get the content
+		 * from another source.
+		 * @param outErrorMsg Is set if false is returned.
+		 */
+		virtual bool parseFile(Value& outValue, const std::string& fullFilename,
+				bool inclEmptyLines, bool inclComments, std::string& outErrorMsg);
 	private:
 		typedef std::map<std::string, Value> TFileBufferMap;
 
-		std::unique_ptr<ValueParser> mParser;
 		std::vector<std::string> mPathStack;
 
 		bool mBuffering = false;
@@ -2,7 +2,9 @@
 #define CFG_VALUE_PARSER_H
 
 #include <cfg/export.h>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace cfg
 {
@@ -17,10 +19,47 @@ namespace cfg
 		virtual ~ValueParser() = default;
 		virtual void reset() = 0;
 		virtual bool setFilename(const std::string& filename) = 0;
+		/**
+		 * Parse the content of strBuffer instead of reading a file.
+		 * The filename is only used for error messages and the
+		 * filename of the values.
+		 * @return false if the parser doesn't support a string buffer.
+		 */
+		virtual bool setStringBuffer(const std::string& /*filename*/,
+				const std::string& /*strBuffer*/) { return false; }
 		virtual bool getAsTree(Value& root,
 				bool inclEmptyLines = false, bool inclComments = false) = 0;
 		// return filename with linenumber and error message
 		virtual std::string getExtendedErrorMsg() const = 0;
+
+		/**
+		 * If enabled then getAsTree() packs the array values with only
+		 * numbers of one type (see Value::mPackedArray). Names aren't
+		 * packed. The json and btml parser store the numbers directly
+		 * in the packed array. The tml parser packs each array when
+		 * its line (or its last line) is parsed. Default is disabled
+		 * because code which uses Value::mArray directly doesn't see the
+		 * elements of a packed array.
+		 */
+		virtual void setPackNumericArrays(bool enable) { mPackNumericArrays = enable; }
+		bool getPackNumericArrays() const { return mPackNumericArrays; }
+
+		/**
+		 * If names are set then getAsTree() returns only the top level
+		 * pairs with one of these names (e.g. {"render", "audio"}). All
+		 * other top level pairs and their children are skipped as early
+		 * as the format allows it. They aren't checked for errors. Empty
+		 * lines and comments after a skipped pair are skipped too.
+		 * Empty (default) for all pairs.
+		 */
+		virtual void setProjection(const std::vector<std::string>& topLevelNames)
+		{
+			mProjection = std::set<std::string>(topLevelNames.begin(), topLevelNames.end());
+		}
+		const std::set<std::string>& getProjection() const { return mProjection; }
+	protected:
+		bool mPackNumericArrays = false;
+		std::set<std::string> mProjection;
 	};
 }
 
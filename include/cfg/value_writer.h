@@ -0,0 +1,124 @@
+#ifndef CFG_VALUE_WRITER_H
+#define CFG_VALUE_WRITER_H
+
+#include <cfg/export.h>
+#include <cfg/cfg.h>
+#include <string>
+#include <vector>
+
+namespace cfg
+{
+	/**
+	 * Write a config directly to a stream without building a Value tree.
+	 *
+	 * The functions are the same as the functions of CfgCreator and have
+	 * the same meaning. The output is the same as creating the config with
+	 * CfgCreator and converting it afterwards (e.g. tmlstring::valueToStream()
+	 * for TmlWriter). Only the currently open objects and arrays are stored.
+	 *
+	 * Limit: an open array which has only simple values so far is written
+	 * in one line (TmlWriter and JsonWriter). It isn't known how the array
+	 * is written until it is closed or a complex element is added.
+	 * Therefore the texts of its simple values are stored until then. The
+	 * memory grows with the count of these values (O(n) for one big simple
+	 * array) and otherwise with the deep of the open objects and arrays.
+	 *
+	 * e.g.
+	 *   std::ofstream ofs("out.tml");
+	 *   TmlWriter writer(ofs);
+	 *   writer
+	 *       .nvpText("someText", "hello")
+	 *       .pushObject("aObject")
+	 *           .nvpInt("a-number", 13)
+	 *       .popObject();
+	 *   writer.finish();
+	 */
+	class CFG_API ValueWriter
+	{
+	public:
+		ValueWriter();
+		virtual ~ValueWriter() = default;
+		ValueWriter(const ValueWriter&) = delete;
+		ValueWriter& operator=(const ValueWriter&) = delete;
+
+		ValueWriter& configParseTextWithQuotes(bool enable);
+		ValueWriter& configParseTextWithQuotesForName(bool enable);
+		ValueWriter& configParseTextWithQuotesForValue(bool enable);
+
+		// for empty line
+		ValueWriter& empty();
+		ValueWriter& comment(std::string comment, bool withSpace = true);
+
+		ValueWriter& pushObject(std::string name);
+		ValueWriter& popObject();
+
+		ValueWriter& pushArray(std::string name);
+		ValueWriter& popArray();
+
+		// nvp ... name value pair
+		ValueWriter& nvpNull(std::string name);
+		ValueWriter& nvpBool(std::string name, bool value);
+		ValueWriter& nvpFloat(std::string name, float value);
+		ValueWriter& nvpInt(std::string name, int value);
+		ValueWriter& nvpText(std::string name, std::string value);
+
+		// val ... value
+		ValueWriter& valNull();
+		ValueWriter& valBool(bool value);
+		ValueWriter& valFloat(float value);
+		ValueWriter& valInt(int value);
+		ValueWriter& valText(std::string value);
+
+		// see CfgCreator::assign()
+		ValueWriter& assign();
+
+		/**
+		 * Close all open objects and arrays and write the end of the
+		 * document. Must be called once after the last entry. No entries
+		 * can be added after finish().
+		 */
+		void finish();
+		bool warningsExist() const { return !mWarnings.empty(); }
+		std::string getWarningsAsString() const;
+	protected:
+		/**
+		 * Format specific output. The functions are called in the order
+		 * of the document.
+		 */
+		// pair of the current object: a simple name with a simple or an
+		// empty value, a comment or an empty line.
+		virtual void writePair(const NameValuePair& nvp) = 0;
+		// element of the current array: a simple value or a comment
+		virtual void writeElement(const Value& value) = 0;
+		// name is nullptr if the object/array is an element of an array
+		virtual void beginObject(const Value* name) = 0;
+		virtual void endObject() = 0;
+		virtual void beginArray(const Value* name) = 0;
+		virtual void endArray() = 0;
+		virtual void endDocument() = 0;
+	private:
+		bool isParseTextWithQuotesForName = false;
+		bool isParseTextWithQuotesForValue = false;
+
+		// true for an array, false for an object. The root object is the
+		// first entry.
+		std::vector<bool> mIsArrayStack;
+		// A value inside an object is a name which can get a value by
+		// assign(). Therefore it is written at the next call.
+		NameValuePair mPendingPair;
+		bool mHasPendingPair = false;
+		bool mAssign = false;
+		bool mFinished = false;
+		std::vector<std::string> mWarnings;
+
+		bool isCurrentArray() const { return mIsArrayStack.back(); }
+		void addPair(NameValuePair& nvp);
+		void addValue(Value& value);
+		void flushPendingPair();
+		void addWarning(const std::string& warning);
+		// flush the pending pair and reset an unused assign
+		void prepareEntry();
+	};
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef CFG_EXPRESSION_CACHE_H
+#define CFG_EXPRESSION_CACHE_H
+
+#include <cfg/export.h>
+#include <cfg/cfg.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cfg
+{
+	namespace interpreter
+	{
+		/**
+		 * Cache for the results of expressions. Generated configs often use
+		 * the same expression many times (e.g. '_i ( 1920 / 2 )' for each
+		 * widget). Without a cache each occurrence is lexed, parsed and
+		 * interpreted again.
+		 *
+		 * The key of an entry is the normalised token sequence of the
+		 * expression (the position of the tokens inside the file is ignored).
+		 * A result which is taken from the source (e.g. '_i ( abc )') must
+		 * have the position of the current occurrence. Therefore the cache
+		 * remembers which token gave each position of the result and a hit
+		 * takes the positions from the tokens of the current occurrence.
+		 * Only if a position of the result isn't found at a token the
+		 * expression is remembered as not cacheable and is always
+		 * interpreted.
+		 *
+		 * A cache can be shared by several threads (e.g. for
+		 * interpretAndReplaceParallel()).
+		 */
+		class CFG_API ExpressionCache
+		{
+		public:
+			/**
+			 * Create the normalised key for the token sequence of an expression.
+			 * Empty lines and comments are ignored like the lexer does it.
+			 * @param tokens Pointer to the first token. e.g. '_i'
+			 * @param count Count of tokens inclusive the ending ')'.
+			 */
+			static std::string createKey(const Value* tokens, size_t count,
+					bool allowInterpretationWithQuotes);
+
+			/**
+			 * @param tokens, count The tokens of the current occurrence
+			 *        (the same as for createKey()).
+			 * @param outResult Cached result for a hit (with the positions
+			 *        of tokens).
+			 * @return true for a hit. false if the key doesn't exist or the
+			 *         result of the expression isn't cacheable.
+			 */
+			bool find(const std::string& key, const Value* tokens, size_t count,
+					Value& outResult);
+
+			/**
+			 * Add the result of an expression after a miss.
+			 * @param tokens, count The tokens of the expression (the same
+			 *        as for createKey()).
+			 */
+			void add(const std::string& key, const Value& result,
+					const Value* tokens, size_t count);
+
+			/**
+			 * Remove all entries and reset the hit and miss counters.
+			 */
+			void clear();
+
+			size_t getHitCount() const;
+			size_t getMissCount() const;
+			// count of entries (different expressions)
+			size_t size() const;
+		private:
+			struct Entry
+			{
+				// false if a position of the result isn't from a token
+				bool mIsCacheable = false;
+				Value mResult;
+				/**
+				 * For each node of mResult (see getNodes()) the index of
+				 * the token node which gives its position or -1 for no
+				 * position. Empty if the result has no position.
+				 */
+				std::vector<int> mPositionTokens;
+			};
+
+			mutable std::mutex mMutex;
+			std::unordered_map<std::string, Entry> mEntries;
+			size_t mHitCount = 0;
+			size_t mMissCount = 0;
+		};
+	}
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <cfg/export.h>
 #include <cfg/cfg.h>
 #include <interpreter/expressions.h>
+#include <interpreter/expression_cache.h>
 #include <memory>
 
 // Parser for interpreter based on a C++ port of Nystrom's bantam demo for pratt parsing.
@@ -47,6 +48,16 @@ namespace cfg
 		int interpretAndReplaceExprValue(cfg::Value& exprResultValue,
 				bool allowInterpretationWithQuotes, std::ostream& errMsg);
 
+		/**
+		 * Same as above but an expression which was already used
+		 * is taken from the cache. The cache is extended by new expressions.
+		 * @param cache Can be nullptr for using no cache.
+		 */
+		CFG_API
+		int interpretAndReplaceExprValue(cfg::Value& exprResultValue,
+				bool allowInterpretationWithQuotes, ExpressionCache* cache,
+				std::ostream& errMsg);
+
 		/**
 		 * Interpret and replace the cfgValueTree. If one or more objects
 		 * are included then also the name-value-pairs are interpreted
@@ -87,6 +98,67 @@ namespace cfg
 				bool allowNameInterpretation,
 				bool allowValueInterpretation,
 				std::ostream& errMsg);
+
+		/**
+		 * Same as above but with an expression cache.
+		 * @param cache Can be nullptr for using no cache.
+		 */
+		CFG_API
+		int interpretAndReplace(cfg::Value& cfgValueTree,
+				bool allowInterpretationWithQuotes,
+				bool allowArrayElementInterpretation,
+				bool allowNameInterpretation,
+				bool allowValueInterpretation,
+				ExpressionCache* cache,
+				std::ostream& errMsg);
+
+		/**
+		 * Same as interpretAndReplace() but independent subtrees are
+		 * interpreted in parallel by a pool of worker threads.
+		 * The tree is split into tasks at the name-value-pairs of objects
+		 * (also nested objects) and at the elements of an array. Each task
+		 * is an array (name or value or element) which is interpreted by
+		 * interpretAndReplace(). Every task collects its error messages
+		 * separately. After all tasks are finished the error messages are
+		 * written to errMsg in document order. Therefore the error output
+		 * is deterministic and doesn't depend on the scheduling.
+		 *
+		 * @note In contrast to interpretAndReplace() an error of one task
+		 *       doesn't stop the other tasks. So errMsg can contain more
+		 *       than one error message and the tree can be partially
+		 *       interpreted if -1 is returned.
+		 *
+		 * @param threadCount Count of worker threads. 0 for using the
+		 *        count of hardware threads. If the count is 1 or less than
+		 *        two tasks exist then the tree is interpreted without an
+		 *        extra thread.
+		 * @return -1 for error happened at evaluation and interpretation
+		 *         0 for no evaluation and interpretation,
+		 *         >0 count for successful evaluation and interpretation
+		 */
+		CFG_API
+		int interpretAndReplaceParallel(cfg::Value& cfgValueTree,
+				bool allowInterpretationWithQuotes,
+				bool allowArrayElementInterpretation,
+				bool allowNameInterpretation,
+				bool allowValueInterpretation,
+				unsigned int threadCount,
+				std::ostream& errMsg);
+
+		/**
+		 * Same as above but with an expression cache. The cache is shared
+		 * by all worker threads.
+		 * @param cache Can be nullptr for using no cache.
+		 */
+		CFG_API
+		int interpretAndReplaceParallel(cfg::Value& cfgValueTree,
+				bool allowInterpretationWithQuotes,
+				bool allowArrayElementInterpretation,
+				bool allowNameInterpretation,
+				bool allowValueInterpretation,
+				unsigned int threadCount,
+				ExpressionCache* cache,
+				std::ostream& errMsg);
 	}
 }
 
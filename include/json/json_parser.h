@@ -4,12 +4,15 @@
 #include <cfg/export.h>
 #include <cfg/value_parser.h>
 
+#include <memory>
+#include <set>
 #include <string>
 
 namespace cfg
 {
 	class NameValuePair;
 	class Value;
+	class SchemaValidator;
 
 	/**
 	 * JSON - JavaScript Object Notation
@@ -37,15 +40,60 @@ namespace cfg
 		virtual ~JsonParser();
 		virtual void reset() override;
 		virtual bool setFilename(const std::string& filename) override;
+		virtual bool setStringBuffer(const std::string& pseudoFilename,
+				const std::string& strBuffer) override;
 		bool getAsTree(NameValuePair &root);
 		bool getAsTree(Value &root);
 		// inclEmptyLines and inclComments parameter are ignored!
 		virtual bool getAsTree(Value& root,
 				bool inclEmptyLines, bool inclComments) override;
+		// packNumericArrays: see setPackNumericArrays()
 		static bool getAsTree(Value &root, const std::string& filename,
-				unsigned int& outLineNumber, std::string& outErrorMsg);
+				unsigned int& outLineNumber, std::string& outErrorMsg,
+				bool packNumericArrays = false);
 		static bool getAsTree(Value &root, const std::string& filenameInfo,
 				std::istream& stream, unsigned int& outLineNumber,
+				std::string& outErrorMsg, bool packNumericArrays = false);
+		/**
+		 * Same as above but only the top level pairs with a name of
+		 * projection are converted (see setProjection()). The values of
+		 * the other pairs are skipped by bracket matching without creating
+		 * tokens. The root must be an object.
+		 */
+		static bool getAsTree(Value& root, const std::string& filenameInfo,
+				std::istream& stream, const std::set<std::string>& projection,
+				unsigned int& outLineNumber, std::string& outErrorMsg,
+				bool packNumericArrays = false);
+		/**
+		 * Push parser for sources which arrive in chunks (e.g. a pipe or a
+		 * socket). feed() accepts any chunk of bytes. If the root is an
+		 * object or an array then each member (element) is parsed as soon
+		 * as it is complete, so only the bytes of the current member are
+		 * buffered. Any other root value is buffered until finish().
+		 * finish() returns the same root as getAsTree(). Same as
+		 * getAsTree() only white spaces are allowed after the root value.
+		 */
+		bool beginFeed(const std::string& pseudoFilename);
+		// return false for a parse error (see getExtendedErrorMsg())
+		bool feed(const char* data, std::size_t size);
+		bool finish(Value& root);
+		/**
+		 * Validate the json file with the (compiled) validator without
+		 * building the full tree. The stream is read in chunks and each
+		 * member of the root object is validated as soon as it is complete
+		 * (same scanner as feed()), so only the bytes of the current member
+		 * are stored. The root must be an object.
+		 * @param stopAtFirstViolation If true then validation is stopped
+		 *        at the first member which causes a violation.
+		 * @param outErrorMsg Contains the violations or the parse error.
+		 * @return false for a parse error or a violation.
+		 *         For a violation validator.getViolationCount() is > 0.
+		 */
+		bool validateStream(SchemaValidator& validator,
+				bool stopAtFirstViolation, std::string& outErrorMsg);
+		static bool validateStream(SchemaValidator& validator,
+				const std::string& filenameInfo, std::istream& stream,
+				bool stopAtFirstViolation, unsigned int& outLineNumber,
 				std::string& outErrorMsg);
 		const std::string& getErrorMsg() const { return mErrorMsg; }
 		unsigned int getLineNumber() const { return mLineNumber; }
@@ -55,6 +103,37 @@ namespace cfg
 		std::string mFilename;
 		std::string mErrorMsg;
 		unsigned int mLineNumber;
+		// used instead of the file if mUseStrBuffer is true
+		std::string mStrBuffer;
+		bool mUseStrBuffer;
+
+		// state of feed(), mLineNumber is the current line
+		bool mFeedActive = false;
+		// '{' or '[' for a container root, ' ' for any other root value,
+		// 0 before the root value
+		char mFeedRootChar = 0;
+		bool mFeedRootEnd = false;
+		// depth of brackets (1 for the members of the root)
+		int mFeedDepth = 0;
+		bool mFeedInString = false;
+		bool mFeedEscape = false;
+		// bytes of the current member and the line of its first byte
+		std::string mFeedBuffer;
+		unsigned int mFeedBufferLineNumber = 0;
+		std::unique_ptr<Value> mFeedRoot;
+		std::shared_ptr<const std::string> mFeedFilenamePtr;
+		// set by validateStream(): the members are validated instead of stored
+		SchemaValidator* mFeedValidator = nullptr;
+		bool mFeedStopAtFirstViolation = false;
+		// true if the validation is stopped at the first violation
+		bool mFeedStopped = false;
+		std::string* mFeedViolations = nullptr;
+
+		// parse the member (element) of mFeedBuffer into mFeedRoot or
+		// validate it with mFeedValidator (if it isn't empty)
+		bool feedMember();
+		// stop feeding because of an error
+		bool feedError(const std::string& errorMsg);
 	};
 }
 
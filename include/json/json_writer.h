@@ -0,0 +1,74 @@
+#ifndef CFG_JSON_WRITER_H
+#define CFG_JSON_WRITER_H
+
+#include <cfg/value_writer.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cfg
+{
+	/**
+	 * Write JSON directly to a stream (see ValueWriter).
+	 * The output is the same as jsonstring::valueToStream(0, cfg, s,
+	 * indentMode) of the config which is created by CfgCreator with the
+	 * same calls.
+	 */
+	class CFG_API JsonWriter: public ValueWriter
+	{
+	public:
+		// indentMode: see jsonstring::valueToStream()
+		JsonWriter(std::ostream& s, int indentMode);
+	protected:
+		virtual void writePair(const NameValuePair& nvp) override;
+		virtual void writeElement(const Value& value) override;
+		virtual void beginObject(const Value* name) override;
+		virtual void endObject() override;
+		virtual void beginArray(const Value* name) override;
+		virtual void endArray() override;
+		virtual void endDocument() override;
+	private:
+		struct Frame
+		{
+			bool mIsArray;
+			// deep of the closing bracket
+			unsigned int mDeep;
+			/**
+			 * Everything in front of the opening bracket is written.
+			 * An element of an array is started at its first child
+			 * (or at the end). Only then it is known if the array is
+			 * written in one line or with one line per element.
+			 */
+			bool mIsStarted;
+			// count of written children
+			std::size_t mCount = 0;
+			/**
+			 * Only for arrays. An array with only simple values, empty
+			 * arrays or empty objects is written in one line. Therefore
+			 * their texts are stored until the array is closed or until
+			 * another element is added.
+			 */
+			bool mIsComplex = false;
+			std::vector<std::string> mSimpleTexts;
+
+			Frame(bool isArray, unsigned int deep, bool isStarted)
+					:mIsArray(isArray), mDeep(deep), mIsStarted(isStarted) {}
+		};
+
+		std::ostream& mStream;
+		int mIndentMode;
+		std::vector<Frame> mFrames;
+
+		// start the frame at the index (and its parents if necessary)
+		void start(std::size_t frameIndex);
+		// write the separator (and the opening bracket) for the next child
+		void prepareChild(std::size_t frameIndex);
+		// write the opening bracket and the stored values as own lines
+		void makeComplex(std::size_t frameIndex);
+		void addElementText(const std::string& text, bool isSimple);
+		void addIndent(unsigned int deep);
+		void addNewline();
+	};
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef CFG_TML_INDEX_H
+#define CFG_TML_INDEX_H
+
+#include <cfg/export.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cfg
+{
+	/**
+	 * Index of the top level and second level entries of a tml file.
+	 * Stores the line number and the byte offsets of the block of each
+	 * entry (the line of the entry and the lines of its children) and the
+	 * indention of the file. With it TmlParser::getIndexedEntry() can read
+	 * and parse only the block of one entry instead of the full file.
+	 *
+	 * The index can be stored as a (btml) sidecar file. It belongs to the
+	 * size and modification time (in nanoseconds) of the tml file at
+	 * build().
+	 *
+	 * e.g.
+	 *   TmlIndex index;
+	 *   if (index.loadOrBuild("scene.tml", errMsg)) {
+	 *       int i = index.find("render", "window");
+	 *       TmlParser parser;
+	 *       NameValuePair window;
+	 *       parser.getIndexedEntry(index, i, window);
+	 *   }
+	 */
+	class CFG_API TmlIndex
+	{
+	public:
+		struct Entry
+		{
+			std::string mName;
+			// 0 for a top level entry, 1 for a child of a top level entry
+			int mDeep = 0;
+			// index of the top level entry for a deep of 1, otherwise -1
+			int mParentIndex = -1;
+			unsigned int mLineNumber = 0;
+			// byte offset of the line of the entry
+			uint64_t mBegin = 0;
+			// byte offset after the last line of the block
+			uint64_t mEnd = 0;
+		};
+
+		// read the full tml file and create the index
+		bool build(const std::string& filename, std::string& outErrorMsg);
+		bool save(const std::string& indexFilename, std::string& outErrorMsg) const;
+		bool load(const std::string& indexFilename, std::string& outErrorMsg);
+		/**
+		 * Load the index file of filename (see getIndexFilename()). If it
+		 * doesn't exist or it isn't up to date then the index is built
+		 * and saved.
+		 */
+		bool loadOrBuild(const std::string& filename, std::string& outErrorMsg);
+		// true if the size and modification time of the tml file didn't change
+		bool isUpToDate() const;
+		void clear();
+
+		// return index of the first entry with this name or -1
+		int find(const std::string& name) const;
+		int find(const std::string& parentName, const std::string& name) const;
+		const std::vector<Entry>& getEntries() const { return mEntries; }
+		const std::string& getFilename() const { return mFilename; }
+		// 0 if the file has no indented line
+		char getIndentChar() const { return mIndentChar; }
+		unsigned int getIndentCharCount() const { return mIndentCharCount; }
+
+		static std::string getIndexFilename(const std::string& filename);
+	private:
+		std::string mFilename;
+		uint64_t mFileSize = 0;
+		// nanoseconds since epoch
+		int64_t mModificationTime = 0;
+		char mIndentChar = 0;
+		unsigned int mIndentCharCount = 1;
+		std::vector<Entry> mEntries;
+	};
+}
+
+#endif
@@ -5,13 +5,17 @@
 #include <cfg/value_parser.h>
 
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace cfg
 {
 	class NameValuePair;
 	class Value;
+	class SchemaValidator;
+	class TmlIndex;
 
 	/**
 	 * TML - Tiny Markup Language
@@ -26,14 +30,16 @@ namespace cfg
 			FILE,
 			STRING_STREAM,
 			CUSTOM_STREAM,
+			// pushed by feed()
+			FEED,
 		};
 		TmlParser();
 		TmlParser(const std::string& filename);
 		virtual ~TmlParser();
 		virtual void reset() override;
 		virtual bool setFilename(const std::string& filename) override;
-		bool setStringBuffer(const std::string& pseudoFilename,
-				const std::string& strBuffer);
+		virtual bool setStringBuffer(const std::string& pseudoFilename,
+				const std::string& strBuffer) override;
 		// If this is used then only the pointer is copied!
 		// --> inStream must live as long as TmlParser object!
 		bool setCustomStream(const std::string& pseudoFilename,
@@ -49,6 +55,76 @@ namespace cfg
 				bool inclEmptyLines = false, bool inclComments = false);
 		virtual bool getAsTree(Value &root,
 				bool inclEmptyLines = false, bool inclComments = false) override;
+		/**
+		 * Same result as getAsTree() (also line numbers and moved empty
+		 * lines and comments) but the file or string buffer is split into
+		 * chunks at lines with a deep of 0. The chunks are parsed by
+		 * separate threads and the entries are concatenated.
+		 * A custom stream is parsed by getAsTree().
+		 * @param threadCount Max. count of threads (and chunks).
+		 *        0 for std::thread::hardware_concurrency().
+		 */
+		bool getAsTreeParallel(Value& root,
+				bool inclEmptyLines = false, bool inclComments = false,
+				unsigned int threadCount = 0);
+		/**
+		 * Pull reader for large files with many top level entries (e.g. a
+		 * long list of "entity" blocks). getNextTopLevelEntry() returns one
+		 * complete top level pair (with all its children) per call. Only
+		 * the lines of the current top level entry are stored. The entries
+		 * (also the moved empty lines and comments) are the same as the
+		 * entries of the root object of getAsTree().
+		 * e.g.
+		 *   parser.beginTopLevelEntries();
+		 *   NameValuePair entry;
+		 *   while (parser.getNextTopLevelEntry(entry) == 0) { ... }
+		 */
+		bool beginTopLevelEntries();
+		// return -1 for error, -2 for end of file or 0 (deep of the entry) for success
+		int getNextTopLevelEntry(NameValuePair& entry,
+				bool inclEmptyLines = false, bool inclComments = false);
+		/**
+		 * Push parser for sources which arrive in chunks (e.g. a pipe or a
+		 * socket). feed() accepts any chunk of bytes (also partial lines).
+		 * Each complete top level entry is parsed as soon as the first line
+		 * of the next top level entry arrives, so only the lines of the
+		 * current top level entry are buffered. finish() parses the rest and
+		 * returns the same root as getAsTree().
+		 * e.g.
+		 *   parser.beginFeed("socket");
+		 *   while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+		 *       if (!parser.feed(buf, n)) { ... }
+		 *   }
+		 *   parser.finish(root);
+		 */
+		bool beginFeed(const std::string& pseudoFilename,
+				bool inclEmptyLines = false, bool inclComments = false);
+		// return false for a parse error (see getExtendedErrorMsg())
+		bool feed(const char* data, std::size_t size);
+		bool finish(Value& root);
+		/**
+		 * Read and parse only the block of one entry of a TmlIndex (see
+		 * TmlIndex::find()) from the indexed file. The entry (also its
+		 * line numbers and offsets) is the same as the entry of
+		 * getAsTree() of the full file. Resets the parser.
+		 * Return false if the index isn't up to date or for a parse error.
+		 */
+		bool getIndexedEntry(const TmlIndex& index, std::size_t entryIndex,
+				NameValuePair& entry,
+				bool inclEmptyLines = false, bool inclComments = false);
+		/**
+		 * Validate the tml source line by line with the (compiled) validator
+		 * without building the tree. Only the open objects and the
+		 * current multiple line array are stored.
+		 * Empty lines and comments are ignored.
+		 * @param stopAtFirstViolation If true then parsing is stopped at
+		 *        the first line which causes a violation.
+		 * @param outErrorMsg Contains the violations or the parse error.
+		 * @return false for a parse error or a violation.
+		 *         For a violation validator.getViolationCount() is > 0.
+		 */
+		bool validateStream(SchemaValidator& validator,
+				bool stopAtFirstViolation, std::string& outErrorMsg);
 		const std::string& getErrorMsg() const { return mErrorMsg; }
 		unsigned int getLineNumber() const { return mLineNumber; }
 		// return filename with linenumber and error message
@@ -68,6 +144,58 @@ namespace cfg
 
 		char mIndentChar;
 		unsigned int mIndentCharCount;
+
+		// first line number - 1 (used for parallel parsing of chunks)
+		unsigned int mLineNumberOffset;
+
+		// Buffers of getAsTree() which are kept (with their capacity)
+		// across files, see reset().
+		std::shared_ptr<const std::string> mFilenamePtr;
+		std::vector<Value*> mStack;
+		std::vector<Value> mMoveBuffer;
+
+		// state of getNextTopLevelEntry() (also used by getIndexedEntry())
+		std::unique_ptr<TmlParser> mEntryParser;
+		// lines of the current top level entry
+		std::string mEntryLines;
+		// first line of the next top level entry (already read)
+		std::string mNextEntryLine;
+		bool mHasNextEntryLine = false;
+		bool mEntriesEnd = false;
+		std::vector<NameValuePair> mEntries;
+		std::size_t mEntryIndex = 0;
+
+		// state of feed() (mLine is the partial line, mEntryLines the lines
+		// of the current top level entry)
+		bool mFeedInclEmptyLines = false;
+		bool mFeedInclComments = false;
+		bool mFeedHasEntryStart = false;
+		unsigned int mFeedLineNumberOffset = 0;
+		// parsed top level entries
+		std::vector<NameValuePair> mFeedEntries;
+
+		const std::shared_ptr<const std::string>& getFilenamePtr();
+
+		// read the next line into mLine. return false at the end or for an error
+		bool readLine();
+		// return same as getNextTmlEntry() but skips the top level entries
+		// which aren't part of the projection (see setProjection())
+		int getNextProjectedTmlEntry(NameValuePair& entry);
+		// return same as getNextTmlEntry() but skips empty lines and comments
+		int getNextValueEntry(NameValuePair& entry);
+		// read and parse the lines of the next top level entry into mEntries
+		bool readTopLevelEntry(bool inclEmptyLines, bool inclComments);
+		// parse lines (complete top level entries) with mEntryParser
+		bool parseEntryLines(const std::string& lines, unsigned int lineNumberOffset,
+				bool inclEmptyLines, bool inclComments, Value& outRoot);
+		// add the complete line mLine to the lines of the current top level entry
+		bool feedLine();
+		// parse the lines of the current top level entry into mFeedEntries
+		bool feedEntryLines();
+		// read all entries with a deep greater than parentDeep into container.
+		// deep and entry are used for input (first entry) and output (next entry).
+		bool readSection(Value& container, int parentDeep,
+				NameValuePair& entry, int& deep);
 	};
 
 	namespace tmlparser
@@ -0,0 +1,63 @@
+#ifndef CFG_TML_WRITER_H
+#define CFG_TML_WRITER_H
+
+#include <cfg/value_writer.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cfg
+{
+	/**
+	 * Write TML directly to a stream (see ValueWriter).
+	 * The output is the same as tmlstring::valueToStream(0, cfg, s) of
+	 * the config which is created by CfgCreator with the same calls.
+	 */
+	class CFG_API TmlWriter: public ValueWriter
+	{
+	public:
+		explicit TmlWriter(std::ostream& s);
+	protected:
+		virtual void writePair(const NameValuePair& nvp) override;
+		virtual void writeElement(const Value& value) override;
+		virtual void beginObject(const Value* name) override;
+		virtual void endObject() override;
+		virtual void beginArray(const Value* name) override;
+		virtual void endArray() override;
+		virtual void endDocument() override;
+	private:
+		struct Frame
+		{
+			bool mIsArray;
+			// deep of the line of the object/array, -1 for the root
+			int mDeep;
+			// false for the elements of an array
+			bool mIsNamed;
+			// the line of the object/array is finished (by the first child)
+			bool mHasChildren = false;
+			/**
+			 * Only for arrays. A simple array is written in one line
+			 * (e.g. "name = 1 2 3"). Therefore the texts of the simple
+			 * values are stored until the array is closed or until a
+			 * complex element (object, array, comment) is added.
+			 */
+			bool mIsComplex = false;
+			std::vector<std::string> mSimpleTexts;
+
+			Frame(bool isArray, int deep, bool isNamed)
+					:mIsArray(isArray), mDeep(deep), mIsNamed(isNamed) {}
+		};
+
+		std::ostream& mStream;
+		std::vector<Frame> mFrames;
+
+		// write the line of the current object if it is the first child
+		void prepareObjectChild();
+		// write the array line and the stored simple values as own lines
+		void makeComplex(Frame& frame);
+		// write the line of an object/array which is a child of the current frame
+		void beginChild(const Value* name, const char* arrayElementText);
+	};
+}
+
+#endif
@@ -79,10 +79,17 @@ bool cfg::BtmlParser::getAsTree(Value& root,
 			mBuf : mData.data();
 	unsigned int bufSize = (mSource == Source::CUSTOM_BUFFER) ?
 			mBufSize : static_cast<unsigned int>(mData.size());
-	unsigned int bytes = cfg::btmlstream::streamToValueWithOptionalHeader(
-			buf, bufSize, root,
-			&mErrorMsg, headerExist, stringTableExist, stringTableEntryCount,
-			stringTableSize);
+	unsigned int bytes = 0;
+	if (!mProjection.empty()) {
+		bytes = cfg::btmlstream::streamToProjectedValueWithOptionalHeader(
+				buf, bufSize, root, mProjection, &mErrorMsg, mPackNumericArrays);
+	}
+	else {
+		bytes = cfg::btmlstream::streamToValueWithOptionalHeader(
+				buf, bufSize, root,
+				&mErrorMsg, headerExist, stringTableExist, stringTableEntryCount,
+				stringTableSize, mPackNumericArrays);
+	}
 	if (bytes != bufSize) {
 		mErrorMsg += "warning: Convert btml to cfg::Value don't use all bytes. (" +
 				std::to_string(bytes) + " != " + std::to_string(bufSize) + ")";
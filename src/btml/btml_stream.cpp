@@ -1,6 +1,10 @@
 #include <btml/btml_stream.h>
 #include <cfg/cfg.h>
+#include <cfg/cfg_schema_validator.h>
+#include <algorithm>
+#include <cstring>
 #include <map>
+#include <memory>
 //#include <iostream>
 
 namespace cfg
@@ -23,6 +27,14 @@ namespace cfg
 			uint16_t value;
 			uint8_t array[2];
 		};
+		union DoubleAsBytes {
+			double value;
+			uint8_t array[8];
+		};
+		union Int64AsBytes {
+			int64_t value;
+			uint8_t array[8];
+		};
 
 		union FloatAsUint32 {
 			float fp;
@@ -249,9 +261,133 @@ namespace cfg
 			return static_cast<unsigned int>(s - start);
 		}
 
+		bool isLittleEndianHost()
+		{
+			const uint16_t one = 1;
+			uint8_t firstByte = 0;
+			memcpy(&firstByte, &one, 1);
+			return firstByte == 1;
+		}
+
+		// swap the bytes of each element of size elementSize
+		void swapElementBytes(uint8_t* data, std::size_t len, std::size_t elementSize)
+		{
+			for (std::size_t i = 0; i < len; i += elementSize) {
+				std::reverse(data + i, data + i + elementSize);
+			}
+		}
+
+		// append the elements as little endian (a block copy on a little endian host)
+		template <typename T>
+		std::size_t pushLittleEndian(const std::vector<T>& elements, std::vector<uint8_t>& s)
+		{
+			std::size_t len = elements.size() * sizeof(T);
+			if (!len) {
+				return 0;
+			}
+			std::size_t start = s.size();
+			s.resize(start + len);
+			memcpy(&s[start], elements.data(), len);
+			if (!isLittleEndianHost()) {
+				swapElementBytes(&s[start], len, sizeof(T));
+			}
+			return len;
+		}
+
+		// read count little endian elements
+		template <typename T>
+		std::size_t readLittleEndian(const uint8_t* data, uint32_t count,
+				std::vector<T>& outElements)
+		{
+			outElements.resize(count);
+			std::size_t len = count * sizeof(T);
+			if (!len) {
+				return 0;
+			}
+			uint8_t* dest = reinterpret_cast<uint8_t*>(outElements.data());
+			memcpy(dest, data, len);
+			if (!isLittleEndianHost()) {
+				swapElementBytes(dest, len, sizeof(T));
+			}
+			return len;
+		}
+
+		// return count of added bytes
+		unsigned int packedArrayToStream(const PackedArray& packed,
+				std::vector<uint8_t>& s)
+		{
+			unsigned int bytes = 2;
+			s.push_back(uint8_t(0x20 | Value::TYPE_ARRAY)); // flag for "packed array"
+			s.push_back(uint8_t(packed.mElementType));
+			bytes += pushLength(s, uint32_t(packed.size()));
+			std::size_t len = 0;
+			switch (packed.mElementType) {
+				case Value::TYPE_INT:
+					len = pushLittleEndian(packed.mIntegers, s);
+					break;
+				case Value::TYPE_FLOAT:
+					len = pushLittleEndian(packed.mFloats, s);
+					break;
+				case Value::TYPE_DOUBLE:
+					len = pushLittleEndian(packed.mDoubles, s);
+					break;
+				default:
+					break;
+			}
+			return bytes + static_cast<unsigned int>(len);
+		}
+
 		// return count of used bytes, 0 for error
+		// s[0] is the type byte of the packed array
+		unsigned int bytesToPackedArray(const uint8_t* s, unsigned int n,
+				Value& cfgValue)
+		{
+			if (n < 3) {
+				return 0;
+			}
+			Value::EValueType elementType = static_cast<Value::EValueType>(s[1]);
+			std::size_t elementSize = 0;
+			switch (elementType) {
+				case Value::TYPE_INT:
+				case Value::TYPE_FLOAT:
+					elementSize = 4;
+					break;
+				case Value::TYPE_DOUBLE:
+					elementSize = 8;
+					break;
+				default:
+					return 0;
+			}
+			uint32_t count = 0;
+			unsigned int bytes = getLength(s + 2, n - 2, count);
+			if (!bytes) {
+				return 0;
+			}
+			bytes += 2; // for type byte and element type byte
+			if ((n - bytes) / elementSize < count) {
+				return 0;
+			}
+			const uint8_t* data = s + bytes;
+			std::unique_ptr<PackedArray> packed(new PackedArray());
+			packed->mElementType = elementType;
+			std::size_t len = 0;
+			if (elementType == Value::TYPE_INT) {
+				len = readLittleEndian(data, count, packed->mIntegers);
+			}
+			else if (elementType == Value::TYPE_FLOAT) {
+				len = readLittleEndian(data, count, packed->mFloats);
+			}
+			else {
+				len = readLittleEndian(data, count, packed->mDoubles);
+			}
+			cfgValue.setPackedArray(std::move(packed));
+			return bytes + static_cast<unsigned int>(len);
+		}
+
+		// return count of used bytes, 0 for error
+		// packArrays: see ValueParser::setPackNumericArrays()
 		unsigned int bytesToValue(const uint8_t* s, unsigned int n,
-				Value& cfgValue, const uint8_t* stringTable)
+				Value& cfgValue, const uint8_t* stringTable, bool packArrays = false)
 		{
 			if (!n) {
 				return 0;
@@ -288,6 +424,24 @@ namespace cfg
 					cfgValue.setInteger(f.intVal);
 					return 5;
 				}
+				case Value::TYPE_INT64: {
+					if (n < 9) {
+						return 0;
+					}
+					int64_t intVal;
+					memcpy(&intVal, s + 1, sizeof(intVal));
+					cfgValue.setInteger64(intVal);
+					return 9;
+				}
+				case Value::TYPE_DOUBLE: {
+					if (n < 9) {
+						return 0;
+					}
+					double fp;
+					memcpy(&fp, s + 1, sizeof(fp));
+					cfgValue.setDouble(fp);
+					return 9;
+				}
 				case Value::TYPE_TEXT:
 				case Value::TYPE_COMMENT: {
 					if (n < 3) {
@@ -353,6 +507,9 @@ namespace cfg
 					if (n < 2) {
 						return 0;
 					}
+					if (s[0] & 0x20) {
+						return bytesToPackedArray(s, n, cfgValue);
+					}
 					uint32_t count = 0;
 					unsigned int bytes = getLength(s + 1, n - 1, count);
 					if (!bytes) {
@@ -361,10 +518,29 @@ namespace cfg
 					++bytes; // for TYPE_ARRAY byte
 					s += bytes;
 					n -= bytes;
+					if (packArrays) {
+						// the numbers are packed while they are read
+						ArrayBuilder builder(cfgValue, count, true);
+						Value element;
+						for (uint32_t i = 0; i < count; ++i) {
+							unsigned int nextBytes = bytesToValue(s, n, element, stringTable,
+									packArrays);
+							if (!nextBytes) {
+								return 0;
+							}
+							builder.add(std::move(element));
+							bytes += nextBytes;
+							s += nextBytes;
+							n -= nextBytes;
+						}
+						builder.finish();
+						return bytes;
+					}
 					cfgValue.setArray();
 					cfgValue.mArray.resize(count);
 					for (uint32_t i = 0; i < count; ++i) {
-						unsigned int nextBytes = bytesToValue(s, n, cfgValue.mArray[i], stringTable);
+						unsigned int nextBytes = bytesToValue(s, n, cfgValue.mArray[i], stringTable,
+								packArrays);
 						if (!nextBytes) {
 							return 0;
 						}
@@ -396,7 +572,8 @@ namespace cfg
 						bytes += nextBytes;
 						s += nextBytes;
 						n -= nextBytes;
-						nextBytes = bytesToValue(s, n, cfgValue.mObject[i].mValue, stringTable);
+						nextBytes = bytesToValue(s, n, cfgValue.mObject[i].mValue, stringTable,
+								packArrays);
 						if (!nextBytes) {
 							return 0;
 						}
@@ -410,6 +587,198 @@ namespace cfg
 			return 0; // should not be possible
 		}
 
+		/**
+		 * Return count of bytes of the value at s without creating the
+		 * value (e.g. to skip it). 0 for error.
+		 */
+		unsigned int getValueSize(const uint8_t* s, unsigned int n,
+				const uint8_t* stringTable)
+		{
+			if (!n) {
+				return 0;
+			}
+			unsigned int bytes = 0;
+			switch (static_cast<Value::EValueType>(s[0] & 0x0f)) {
+				case Value::TYPE_NONE:
+				case Value::TYPE_NULL:
+					bytes = 1;
+					break;
+				case Value::TYPE_BOOL:
+					bytes = 2;
+					break;
+				case Value::TYPE_FLOAT:
+				case Value::TYPE_INT:
+					bytes = 5;
+					break;
+				case Value::TYPE_INT64:
+				case Value::TYPE_DOUBLE:
+					bytes = 9;
+					break;
+				case Value::TYPE_TEXT:
+				case Value::TYPE_COMMENT: {
+					if (n < 3) {
+						return 0;
+					}
+					if (stringTable && s[1] == 0) {
+						bytes = 4; // 1 (type) + 1 (ref marker 0) + 2 (offset)
+						break;
+					}
+					uint32_t len = 0;
+					unsigned int lenBytes = getLength(s + 1, n - 1, len);
+					if (!lenBytes || n - 1 - lenBytes < len) {
+						return 0;
+					}
+					bytes = 1 + lenBytes + len;
+					break;
+				}
+				case Value::TYPE_ARRAY:
+				case Value::TYPE_OBJECT: {
+					bool isPacked = (s[0] & 0x20) != 0;
+					unsigned int headerBytes = isPacked ? 2 : 1;
+					if (n <= headerBytes) {
+						return 0;
+					}
+					uint32_t count = 0;
+					unsigned int countBytes = getLength(s + headerBytes, n - headerBytes, count);
+					if (!countBytes) {
+						return 0;
+					}
+					bytes = headerBytes + countBytes;
+					if (isPacked) {
+						// the size of the elements is stored by the element type
+						uint32_t elementSize = (s[1] == Value::TYPE_DOUBLE) ? 8 : 4;
+						if ((n - bytes) / elementSize < count) {
+							return 0;
+						}
+						bytes += count * elementSize;
+						break;
+					}
+					if (static_cast<Value::EValueType>(s[0] & 0x0f) == Value::TYPE_OBJECT) {
+						count *= 2; // name and value of each pair
+					}
+					for (uint32_t i = 0; i < count; ++i) {
+						unsigned int nextBytes = getValueSize(s + bytes, n - bytes, stringTable);
+						if (!nextBytes) {
+							return 0;
+						}
+						bytes += nextBytes;
+					}
+					break;
+				}
+			}
+			return (bytes <= n) ? bytes : 0;
+		}
+
+		/**
+		 * Same as bytesToValue() for an object but only the pairs with a
+		 * name of projection are converted. The values of the other pairs
+		 * are skipped by getValueSize().
+		 */
+		unsigned int bytesToProjectedObject(const uint8_t* s, unsigned int n,
+				Value& cfgValue, const uint8_t* stringTable,
+				const std::set<std::string>& projection, bool packArrays)
+		{
+			if (n < 2 || static_cast<Value::EValueType>(s[0] & 0x0f) != Value::TYPE_OBJECT) {
+				return 0;
+			}
+			uint32_t count = 0;
+			unsigned int bytes = getLength(s + 1, n - 1, count);
+			if (!bytes) {
+				return 0;
+			}
+			++bytes; // for TYPE_OBJECT byte
+			s += bytes;
+			n -= bytes;
+			cfgValue.setObject();
+			NameValuePair nvp;
+			for (uint32_t i = 0; i < count; ++i) {
+				unsigned int nextBytes = bytesToValue(s, n, nvp.mName, stringTable);
+				if (!nextBytes) {
+					return 0;
+				}
+				bytes += nextBytes;
+				s += nextBytes;
+				n -= nextBytes;
+				bool isSelected = nvp.mName.isText() && projection.count(nvp.mName.mText);
+				if (isSelected) {
+					nextBytes = bytesToValue(s, n, nvp.mValue, stringTable, packArrays);
+				}
+				else {
+					nextBytes = getValueSize(s, n, stringTable);
+				}
+				if (!nextBytes) {
+					return 0;
+				}
+				bytes += nextBytes;
+				s += nextBytes;
+				n -= nextBytes;
+				if (isSelected) {
+					cfgValue.mObject.push_back(std::move(nvp));
+				}
+			}
+			return bytes;
+		}
+
+		/**
+		 * Same as bytesToValue() for an object but the members are
+		 * passed to the validator (objects with streamBeginObject() ...
+		 * streamEndObject()) instead of building the object.
+		 * @param stopped Is set to true if the validation is stopped
+		 *        because of stopAtFirstViolation.
+		 * @return Count of used bytes. 0 for error or stopped.
+		 */
+		unsigned int bytesToValidator(const uint8_t* s, unsigned int n,
+				SchemaValidator& validator, const uint8_t* stringTable,
+				bool stopAtFirstViolation, std::string& outErrorMsg,
+				bool& stopped)
+		{
+			if (n < 2 || static_cast<Value::EValueType>(s[0] & 0x0f) != Value::TYPE_OBJECT) {
+				return 0;
+			}
+			uint32_t count = 0;
+			unsigned int bytes = getLength(s + 1, n - 1, count);
+			if (!bytes) {
+				return 0;
+			}
+			++bytes; // for TYPE_OBJECT byte
+			s += bytes;
+			n -= bytes;
+			NameValuePair nvp;
+			for (uint32_t i = 0; i < count; ++i) {
+				unsigned int nextBytes = bytesToValue(s, n, nvp.mName, stringTable);
+				if (!nextBytes) {
+					return 0;
+				}
+				bytes += nextBytes;
+				s += nextBytes;
+				n -= nextBytes;
+				if (n > 0 && static_cast<Value::EValueType>(s[0] & 0x0f) == Value::TYPE_OBJECT) {
+					validator.streamBeginObject(nvp.mName, outErrorMsg);
+					nextBytes = bytesToValidator(s, n, validator, stringTable,
+							stopAtFirstViolation, outErrorMsg, stopped);
+					if (!nextBytes) {
+						return 0;
+					}
+					validator.streamEndObject(outErrorMsg);
+				}
+				else {
+					nextBytes = bytesToValue(s, n, nvp.mValue, stringTable);
+					if (!nextBytes) {
+						return 0;
+					}
+					validator.streamNameValuePair(nvp, outErrorMsg);
+				}
+				bytes += nextBytes;
+				s += nextBytes;
+				n -= nextBytes;
+				if (stopAtFirstViolation && validator.getViolationCount()) {
+					stopped = true;
+					return 0;
+				}
+			}
+			return bytes;
+		}
+
 		unsigned int valueToStreamOptStringTable(const Value& cfgValue,
 				std::vector<uint8_t>& s, const TStringTableByString* stringTable)
 		{
@@ -444,6 +813,20 @@ namespace cfg
 					s.push_back(intVal.array[3]);
 					return 5;
 				}
+				case Value::TYPE_INT64: {
+					s.push_back(uint8_t(Value::TYPE_INT64));
+					Int64AsBytes intVal;
+					intVal.value = cfgValue.mInteger64;
+					s.insert(s.end(), intVal.array, intVal.array + 8);
+					return 9;
+				}
+				case Value::TYPE_DOUBLE: {
+					s.push_back(uint8_t(Value::TYPE_DOUBLE));
+					DoubleAsBytes fp;
+					fp.value = cfgValue.mDouble;
+					s.insert(s.end(), fp.array, fp.array + 8);
+					return 9;
+				}
 				case Value::TYPE_TEXT:
 				case Value::TYPE_COMMENT: {
 					unsigned int bytes = 1;
@@ -478,6 +861,9 @@ namespace cfg
 					return bytes + static_cast<unsigned int>(len);
 				}
 				case Value::TYPE_ARRAY: {
+					if (cfgValue.isPackedArray()) {
+						return packedArrayToStream(*cfgValue.mPackedArray, s);
+					}
 					unsigned int bytes = 1;
 					s.push_back(uint8_t(Value::TYPE_ARRAY));
 					std::size_t cnt = cfgValue.mArray.size();
@@ -532,14 +918,14 @@ unsigned int cfg::btmlstream::valueToStreamWithHeader(const Value& cfgValue,
 }
 
 unsigned int cfg::btmlstream::streamToValue(const void* stream, unsigned int n,
-		Value& cfgValue, std::string* errMsg)
+		Value& cfgValue, std::string* errMsg, bool packNumericArrays)
 {
 	cfgValue.clear();
 	if (!stream || !n) {
 		return 0;
 	}
 	const uint8_t* s = static_cast<const uint8_t*>(stream);
-	unsigned int rv = bytesToValue(s, n, cfgValue, nullptr);
+	unsigned int rv = bytesToValue(s, n, cfgValue, nullptr, packNumericArrays);
 	if (!rv && errMsg) {
 		*errMsg += "bytesToValue() failed\n";
 	}
@@ -549,7 +935,7 @@ unsigned int cfg::btmlstream::streamToValue(const void* stream, unsigned int n,
 unsigned int cfg::btmlstream::streamToValueWithHeader(const void* stream,
 		unsigned int n, Value& cfgValue, std::string* errMsg,
 		bool& stringTableExist, unsigned int& stringTableEntryCount,
-		unsigned int& stringTableSize)
+		unsigned int& stringTableSize, bool packNumericArrays)
 {
 	stringTableExist = false;
 	stringTableEntryCount = 0;
@@ -590,7 +976,8 @@ unsigned int cfg::btmlstream::streamToValueWithHeader(const void* stream,
 		stringTableEntryCount = entryCount;
 		stringTableSize = tableSize;
 	}
-	unsigned int rv = bytesToValue(s + 6 + tableSize, n - 6 - tableSize, cfgValue, stringTable);
+	unsigned int rv = bytesToValue(s + 6 + tableSize, n - 6 - tableSize, cfgValue, stringTable,
+			packNumericArrays);
 	if (!rv) {
 		return 0;
 	}
@@ -614,7 +1001,8 @@ unsigned int cfg::btmlstream::streamToValueWithOptionalHeader(
 unsigned int cfg::btmlstream::streamToValueWithOptionalHeader(
 		const void* stream, unsigned int n, Value& cfgValue,
 		std::string* errMsg, bool& headerExist, bool& stringTableExist,
-		unsigned int& stringTableEntryCount, unsigned int& stringTableSize)
+		unsigned int& stringTableEntryCount, unsigned int& stringTableSize,
+		bool packNumericArrays)
 {
 	headerExist = false;
 	stringTableExist = false;
@@ -626,9 +1014,119 @@ unsigned int cfg::btmlstream::streamToValueWithOptionalHeader(
 	if (useHeaderVersion) {
 		headerExist = true;
 		return streamToValueWithHeader(stream, n, cfgValue, errMsg,
-				stringTableExist, stringTableEntryCount, stringTableSize);
+				stringTableExist, stringTableEntryCount, stringTableSize,
+				packNumericArrays);
 	}
 	else {
-		return streamToValue(stream, n, cfgValue, errMsg);
+		return streamToValue(stream, n, cfgValue, errMsg, packNumericArrays);
+	}
+}
+
+unsigned int cfg::btmlstream::streamToProjectedValueWithOptionalHeader(
+		const void* stream, unsigned int n, Value& cfgValue,
+		const std::set<std::string>& projection, std::string* errMsg,
+		bool packNumericArrays)
+{
+	cfgValue.clear();
+	if (!stream || !n) {
+		return 0;
+	}
+	const uint8_t* s = static_cast<const uint8_t*>(stream);
+	unsigned int headerSize = 0;
+	const uint8_t* stringTable = nullptr;
+	bool useHeaderVersion = (n >= 6 && s[0] == 'b' && s[1] == 't' && s[2] == 'm' && s[3] == 'l');
+	if (useHeaderVersion) {
+		if (s[4] != 1 || (s[5] != 0 && s[5] != 1)) {
+			// only version 1 is supported and only 0 or 1 is allowed for string table
+			if (errMsg) {
+				*errMsg += "Wrong header.\n";
+			}
+			return 0;
+		}
+		headerSize = 6;
+		if (s[5] == 1) {
+			if (n < 8) {
+				return 0;
+			}
+			stringTable = s;
+			unsigned int entryCount = 0;
+			unsigned int tableSize = loadStringTable(s + 6, n - 6, nullptr,
+					errMsg, entryCount);
+			if (!tableSize) {
+				if (errMsg) {
+					*errMsg += "Can't load string table.\n";
+				}
+				return 0;
+			}
+			headerSize += tableSize;
+		}
+	}
+	if (n <= headerSize) {
+		return 0;
+	}
+	unsigned int rv = bytesToProjectedObject(s + headerSize, n - headerSize,
+			cfgValue, stringTable, projection, packNumericArrays);
+	if (!rv) {
+		cfgValue.clear();
+		if (errMsg) {
+			*errMsg += "bytesToProjectedObject() failed (the root value must be an object)\n";
+		}
+		return 0;
+	}
+	return rv + headerSize;
+}
+
+unsigned int cfg::btmlstream::streamToValidatorWithOptionalHeader(
+		const void* stream, unsigned int n, SchemaValidator& validator,
+		bool stopAtFirstViolation, std::string& outErrorMsg)
+{
+	outErrorMsg.clear();
+	validator.beginStream();
+	if (!stream || !n) {
+		return 0;
+	}
+	const uint8_t* s = static_cast<const uint8_t*>(stream);
+	unsigned int headerSize = 0;
+	const uint8_t* stringTable = nullptr;
+	bool useHeaderVersion = (n >= 6 && s[0] == 'b' && s[1] == 't' && s[2] == 'm' && s[3] == 'l');
+	if (useHeaderVersion) {
+		if (s[4] != 1 || (s[5] != 0 && s[5] != 1)) {
+			// only version 1 is supported and only 0 or 1 is allowed for string table
+			outErrorMsg += "Wrong header.\n";
+			return 0;
+		}
+		headerSize = 6;
+		if (s[5] == 1) {
+			if (n < 8) {
+				return 0;
+			}
+			stringTable = s;
+			unsigned int entryCount = 0;
+			unsigned int tableSize = loadStringTable(s + 6, n - 6, nullptr,
+					&outErrorMsg, entryCount);
+			if (!tableSize) {
+				outErrorMsg += "Can't load string table.\n";
+				return 0;
+			}
+			headerSize += tableSize;
+		}
+	}
+	if (n <= headerSize ||
+			static_cast<Value::EValueType>(s[headerSize] & 0x0f) != Value::TYPE_OBJECT) {
+		outErrorMsg += "value must be an object\n";
+		return 0;
+	}
+	bool stopped = false;
+	unsigned int rv = bytesToValidator(s + headerSize, n - headerSize, validator,
+			stringTable, stopAtFirstViolation, outErrorMsg, stopped);
+	if (!rv) {
+		if (!stopped) {
+			outErrorMsg += "bytesToValidator() failed\n";
+		}
+		return 0;
+	}
+	if (!validator.endStream(outErrorMsg)) {
+		return 0;
 	}
+	return rv + headerSize;
 }
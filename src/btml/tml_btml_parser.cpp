@@ -80,6 +80,20 @@ std::string cfg::TmlBtmlParser::getExtendedErrorMsg() const
 	return mFilename + ":" + mErrorMsg;
 }
 
+void cfg::TmlBtmlParser::setPackNumericArrays(bool enable)
+{
+	ValueParser::setPackNumericArrays(enable);
+	mTmlParser.setPackNumericArrays(enable);
+	mBtmlParser.setPackNumericArrays(enable);
+}
+
+void cfg::TmlBtmlParser::setProjection(const std::vector<std::string>& topLevelNames)
+{
+	ValueParser::setProjection(topLevelNames);
+	mTmlParser.setProjection(topLevelNames);
+	mBtmlParser.setProjection(topLevelNames);
+}
+
 int cfg::TmlBtmlParser::getParserSelectionForFilename(
 		const std::string& filename, std::string& outErrorMsg)
 {
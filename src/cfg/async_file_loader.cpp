@@ -0,0 +1,191 @@
+#include <cfg/async_file_loader.h>
+#include <fstream>
+
+namespace cfg
+{
+	namespace
+	{
+		bool readFileContent(const std::string& filename, std::string& outContent)
+		{
+			std::ifstream ifs(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+			if (!ifs.is_open() || ifs.fail()) {
+				return false;
+			}
+			ifs.seekg(0, std::ifstream::end);
+			std::streamoff size = ifs.tellg();
+			ifs.seekg(0, std::ifstream::beg);
+			if (size < 0 || ifs.fail()) {
+				return false;
+			}
+			outContent.resize(static_cast<std::size_t>(size));
+			if (size > 0) {
+				ifs.read(&outContent[0], size);
+			}
+			return !ifs.fail();
+		}
+	}
+}
+
+cfg::AsyncFileLoader::AsyncFileLoader(std::unique_ptr<ValueParser> parser,
+		const std::string& includeKeyword, unsigned int ioThreadCount)
+	:ParserFileLoader(std::move(parser)),
+	mIncludeKeyword(includeKeyword),
+	mIoThreadCount(ioThreadCount ? ioThreadCount : 1)
+{
+}
+
+cfg::AsyncFileLoader::~AsyncFileLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopThreads = true;
+	}
+	mQueueCondition.notify_all();
+	for (std::thread& t : mIoThreads) {
+		t.join();
+	}
+}
+
+void cfg::AsyncFileLoader::reset()
+{
+	ParserFileLoader::reset();
+	std::lock_guard<std::mutex> lock(mMutex);
+	// Requests which are read at the moment are still referenced by
+	// the I/O threads (shared_ptr). Their content is dropped.
+	mQueue.clear();
+	mRequests.clear();
+	mReadAheadHitCount = 0;
+}
+
+bool cfg::AsyncFileLoader::loadAndPush(Value& outValue, std::string& outFullFilename,
+		const std::string& includeFilename, bool inclEmptyLines,
+		bool inclComments, std::string& outErrorMsg)
+{
+	if (!ParserFileLoader::loadAndPush(outValue, outFullFilename,
+			includeFilename, inclEmptyLines, inclComments, outErrorMsg)) {
+		return false;
+	}
+	// After the push the current directory is the directory of the
+	// loaded file --> getFullFilename() is correct for its includes.
+	readAheadIncludes(outValue);
+	return true;
+}
+
+bool cfg::AsyncFileLoader::pop()
+{
+	if (!ParserFileLoader::pop()) {
+		return false;
+	}
+	if (getNestedDeep() == 0) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		// same as reset(): requests which are read at the moment are
+		// freed by the I/O threads
+		mQueue.clear();
+		mRequests.clear();
+	}
+	return true;
+}
+
+void cfg::AsyncFileLoader::readAhead(const std::string& fullFilename)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mRequests.find(fullFilename) != mRequests.end()) {
+			return; // already requested
+		}
+		ReadRequestPtr request = std::make_shared<ReadRequest>();
+		request->mFullFilename = fullFilename;
+		mRequests[fullFilename] = request;
+		mQueue.push_back(request);
+		// threads are started at the first request
+		if (mIoThreads.empty()) {
+			for (unsigned int i = 0; i < mIoThreadCount; ++i) {
+				mIoThreads.emplace_back(&AsyncFileLoader::ioThreadLoop, this);
+			}
+		}
+	}
+	mQueueCondition.notify_one();
+}
+
+bool cfg::AsyncFileLoader::parseFile(Value& outValue, const std::string& fullFilename,
+		bool inclEmptyLines, bool inclComments, std::string& outErrorMsg)
+{
+	ReadRequestPtr request;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		auto it = mRequests.find(fullFilename);
+		if (it != mRequests.end()) {
+			request = it->second;
+			mRequests.erase(it);
+			if (request->mState == EReadState::QUEUED) {
+				// not started yet --> no waiting. Read it here (as usual).
+				request->mState = EReadState::TAKEN;
+				request.reset();
+			}
+			else {
+				mDoneCondition.wait(lock, [&request]() {
+					return request->mState == EReadState::DONE;
+				});
+			}
+		}
+	}
+	if (!request || !request->mSuccess ||
+			!mParser->setStringBuffer(fullFilename, request->mContent)) {
+		return ParserFileLoader::parseFile(outValue, fullFilename,
+				inclEmptyLines, inclComments, outErrorMsg);
+	}
+	// content isn't needed any more (setStringBuffer() has a copy)
+	request.reset();
+	if (!mParser->getAsTree(outValue, inclEmptyLines, inclComments)) {
+		outErrorMsg = mParser->getExtendedErrorMsg();
+		mParser->reset();
+		outValue.clear();
+		return false;
+	}
+	mParser->reset();
+	++mReadAheadHitCount;
+	return true;
+}
+
+void cfg::AsyncFileLoader::readAheadIncludes(const Value& value)
+{
+	for (const NameValuePair& nvp : value.mObject) {
+		if (nvp.mName.isArray() && nvp.mName.mArray.size() >= 2 &&
+				nvp.mName.mArray[0].mText == mIncludeKeyword &&
+				!nvp.mName.mArray[1].mText.empty()) {
+			readAhead(getFullFilename(nvp.mName.mArray[1].mText));
+		}
+		if (nvp.mValue.isObject()) {
+			readAheadIncludes(nvp.mValue);
+		}
+	}
+}
+
+void cfg::AsyncFileLoader::ioThreadLoop()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mQueueCondition.wait(lock, [this]() {
+			return mStopThreads || !mQueue.empty();
+		});
+		if (mStopThreads) {
+			return;
+		}
+		ReadRequestPtr request = mQueue.front();
+		mQueue.pop_front();
+		if (request->mState != EReadState::QUEUED) {
+			continue; // already taken by the loader
+		}
+		request->mState = EReadState::READING;
+
+		lock.unlock();
+		std::string content;
+		bool success = readFileContent(request->mFullFilename, content);
+		lock.lock();
+
+		request->mContent = std::move(content);
+		request->mSuccess = success;
+		request->mState = EReadState::DONE;
+		mDoneCondition.notify_all();
+	}
+}
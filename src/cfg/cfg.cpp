@@ -1,4 +1,6 @@
 #include <cfg/cfg.h>
+#include <algorithm>
+#include <climits>
 #include <cmath>
 #include <string.h>
 
@@ -6,6 +8,223 @@ namespace cfg
 {
 	namespace
 	{
+		int clampToInt(int64_t value)
+		{
+			if (value < INT_MIN) {
+				return INT_MIN;
+			}
+			if (value > INT_MAX) {
+				return INT_MAX;
+			}
+			return static_cast<int>(value);
+		}
+
+		// round up/down at .5 (same as for mInteger) and clamp to the
+		// range of int64_t
+		int64_t roundToInt64(double value)
+		{
+			if (std::isnan(value)) {
+				return 0;
+			}
+			value += (value >= 0.0) ? 0.5 : -0.5;
+			if (value <= static_cast<double>(INT64_MIN)) {
+				return INT64_MIN;
+			}
+			if (value >= static_cast<double>(INT64_MAX)) {
+				return INT64_MAX;
+			}
+			return static_cast<int64_t>(value);
+		}
+
+		bool isTextName(const Value& name, const char* text, std::size_t length)
+		{
+			return name.mType == Value::TYPE_TEXT && name.mText.size() == length &&
+					memcmp(name.mText.data(), text, length) == 0;
+		}
+
+		// return nullptr if none or more than one pair with this name exist
+		const NameValuePair* getUniquePair(const std::vector<NameValuePair>& pairs,
+				const char* name, std::size_t length)
+		{
+			const NameValuePair* valuePair = nullptr;
+			for (const NameValuePair& nvp : pairs) {
+				if (!isTextName(nvp.mName, name, length)) {
+					continue;
+				}
+				if (valuePair) {
+					return nullptr;
+				}
+				valuePair = &nvp;
+			}
+			return valuePair;
+		}
+
+		int getFirstPairIndex(const std::vector<NameValuePair>& pairs,
+				const char* name, std::size_t length)
+		{
+			std::size_t pairCount = pairs.size();
+			for (std::size_t i = 0; i < pairCount; i++) {
+				if (isTextName(pairs[i].mName, name, length)) {
+					return static_cast<int>(i);
+				}
+			}
+			return -1;
+		}
+
+		// type checks of the objectGet...() functions (value can be nullptr)
+		bool getText(const Value* value, std::string& outText)
+		{
+			if (!value || value->mType != Value::TYPE_TEXT) {
+				return false;
+			}
+			outText = value->mText;
+			return true;
+		}
+
+		bool getInteger(const Value* value, int& outInteger)
+		{
+			if (!value || value->mType != Value::TYPE_INT) {
+				return false;
+			}
+			outInteger = value->mInteger;
+			return true;
+		}
+
+		bool getFloat(const Value* value, bool allowInteger, float& outFloat)
+		{
+			if (!value) {
+				return false;
+			}
+			if (value->mType != Value::TYPE_FLOAT && value->mType != Value::TYPE_DOUBLE &&
+					(!allowInteger || (value->mType != Value::TYPE_INT &&
+					value->mType != Value::TYPE_INT64))
+					) {
+				return false;
+			}
+			// if it is an integer then the floating point member also has the correct value
+			outFloat = value->mFloatingPoint;
+			return true;
+		}
+
+		bool getBool(const Value* value, bool& outBool)
+		{
+			if (!value || value->mType != Value::TYPE_BOOL) {
+				return false;
+			}
+			outBool = value->mBool;
+			return true;
+		}
+
+		unsigned int getTypeBit(Value::EValueType type)
+		{
+			return 1u << static_cast<unsigned int>(type);
+		}
+
+		unsigned int getFloatTypeMask(bool allowInteger)
+		{
+			unsigned int mask = getTypeBit(Value::TYPE_FLOAT) |
+					getTypeBit(Value::TYPE_DOUBLE);
+			if (allowInteger) {
+				mask |= getTypeBit(Value::TYPE_INT) | getTypeBit(Value::TYPE_INT64);
+			}
+			return mask;
+		}
+
+		// An int64 is only stored by an int or uint rule if it fits into
+		// the type of the rule (negative numbers are stored as 0 by an
+		// uint rule). Other values always fit.
+		bool fitsIntoRule(const SelectRule& rule, const Value& value)
+		{
+			if (!value.isInteger64()) {
+				return true;
+			}
+			if (rule.mType == SelectRule::TYPE_INT) {
+				return value.mInteger64 >= INT_MIN && value.mInteger64 <= INT_MAX;
+			}
+			if (rule.mType == SelectRule::TYPE_UINT) {
+				return value.mInteger64 <= UINT_MAX;
+			}
+			return true;
+		}
+
+		// return true if value is an array and each element has a type of typeMask
+		bool isArrayOfTypes(const Value& value, unsigned int typeMask)
+		{
+			if (!value.isArray()) {
+				return false;
+			}
+			if (value.isPackedArray()) {
+				return (getTypeBit(value.mPackedArray->mElementType) & typeMask) != 0;
+			}
+			for (const Value& element : value.mArray) {
+				if (!(getTypeBit(element.mType) & typeMask)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * The type check is done before the copy. Therefore the copy loop
+		 * has no branches and nothing is copied if an element has a wrong
+		 * type.
+		 */
+		template <typename T, typename GetNumber>
+		bool copyArrayNumbers(const Value& value, unsigned int typeMask,
+				T* outValues, std::size_t maxCount, std::size_t& outCount,
+				GetNumber getNumber)
+		{
+			outCount = 0;
+			if (!isArrayOfTypes(value, typeMask) || value.arraySize() > maxCount) {
+				return false;
+			}
+			if (value.isPackedArray()) {
+				// a block copy (with conversion if the types are different)
+				const PackedArray& packed = *value.mPackedArray;
+				switch (packed.mElementType) {
+					case Value::TYPE_INT:
+						std::copy(packed.mIntegers.begin(), packed.mIntegers.end(), outValues);
+						break;
+					case Value::TYPE_FLOAT:
+						std::copy(packed.mFloats.begin(), packed.mFloats.end(), outValues);
+						break;
+					case Value::TYPE_DOUBLE:
+						std::copy(packed.mDoubles.begin(), packed.mDoubles.end(), outValues);
+						break;
+					default:
+						return false;
+				}
+				outCount = packed.size();
+				return true;
+			}
+			std::size_t count = value.mArray.size();
+			const Value* elements = value.mArray.data();
+			for (std::size_t i = 0; i < count; ++i) {
+				outValues[i] = getNumber(elements[i]);
+			}
+			outCount = count;
+			return true;
+		}
+
+		template <typename T, typename GetNumber>
+		bool copyArrayNumbers(const Value& value, unsigned int typeMask,
+				std::vector<T>& outValues, GetNumber getNumber)
+		{
+			if (!isArrayOfTypes(value, typeMask)) {
+				outValues.clear();
+				return false;
+			}
+			outValues.resize(value.arraySize());
+			std::size_t count = 0;
+			return copyArrayNumbers(value, typeMask, outValues.data(), outValues.size(),
+					count, getNumber);
+		}
+
+		float getElementFloat(const Value& value) { return value.mFloatingPoint; }
+		double getElementDouble(const Value& value) { return value.getDouble(); }
+		int getElementInteger(const Value& value) { return value.mInteger; }
+		int64_t getElementInteger64(const Value& value) { return value.getInteger64(); }
+
 		// return -1 for not found or not allowed
 		int getRuleIndex(const std::string& ruleName, std::size_t curRuleIndex,
 				const SelectRule* rules, std::size_t rulesSize,
@@ -37,6 +256,371 @@ namespace cfg
 			}
 			return -1; // no rule found
 		}
+
+		// FNV-1a
+		unsigned int getNameHash(const std::string& name)
+		{
+			unsigned int hash = 2166136261u;
+			for (char ch : name) {
+				hash ^= static_cast<unsigned char>(ch);
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+
+		void resetRule(const SelectRule& rule, EReset reset)
+		{
+			if (reset == EReset::RESET_NOTHING || !rule.mStorePtr.mPtr) {
+				return;
+			}
+			switch (rule.mType) {
+				case SelectRule::TYPE_UNKNOWN:
+					break;
+				case SelectRule::TYPE_NULL:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						*rule.mStorePtr.mNull = false;
+					}
+					break;
+				case SelectRule::TYPE_BOOL:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						*rule.mStorePtr.mBool = false;
+					}
+					break;
+				case SelectRule::TYPE_FLOAT:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						*rule.mStorePtr.mFloat = 0.0f;
+					}
+					break;
+				case SelectRule::TYPE_DOUBLE:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						*rule.mStorePtr.mDouble = 0.0;
+					}
+					break;
+				case SelectRule::TYPE_INT:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						*rule.mStorePtr.mInt = 0;
+					}
+					break;
+				case SelectRule::TYPE_UINT:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						*rule.mStorePtr.mUInt = 0;
+					}
+					break;
+				case SelectRule::TYPE_INT64:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						*rule.mStorePtr.mInt64 = 0;
+					}
+					break;
+				case SelectRule::TYPE_STRING:
+					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
+						rule.mStorePtr.mStr->clear();
+					}
+					break;
+				case SelectRule::TYPE_ARRAY:
+					*rule.mStorePtr.mArray = nullptr;
+					break;
+				case SelectRule::TYPE_OBJECT:
+					*rule.mStorePtr.mObject = nullptr;
+					break;
+				case SelectRule::TYPE_VALUE:
+					*rule.mStorePtr.mValue = nullptr;
+					break;
+				case SelectRule::TYPE_VALUE_PAIR:
+					*rule.mStorePtr.mValuePair = nullptr;
+					break;
+			}
+		}
+
+		// rule lookup of a not compiled rule array (linear search)
+		struct RuleArrayLookup
+		{
+			const SelectRule* mRules;
+			std::size_t mRulesSize;
+			unsigned int mMustExistCount;
+
+			const SelectRule* getRules() const { return mRules; }
+			std::size_t size() const { return mRulesSize; }
+			unsigned int getMustExistCount() const { return mMustExistCount; }
+			int getRuleIndex(const std::string& ruleName, std::size_t curRuleIndex,
+					bool allowRandomSequence) const
+			{
+				return cfg::getRuleIndex(ruleName, curRuleIndex,
+						mRules, mRulesSize, allowRandomSequence);
+			}
+			int getUnusedMustExistIndex(const std::size_t* usedRuleCounts) const
+			{
+				for (std::size_t ri = 0; ri < mRulesSize; ri++) {
+					if (mRules[ri].mRule == SelectRule::RULE_MUST_EXIST && !usedRuleCounts[ri]) {
+						return static_cast<int>(ri);
+					}
+				}
+				return -1;
+			}
+		};
+
+		/**
+		 * Implementation of objectGet(). RuleLookup is RuleArrayLookup
+		 * or CompiledSelectRules. The rules must be already reset.
+		 * @param usedRuleCounts Array with rules.size() elements which
+		 *        are zero.
+		 */
+		template <typename RuleLookup>
+		int objectGetWithLookup(const std::vector<NameValuePair>& nvpairsOfObject,
+				const RuleLookup& ruleLookup, std::size_t* usedRuleCounts,
+				bool allowRandomSequence, bool allowUnusedValuePairs,
+				bool allowEarlyReturn, bool allowDuplicatedNames,
+				bool allowDuplicatedRuleNamesWithDiffTypes,
+				std::size_t startIndex, std::size_t *outNextIndex,
+				std::string* errMsg, std::string* warnings)
+		{
+			// used for names which are not a text. Otherwise a temporary
+			// string would be created for each name-value pair.
+			static const std::string emptyName;
+
+			const SelectRule* rules = ruleLookup.getRules();
+			const std::size_t rulesSize = ruleLookup.size();
+			const unsigned int finalMustExistCount = ruleLookup.getMustExistCount();
+			unsigned int currentMustExistCount = 0;
+
+			std::size_t pairCount = nvpairsOfObject.size();
+			std::size_t curRuleIndex = 0;
+			std::size_t storeCount = 0;
+
+			std::size_t i = startIndex;
+			bool prevTypeWasWrong = false;
+			for (; storeCount < rulesSize; ++i) {
+				if (prevTypeWasWrong) {
+					--i; // revert the ++i from loop
+				}
+
+				// This check must be made after the prevTypeWasWrong check and
+				// not before in the for-condition.
+				// It's not possible to use i < pairCount in for() instead because
+				// then the logic doesn't work correct if the last name-value pair
+				// has a wrong type. Because then ++i would be equal pairCount -->
+				// loop finished --> --i not executed --> no next rule for wrong type
+				// if last name-value pair has rule with wrong type.
+				if (i >= pairCount) {
+					break;
+				}
+				const NameValuePair& vp = nvpairsOfObject[i];
+
+				if (vp.isEmpty() || vp.isComment()) {
+					// Should never be possible that prevTypeWasWrong is not already false.
+					// But better safe than sorry.
+					prevTypeWasWrong = false;
+					continue;
+				}
+
+				const std::string& vpAttrName =
+						(vp.mName.mType == Value::TYPE_TEXT) ?
+						vp.mName.mText : emptyName;
+
+				// find the correct rule
+				int ri = ruleLookup.getRuleIndex(vpAttrName, curRuleIndex,
+						allowRandomSequence && !prevTypeWasWrong);
+				if (ri < 0) {
+					int riWithRandomSequence = ruleLookup.getRuleIndex(vpAttrName,
+							curRuleIndex, !prevTypeWasWrong);
+
+					// now we can reset prevTypeWasWrong (if it was set). Before its not
+					// possible because getRuleIndex() need this variable!
+					prevTypeWasWrong = false;
+
+					// no rule found for this attr name
+					if (allowUnusedValuePairs) {
+						if (riWithRandomSequence >= 0 && warnings) {
+							*warnings += "attr name '" + vpAttrName +
+									"' has the wrong position/order and is ignored (unused name-value pair).\n";
+						}
+						continue;
+					}
+					if (allowEarlyReturn && finalMustExistCount == currentMustExistCount) {
+						std::size_t ii = i;
+						// here i < pairCount is ok in for() because no --i is possible
+						// in this loop. See for() loop above for more infos.
+						for (; i < pairCount && storeCount < rulesSize; ++i) {
+							const NameValuePair& vp = nvpairsOfObject[i];
+							const std::string& vpAttrName =
+									(vp.mName.mType == Value::TYPE_TEXT) ?
+									vp.mName.mText : emptyName;
+							// allowRandomSequence is here independent of prevTypeWasWrong
+							// no && !prevTypeWasWrong for getRuleIndex.
+							if (ruleLookup.getRuleIndex(vpAttrName, curRuleIndex,
+									allowRandomSequence) >= 0) {
+								if (errMsg) {
+									*errMsg = "rule for attr name '" + vpAttrName + "' is not allowed here";
+								}
+								return -2;
+							}
+							++curRuleIndex; // no problem if out of range because getRuleIndex() check this
+						}
+						if (outNextIndex) {
+							*outNextIndex = ii;
+						}
+						return static_cast<int>(storeCount);
+					}
+					if (errMsg) {
+						if (riWithRandomSequence >= 0) {
+							*errMsg = "attr name '" + vpAttrName + "' has the wrong position/order. Random sequence is not allowed.";
+						}
+						else {
+							*errMsg = "no rule found for attr name '" + vpAttrName + "'";
+						}
+					}
+					return -3;
+				}
+				// now we can reset prevTypeWasWrong (if it was set). Before its not
+				// possible because getRuleIndex() need this variable!
+				prevTypeWasWrong = false;
+
+				curRuleIndex = ri;
+				++usedRuleCounts[curRuleIndex];
+				if (rules[curRuleIndex].mUsedCount) {
+					++*rules[curRuleIndex].mUsedCount;
+				}
+				// check if it was the first time that the rule was used and if the rule must be used
+				if (usedRuleCounts[curRuleIndex] == 1 &&
+						rules[curRuleIndex].mRule == SelectRule::RULE_MUST_EXIST) {
+					++currentMustExistCount;
+				}
+
+				const SelectRule& rule = rules[curRuleIndex];
+				static unsigned int lookup[] = {
+					SelectRule::ALLOW_NONE,   // for Value::TYPE_NONE   = 0
+					SelectRule::ALLOW_NULL,   // for Value::TYPE_NULL   = 1
+					SelectRule::ALLOW_BOOL,   // for Value::TYPE_BOOL   = 2
+					SelectRule::ALLOW_FLOAT,  // for Value::TYPE_FLOAT  = 3
+					SelectRule::ALLOW_INT,    // for Value::TYPE_INT    = 4
+					SelectRule::ALLOW_TEXT,   // for Value::TYPE_TEXT   = 5
+					0, // ALLOW_COMMENT not exist // for Value::TYPE_COMMENT = 6
+					SelectRule::ALLOW_ARRAY,  // for Value::TYPE_ARRAY  = 7
+					SelectRule::ALLOW_OBJECT, // for Value::TYPE_OBJECT = 8
+					SelectRule::ALLOW_INT,    // for Value::TYPE_INT64  = 9
+					SelectRule::ALLOW_FLOAT,  // for Value::TYPE_DOUBLE = 10
+				};
+				bool isTypeAllowed = (rule.mAllowedTypes & lookup[vp.mValue.mType]) != 0;
+				if (!isTypeAllowed || !fitsIntoRule(rule, vp.mValue)) {
+					if (allowDuplicatedRuleNamesWithDiffTypes) {
+						prevTypeWasWrong = true;
+						// revert rule count because this rule was not used (because of wrong type)
+
+						// check if it was the first time that the rule was used and if the rule must be used
+						// then the "current must exist count" must also be reverted
+						if (usedRuleCounts[curRuleIndex] == 1 &&
+								rules[curRuleIndex].mRule == SelectRule::RULE_MUST_EXIST) {
+							--currentMustExistCount;
+						}
+						--usedRuleCounts[curRuleIndex];
+						if (rules[curRuleIndex].mUsedCount) {
+							--*rules[curRuleIndex].mUsedCount;
+						}
+						curRuleIndex++; // no problem if out of range because getRuleIndex() check this
+						continue;
+					}
+					if (errMsg && isTypeAllowed) {
+						*errMsg = "The number " + std::to_string(vp.mValue.mInteger64) +
+								" is out of range for rule '" + vpAttrName + "'";
+					}
+					else if (errMsg) {
+						*errMsg = "Type is not allowed for rule '" + vpAttrName +
+								"'. allowed " + std::to_string(rule.mAllowedTypes) +
+								", lookup " + std::to_string(lookup[vp.mValue.mType]) +
+								", type " + std::to_string(vp.mValue.mType);
+					}
+					return -5;
+				}
+
+				// The duplication check must be here after the type check. Because
+				// if the type is wrong then the rule is not applied and therefore
+				// not duplicated.
+				if (usedRuleCounts[curRuleIndex] > 1) {
+					if (allowDuplicatedNames) {
+						curRuleIndex++; // no problem if out of range because getRuleIndex() check this
+						continue; // ignore duplicates --> jump to next
+					}
+					if (errMsg) {
+						*errMsg = "found duplicated rule for attr name '" + vpAttrName + "'";
+					}
+					return -4;
+				}
+
+				switch (rule.mType) {
+					case SelectRule::TYPE_UNKNOWN:
+						return -1; // unknown is not allowed
+					case SelectRule::TYPE_NULL:
+						*rule.mStorePtr.mNull = true;
+						break;
+					case SelectRule::TYPE_BOOL:
+						*rule.mStorePtr.mBool = vp.mValue.mBool;
+						break;
+					case SelectRule::TYPE_FLOAT:
+						*rule.mStorePtr.mFloat = vp.mValue.mFloatingPoint;
+						break;
+					case SelectRule::TYPE_DOUBLE:
+						*rule.mStorePtr.mDouble = vp.mValue.getDouble();
+						break;
+					case SelectRule::TYPE_INT:
+						*rule.mStorePtr.mInt = vp.mValue.mInteger;
+						break;
+					case SelectRule::TYPE_UINT:
+						*rule.mStorePtr.mUInt = (vp.mValue.getInteger64() >= 0) ?
+								static_cast<unsigned int>(vp.mValue.getInteger64()) : 0;
+						break;
+					case SelectRule::TYPE_INT64:
+						*rule.mStorePtr.mInt64 = vp.mValue.getInteger64();
+						break;
+					case SelectRule::TYPE_STRING:
+						*rule.mStorePtr.mStr = vp.mValue.mText;
+						break;
+					case SelectRule::TYPE_ARRAY:
+						if (vp.mValue.isPackedArray()) {
+							// mArray is empty, the elements are packed
+							if (errMsg) {
+								*errMsg = "The array of rule '" + vpAttrName + "' is packed. "
+										"Use a rule for the value or Value::unpackArray().";
+							}
+							return -8;
+						}
+						*rule.mStorePtr.mArray = &vp.mValue.mArray;
+						break;
+					case SelectRule::TYPE_OBJECT:
+						*rule.mStorePtr.mObject = &vp.mValue.mObject;
+						break;
+					case SelectRule::TYPE_VALUE:
+						*rule.mStorePtr.mValue = &vp.mValue;
+						break;
+					case SelectRule::TYPE_VALUE_PAIR:
+						*rule.mStorePtr.mValuePair = &vp;
+						break;
+				}
+				curRuleIndex++; // no problem if out of range because getRuleIndex() check this
+				storeCount++;
+			}
+
+			// now check if the rules are complied
+			int unusedRuleIndex = ruleLookup.getUnusedMustExistIndex(usedRuleCounts);
+			if (unusedRuleIndex >= 0) {
+				if (errMsg) {
+					*errMsg = "rule '" + rules[unusedRuleIndex].mName + "' with index " +
+							std::to_string(unusedRuleIndex) + " is not used (but is RULE_MUST_EXIST)";
+				}
+				return -6;
+			}
+			// this version should be enougth. Check above is not necessary.
+			if (currentMustExistCount < finalMustExistCount) {
+				if (errMsg) {
+					*errMsg = "wrong used count for 'must exist' rules. " +
+							std::to_string(currentMustExistCount) + " < " +
+							std::to_string(finalMustExistCount);
+				}
+				return -7;
+			}
+			if (outNextIndex) {
+				*outNextIndex = i;
+			}
+			return static_cast<int>(storeCount);
+		}
 	}
 }
 
@@ -51,6 +635,7 @@ cfg::Value::Value()
 		mBool(false),
 		mFloatingPoint(0.0f),
 		mInteger(0),
+		mInteger64(0),
 		mText(),
 		mArray(),
 		mObject()
@@ -70,6 +655,7 @@ cfg::Value::Value(bool boolValue,
 		mBool(boolValue),
 		mFloatingPoint(static_cast<float>(boolValue)),
 		mInteger(static_cast<int>(boolValue)),
+		mInteger64(0),
 		mText(),
 		mArray(),
 		mObject()
@@ -89,6 +675,7 @@ cfg::Value::Value(float floatingPointValue,
 		mBool(floatingPointValue >= 0.5f || floatingPointValue <= -0.5f),
 		mFloatingPoint(floatingPointValue),
 		mInteger(static_cast<int>(floatingPointValue + ((floatingPointValue >= 0.0) ? 0.5f : -0.5f))),
+		mInteger64(0),
 		mText(),
 		mArray(),
 		mObject()
@@ -103,11 +690,12 @@ cfg::Value::Value(int integerValue, unsigned int parseBase,
 		mOffset(offset),
 		mNvpDeep(nvpDeep),
 		mType(TYPE_INT),
-		mParseBase(parseBase),
+		mParseBase(static_cast<uint8_t>(parseBase)),
 		mParseTextWithQuotes(false),
 		mBool(!!integerValue),
 		mFloatingPoint(static_cast<float>(integerValue)),
 		mInteger(integerValue),
+		mInteger64(0),
 		mText(),
 		mArray(),
 		mObject()
@@ -118,6 +706,7 @@ cfg::Value::Value(int integerValue, unsigned int parseBase,
 		mBool = false;
 		mFloatingPoint = 0.0f;
 		mInteger = 0;
+		mInteger64 = 0;
 	}
 }
 
@@ -134,6 +723,7 @@ cfg::Value::Value(const std::string& text,
 		mBool(false),
 		mFloatingPoint(0.0f),
 		mInteger(0),
+		mInteger64(0),
 		mText(text),
 		mArray(),
 		mObject()
@@ -153,6 +743,7 @@ cfg::Value::Value(const std::vector<Value>& array,
 		mBool(false),
 		mFloatingPoint(0.0f),
 		mInteger(0),
+		mPackedArray(nullptr),
 		mText(),
 		mArray(array),
 		mObject()
@@ -172,6 +763,7 @@ cfg::Value::Value(const std::vector<NameValuePair>& object,
 		mBool(false),
 		mFloatingPoint(0.0f),
 		mInteger(0),
+		mInteger64(0),
 		mText(),
 		mArray(),
 		mObject(object)
@@ -179,7 +771,7 @@ cfg::Value::Value(const std::vector<NameValuePair>& object,
 }
 
 
-cfg::Value::Value(Value&& other)
+cfg::Value::Value(Value&& other) noexcept
 		:mFilename(std::move(other.mFilename)),
 		mLineNumber(std::move(other.mLineNumber)),
 		mOffset(std::move(other.mOffset)),
@@ -190,10 +782,12 @@ cfg::Value::Value(Value&& other)
 		mBool(std::move(other.mBool)),
 		mFloatingPoint(std::move(other.mFloatingPoint)),
 		mInteger(std::move(other.mInteger)),
+		mInteger64(0),
 		mText(std::move(other.mText)),
 		mArray(std::move(other.mArray)),
 		mObject(std::move(other.mObject))
 {
+	moveUnionMember(other);
 	other.mLineNumber = -1;
 	other.mOffset = -1;
 	other.mNvpDeep = -1;
@@ -203,9 +797,10 @@ cfg::Value::Value(Value&& other)
 	other.mBool = false;
 	other.mFloatingPoint = 0.0;
 	other.mInteger = 0;
+	other.mInteger64 = 0;
 }
 
-cfg::Value& cfg::Value::operator=(Value&& other)
+cfg::Value& cfg::Value::operator=(Value&& other) noexcept
 {
 	if (this == &other) {
 		return *this;
@@ -220,6 +815,8 @@ cfg::Value& cfg::Value::operator=(Value&& other)
 	mBool = std::move(other.mBool);
 	mFloatingPoint = std::move(other.mFloatingPoint);
 	mInteger = std::move(other.mInteger);
+	releasePackedArray();
+	moveUnionMember(other);
 	mText = std::move(other.mText);
 	mArray = std::move(other.mArray);
 	mObject = std::move(other.mObject);
@@ -233,10 +830,96 @@ cfg::Value& cfg::Value::operator=(Value&& other)
 	other.mBool = false;
 	other.mFloatingPoint = 0.0;
 	other.mInteger = 0;
+	other.mInteger64 = 0;
+
+	return *this;
+}
 
+cfg::Value::Value(const Value& other)
+		:mType(TYPE_NONE),
+		mInteger64(0),
+		mArray(other.mArray),
+		mObject(other.mObject)
+{
+	copyWithoutChildren(other);
+}
+
+cfg::Value::~Value()
+{
+	releasePackedArray();
+}
+
+cfg::Value& cfg::Value::operator=(const Value& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+	// over a copy because other could be a child of this
+	Value copy(other);
+	*this = std::move(copy);
 	return *this;
 }
 
+void cfg::Value::copyWithoutChildren(const Value& other)
+{
+	mFilename = other.mFilename;
+	mLineNumber = other.mLineNumber;
+	mOffset = other.mOffset;
+	mNvpDeep = other.mNvpDeep;
+	mType = other.mType;
+	mParseBase = other.mParseBase;
+	mParseTextWithQuotes = other.mParseTextWithQuotes;
+	mBool = other.mBool;
+	mFloatingPoint = other.mFloatingPoint;
+	mInteger = other.mInteger;
+	if (&other != this) {
+		releasePackedArray();
+		copyUnionMember(other);
+	}
+	mText = other.mText;
+}
+
+void cfg::Value::copyUnionMember(const Value& other)
+{
+	if (other.mType == TYPE_DOUBLE) {
+		mDouble = other.mDouble;
+	}
+	else if (other.mType == TYPE_ARRAY) {
+		// is never changed --> can be shared
+		mPackedArray = other.mPackedArray;
+		if (mPackedArray) {
+			++mPackedArray->mRefCount;
+		}
+	}
+	else {
+		mInteger64 = other.mInteger64;
+	}
+}
+
+void cfg::Value::moveUnionMember(Value& other)
+{
+	if (other.mType == TYPE_DOUBLE) {
+		mDouble = other.mDouble;
+	}
+	else if (other.mType == TYPE_ARRAY) {
+		mPackedArray = other.mPackedArray;
+	}
+	else {
+		mInteger64 = other.mInteger64;
+	}
+	other.mInteger64 = 0;
+}
+
+void cfg::Value::releasePackedArray()
+{
+	if (mType == TYPE_ARRAY && mPackedArray) {
+		if (--mPackedArray->mRefCount == 0) {
+			delete mPackedArray;
+		}
+		mPackedArray = nullptr;
+	}
+}
+
 std::string cfg::Value::getFilePosition() const
 {
 	char str[30] = "";
@@ -267,12 +950,14 @@ void cfg::Value::clear()
 	mOffset = -1;
 	mNvpDeep = -1;
 
+	releasePackedArray();
 	mType = TYPE_NONE;
 	mParseBase = 0;
 	mParseTextWithQuotes = false;
 	mBool = false;
 	mFloatingPoint = 0.0;
 	mInteger = 0;
+	mInteger64 = 0;
 	mText.clear();
 	mArray.clear();
 	mObject.clear();
@@ -313,12 +998,64 @@ void cfg::Value::setInteger(int value, unsigned int parseBase)
 {
 	clear();
 	mType = TYPE_INT;
-	mParseBase = parseBase;
+	mParseBase = static_cast<uint8_t>(parseBase);
 	mBool = !!value;
 	mFloatingPoint = static_cast<float>(value);
 	mInteger = value;
 }
 
+void cfg::Value::setInteger64(int64_t value, unsigned int parseBase)
+{
+	clear();
+	mType = TYPE_INT64;
+	mParseBase = static_cast<uint8_t>(parseBase);
+	mBool = !!value;
+	mFloatingPoint = static_cast<float>(value);
+	mInteger = clampToInt(value);
+	mInteger64 = value;
+}
+
+void cfg::Value::setDouble(double value)
+{
+	clear();
+	mType = TYPE_DOUBLE;
+	mParseBase = 10;
+	mBool = value >= 0.5 || value <= -0.5;
+	mFloatingPoint = static_cast<float>(value);
+	mInteger = clampToInt(roundToInt64(value));
+	mDouble = value;
+}
+
+int64_t cfg::Value::getInteger64() const
+{
+	switch (mType) {
+		case TYPE_INT64:
+			return mInteger64;
+		case TYPE_DOUBLE:
+			return roundToInt64(mDouble);
+		case TYPE_FLOAT:
+			return roundToInt64(mFloatingPoint);
+		default:
+			// TYPE_BOOL, TYPE_INT and 0 for the others
+			return mInteger;
+	}
+}
+
+double cfg::Value::getDouble() const
+{
+	switch (mType) {
+		case TYPE_DOUBLE:
+			return mDouble;
+		case TYPE_INT64:
+			return static_cast<double>(mInteger64);
+		case TYPE_FLOAT:
+			return static_cast<double>(mFloatingPoint);
+		default:
+			// TYPE_BOOL, TYPE_INT and 0 for the others
+			return static_cast<double>(mInteger);
+	}
+}
+
 void cfg::Value::setText(const std::string& text, bool parseTextWithQuotes)
 {
 	clear();
@@ -327,6 +1064,14 @@ void cfg::Value::setText(const std::string& text, bool parseTextWithQuotes)
 	mText = text;
 }
 
+void cfg::Value::setText(std::string&& text, bool parseTextWithQuotes)
+{
+	clear();
+	mType = TYPE_TEXT;
+	mParseTextWithQuotes = parseTextWithQuotes;
+	mText = std::move(text);
+}
+
 void cfg::Value::setTextEx(const char* textBegin,
 		const char* textEndExclusive, bool parseTextWithQuotes)
 {
@@ -343,6 +1088,13 @@ void cfg::Value::setComment(const std::string& text)
 	mText = text;
 }
 
+void cfg::Value::setComment(std::string&& text)
+{
+	clear();
+	mType = TYPE_COMMENT;
+	mText = std::move(text);
+}
+
 void cfg::Value::setCommentEx(const char* textBegin,
 		const char* textEndExclusive)
 {
@@ -355,14 +1107,25 @@ void cfg::Value::setArray()
 {
 	clear();
 	mType = TYPE_ARRAY;
+	mPackedArray = nullptr;
 	//mArray.clear(); // already done by clear() member function
 }
 
-void cfg::Value::setObject()
+void cfg::Value::setPackedArray(std::unique_ptr<const PackedArray> packedArray)
 {
 	clear();
-	mType = TYPE_OBJECT;
-	//mObject.clear(); // already done by clear() member function
+	mType = TYPE_ARRAY;
+	mPackedArray = packedArray.release();
+	if (mPackedArray) {
+		mPackedArray->mRefCount = 1;
+	}
+}
+
+void cfg::Value::setObject()
+{
+	clear();
+	mType = TYPE_OBJECT;
+	//mObject.clear(); // already done by clear() member function
 }
 
 bool cfg::Value::equalText(const std::string& text) const
@@ -385,6 +1148,135 @@ bool cfg::Value::isComplexArray() const
 	return false;
 }
 
+std::size_t cfg::Value::arraySize() const
+{
+	return isPackedArray() ? mPackedArray->size() : mArray.size();
+}
+
+bool cfg::Value::packArray()
+{
+	if (!isArray()) {
+		return false;
+	}
+	if (mPackedArray) {
+		return true;
+	}
+	EValueType elementType = arrayGetElementType();
+	std::size_t count = mArray.size();
+	std::unique_ptr<PackedArray> packed(new PackedArray());
+	packed->mElementType = elementType;
+	switch (elementType) {
+		case TYPE_INT:
+			packed->mIntegers.resize(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				packed->mIntegers[i] = mArray[i].mInteger;
+			}
+			break;
+		case TYPE_FLOAT:
+			packed->mFloats.resize(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				packed->mFloats[i] = mArray[i].mFloatingPoint;
+			}
+			break;
+		case TYPE_DOUBLE:
+			packed->mDoubles.resize(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				packed->mDoubles[i] = mArray[i].mDouble;
+			}
+			break;
+		default:
+			return false;
+	}
+	// release the memory of the elements
+	std::vector<Value>().swap(mArray);
+	packed->mRefCount = 1;
+	mPackedArray = packed.release();
+	return true;
+}
+
+void cfg::Value::unpackArray()
+{
+	if (!isPackedArray()) {
+		return;
+	}
+	std::size_t count = mPackedArray->size();
+	std::vector<Value> elements(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		mPackedArray->getElement(i, elements[i]);
+		elements[i].mFilename = mFilename;
+	}
+	releasePackedArray();
+	mArray = std::move(elements);
+}
+
+cfg::Value::EValueType cfg::Value::arrayGetElementType() const
+{
+	if (isPackedArray()) {
+		return mPackedArray->mElementType;
+	}
+	if (!isArray() || mArray.empty()) {
+		return TYPE_NONE;
+	}
+	EValueType type = mArray[0].mType;
+	for (const Value& val : mArray) {
+		if (val.mType != type) {
+			return TYPE_NONE;
+		}
+	}
+	return type;
+}
+
+bool cfg::Value::arrayGetFloats(float* outValues, std::size_t maxCount,
+		bool allowInteger, std::size_t& outCount) const
+{
+	return copyArrayNumbers(*this, getFloatTypeMask(allowInteger), outValues,
+			maxCount, outCount, getElementFloat);
+}
+
+bool cfg::Value::arrayGetDoubles(double* outValues, std::size_t maxCount,
+		bool allowInteger, std::size_t& outCount) const
+{
+	return copyArrayNumbers(*this, getFloatTypeMask(allowInteger), outValues,
+			maxCount, outCount, getElementDouble);
+}
+
+bool cfg::Value::arrayGetIntegers(int* outValues, std::size_t maxCount,
+		std::size_t& outCount) const
+{
+	return copyArrayNumbers(*this, getTypeBit(TYPE_INT), outValues,
+			maxCount, outCount, getElementInteger);
+}
+
+bool cfg::Value::arrayGetInteger64s(int64_t* outValues, std::size_t maxCount,
+		std::size_t& outCount) const
+{
+	return copyArrayNumbers(*this, getTypeBit(TYPE_INT) | getTypeBit(TYPE_INT64),
+			outValues, maxCount, outCount, getElementInteger64);
+}
+
+bool cfg::Value::arrayGetFloats(std::vector<float>& outValues, bool allowInteger) const
+{
+	return copyArrayNumbers(*this, getFloatTypeMask(allowInteger), outValues,
+			getElementFloat);
+}
+
+bool cfg::Value::arrayGetDoubles(std::vector<double>& outValues, bool allowInteger) const
+{
+	return copyArrayNumbers(*this, getFloatTypeMask(allowInteger), outValues,
+			getElementDouble);
+}
+
+bool cfg::Value::arrayGetIntegers(std::vector<int>& outValues) const
+{
+	return copyArrayNumbers(*this, getTypeBit(TYPE_INT), outValues, getElementInteger);
+}
+
+bool cfg::Value::arrayGetInteger64s(std::vector<int64_t>& outValues) const
+{
+	return copyArrayNumbers(*this, getTypeBit(TYPE_INT) | getTypeBit(TYPE_INT64),
+			outValues, getElementInteger64);
+}
+
 bool cfg::Value::attributeExist(const std::string& attrName,
 		bool recursive, bool searchInclObjects, bool searchInclArrays) const
 {
@@ -420,24 +1312,7 @@ bool cfg::Value::attributeExist(const std::string& attrName,
 const cfg::NameValuePair* cfg::Value::objectGetValuePair(
 		const std::string &attrName) const
 {
-	std::size_t pairCount = mObject.size();
-	std::size_t foundCount = 0;
-	const NameValuePair* valuePair = nullptr;
-
-	for (std::size_t i = 0; i < pairCount; i++) {
-		if (mObject[i].mName.mType != Value::TYPE_TEXT) {
-			continue;
-		}
-		if (mObject[i].mName.mText != attrName) {
-			continue;
-		}
-		foundCount++;
-		valuePair = &mObject[i];
-	}
-	if (foundCount != 1) {
-		return nullptr;
-	}
-	return valuePair;
+	return getUniquePair(mObject, attrName.data(), attrName.size());
 }
 
 const cfg::Value* cfg::Value::objectGetValue(const std::string &attrName) const
@@ -452,15 +1327,7 @@ const cfg::Value* cfg::Value::objectGetValue(const std::string &attrName) const
 bool cfg::Value::objectGetText(const std::string &attrName,
 		std::string &attrValue) const
 {
-	const Value* value = objectGetValue(attrName);
-	if (!value) {
-		return false;
-	}
-	if (value->mType != Value::TYPE_TEXT) {
-		return false;
-	}
-	attrValue = value->mText;
-	return true;
+	return getText(objectGetValue(attrName), attrValue);
 }
 
 std::string cfg::Value::objectGetText(const std::string &attrName) const
@@ -474,15 +1341,7 @@ std::string cfg::Value::objectGetText(const std::string &attrName) const
 
 bool cfg::Value::objectGetInteger(const std::string &attrName, int &attrValue) const
 {
-	const Value* value = objectGetValue(attrName);
-	if (!value) {
-		return false;
-	}
-	if (value->mType != Value::TYPE_INT) {
-		return false;
-	}
-	attrValue = value->mInteger;
-	return true;
+	return getInteger(objectGetValue(attrName), attrValue);
 }
 
 int cfg::Value::objectGetInteger(const std::string &attrName) const
@@ -496,18 +1355,7 @@ int cfg::Value::objectGetInteger(const std::string &attrName) const
 
 bool cfg::Value::objectGetFloat(const std::string &attrName, bool allowInteger, float &attrValue) const
 {
-	const Value* value = objectGetValue(attrName);
-	if (!value) {
-		return false;
-	}
-	if (value->mType != Value::TYPE_FLOAT &&
-			(!allowInteger || value->mType != Value::TYPE_INT)
-			) {
-		return false;
-	}
-	// if it is an integer then the floating point member also has the correct value
-	attrValue = value->mFloatingPoint;
-	return true;
+	return getFloat(objectGetValue(attrName), allowInteger, attrValue);
 }
 
 // if not exist it return 0
@@ -522,15 +1370,7 @@ float cfg::Value::objectGetFloat(const std::string &attrName, bool allowInteger)
 
 bool cfg::Value::objectGetBool(const std::string &attrName, bool &attrValue) const
 {
-	const Value* value = objectGetValue(attrName);
-	if (!value) {
-		return false;
-	}
-	if (value->mType != Value::TYPE_BOOL) {
-		return false;
-	}
-	attrValue = value->mBool;
-	return true;
+	return getBool(objectGetValue(attrName), attrValue);
 }
 
 bool cfg::Value::objectGetBool(const std::string &attrName) const
@@ -609,18 +1449,103 @@ std::vector<int> cfg::Value::objectGetIntegers(const std::string &attrName) cons
 
 int cfg::Value::objectGetAttrIndex(const std::string &attrName) const
 {
-	std::size_t pairCount = mObject.size();
+	return getFirstPairIndex(mObject, attrName.data(), attrName.size());
+}
 
-	for (std::size_t i = 0; i < pairCount; i++) {
-		if (mObject[i].mName.mType != Value::TYPE_TEXT) {
-			continue;
-		}
-		if (mObject[i].mName.mText != attrName) {
-			continue;
-		}
-		return static_cast<int>(i);
+const cfg::NameValuePair* cfg::Value::objectGetValuePair(const char* attrName) const
+{
+	return getUniquePair(mObject, attrName, strlen(attrName));
+}
+
+const cfg::Value* cfg::Value::objectGetValue(const char* attrName) const
+{
+	const NameValuePair* valuePair = objectGetValuePair(attrName);
+	if (!valuePair) {
+		return nullptr;
 	}
-	return -1;
+	return &valuePair->mValue;
+}
+
+const std::string* cfg::Value::objectGetTextPtr(const char* attrName) const
+{
+	const Value* value = objectGetValue(attrName);
+	if (!value || value->mType != Value::TYPE_TEXT) {
+		return nullptr;
+	}
+	return &value->mText;
+}
+
+const std::string* cfg::Value::objectGetTextPtr(const std::string &attrName) const
+{
+	const Value* value = objectGetValue(attrName);
+	if (!value || value->mType != Value::TYPE_TEXT) {
+		return nullptr;
+	}
+	return &value->mText;
+}
+
+bool cfg::Value::objectGetText(const char* attrName, std::string &attrValue) const
+{
+	return getText(objectGetValue(attrName), attrValue);
+}
+
+bool cfg::Value::objectGetInteger(const char* attrName, int &attrValue) const
+{
+	return getInteger(objectGetValue(attrName), attrValue);
+}
+
+int cfg::Value::objectGetInteger(const char* attrName) const
+{
+	int attrValue = 0;
+	if (!objectGetInteger(attrName, attrValue)) {
+		return 0;
+	}
+	return attrValue;
+}
+
+bool cfg::Value::objectGetFloat(const char* attrName, bool allowInteger, float &attrValue) const
+{
+	return getFloat(objectGetValue(attrName), allowInteger, attrValue);
+}
+
+float cfg::Value::objectGetFloat(const char* attrName, bool allowInteger) const
+{
+	float attrValue = 0.0f;
+	if (!objectGetFloat(attrName, allowInteger, attrValue)) {
+		return 0.0f;
+	}
+	return attrValue;
+}
+
+bool cfg::Value::objectGetBool(const char* attrName, bool &attrValue) const
+{
+	return getBool(objectGetValue(attrName), attrValue);
+}
+
+bool cfg::Value::objectGetBool(const char* attrName) const
+{
+	bool attrValue = false;
+	if (!objectGetBool(attrName, attrValue)) {
+		return false;
+	}
+	return attrValue;
+}
+
+int cfg::Value::objectGetAttrIndex(const char* attrName) const
+{
+	return getFirstPairIndex(mObject, attrName, strlen(attrName));
+}
+
+cfg::ObjectPairRange cfg::Value::objectGetPairRange(const char* attrName) const
+{
+	return ObjectPairRange(mObject.data(), mObject.data() + mObject.size(),
+			attrName, strlen(attrName));
+}
+
+cfg::ObjectPairRange cfg::Value::objectGetPairRange(const std::string &attrName) const
+{
+	return ObjectPairRange(mObject.data(), mObject.data() + mObject.size(),
+			attrName.data(), attrName.size());
 }
 
 int cfg::Value::objectGet(const SelectRule *rules,
@@ -638,6 +1563,21 @@ int cfg::Value::objectGet(const SelectRule *rules,
 			reset, errMsg, warnings);
 }
 
+int cfg::Value::objectGet(const CompiledSelectRules& rules,
+		bool allowRandomSequence, bool allowUnusedValuePairs,
+		bool allowEarlyReturn, bool allowDuplicatedNames,
+		bool allowDuplicatedRuleNamesWithDiffTypes,
+		std::size_t startIndex, std::size_t *outNextIndex,
+		EReset reset, std::string* errMsg, std::string* warnings) const
+{
+	return cfg::objectGet(mObject, rules,
+			allowRandomSequence, allowUnusedValuePairs,
+			allowEarlyReturn, allowDuplicatedNames,
+			allowDuplicatedRuleNamesWithDiffTypes,
+			startIndex, outNextIndex,
+			reset, errMsg, warnings);
+}
+
 cfg::Value cfg::none(int lineNumber, int offset, int nvpDeep,
 		const std::shared_ptr<const std::string>& filename)
 {
@@ -677,6 +1617,24 @@ cfg::Value cfg::intValue(int integerValue, unsigned int parseBase,
 	return Value{integerValue, parseBase, lineNumber, offset, nvpDeep, filename};
 }
 
+cfg::Value cfg::int64Value(int64_t integerValue, unsigned int parseBase,
+		int lineNumber, int offset, int nvpDeep,
+		const std::shared_ptr<const std::string>& filename)
+{
+	Value value{0, 10, lineNumber, offset, nvpDeep, filename};
+	value.setInteger64(integerValue, parseBase);
+	return value;
+}
+
+cfg::Value cfg::doubleValue(double doubleValue,
+		int lineNumber, int offset, int nvpDeep,
+		const std::shared_ptr<const std::string>& filename)
+{
+	Value value{0, 10, lineNumber, offset, nvpDeep, filename};
+	value.setDouble(doubleValue);
+	return value;
+}
+
 cfg::Value cfg::text(const std::string& text,
 		int lineNumber, int offset, int nvpDeep,
 		const std::shared_ptr<const std::string>& filename)
@@ -729,311 +1687,210 @@ int cfg::objectGet(const std::vector<NameValuePair>& nvpairsOfObject,
 		std::size_t startIndex, std::size_t *outNextIndex,
 		EReset reset, std::string* errMsg, std::string* warnings)
 {
-	std::size_t rulesSize = 0;
-	unsigned int finalMustExistCount = 0;
-	unsigned int currentMustExistCount = 0;
+	RuleArrayLookup ruleLookup = {rules, 0, 0};
 	if (errMsg) {
 		errMsg->clear();
 	}
 	if (warnings) {
 		warnings->clear();
 	}
-	while (rules[rulesSize].mType != SelectRule::TYPE_UNKNOWN) {
-		if (reset != EReset::RESET_NOTHING && rules[rulesSize].mStorePtr.mPtr) {
-			switch (rules[rulesSize].mType) {
-				case SelectRule::TYPE_UNKNOWN:
-					break;
-				case SelectRule::TYPE_NULL:
-					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
-						*rules[rulesSize].mStorePtr.mNull = false;
-					}
-					break;
-				case SelectRule::TYPE_BOOL:
-					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
-						*rules[rulesSize].mStorePtr.mBool = false;
-					}
-					break;
-				case SelectRule::TYPE_FLOAT:
-					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
-						*rules[rulesSize].mStorePtr.mFloat = 0.0f;
-					}
-					break;
-				case SelectRule::TYPE_DOUBLE:
-					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
-						*rules[rulesSize].mStorePtr.mDouble = 0.0;
-					}
-					break;
-				case SelectRule::TYPE_INT:
-					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
-						*rules[rulesSize].mStorePtr.mInt = 0;
-					}
-					break;
-				case SelectRule::TYPE_UINT:
-					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
-						*rules[rulesSize].mStorePtr.mUInt = 0;
-					}
-					break;
-				case SelectRule::TYPE_STRING:
-					if (reset == EReset::RESET_EVERYTHING_TO_DEFAULTS) {
-						rules[rulesSize].mStorePtr.mStr->clear();
-					}
-					break;
-				case SelectRule::TYPE_ARRAY:
-					*rules[rulesSize].mStorePtr.mArray = nullptr;
-					break;
-				case SelectRule::TYPE_OBJECT:
-					*rules[rulesSize].mStorePtr.mObject = nullptr;
-					break;
-				case SelectRule::TYPE_VALUE:
-					*rules[rulesSize].mStorePtr.mValue = nullptr;
-					break;
-				case SelectRule::TYPE_VALUE_PAIR:
-					*rules[rulesSize].mStorePtr.mValuePair = nullptr;
-					break;
-			}
+	while (rules[ruleLookup.mRulesSize].mType != SelectRule::TYPE_UNKNOWN) {
+		const SelectRule& rule = rules[ruleLookup.mRulesSize];
+		resetRule(rule, reset);
+		if (rule.mUsedCount) {
+			*rule.mUsedCount = 0;
 		}
-		if (rules[rulesSize].mUsedCount) {
-			*rules[rulesSize].mUsedCount = 0;
+		if (rule.mRule == SelectRule::RULE_MUST_EXIST) {
+			++ruleLookup.mMustExistCount;
 		}
-		if (rules[rulesSize].mRule == SelectRule::RULE_MUST_EXIST) {
-			++finalMustExistCount;
-		}
-		++rulesSize;
+		++ruleLookup.mRulesSize;
 	}
 
-	std::size_t pairCount = nvpairsOfObject.size();
-	std::size_t curRuleIndex = 0;
-	std::size_t storeCount = 0;
+	// a vector is only used for more than 64 rules
+	std::size_t usedRuleCounts[64] = {};
+	std::vector<std::size_t> moreUsedRuleCounts;
+	if (ruleLookup.mRulesSize > 64) {
+		moreUsedRuleCounts.resize(ruleLookup.mRulesSize, 0);
+	}
+	return objectGetWithLookup(nvpairsOfObject, ruleLookup,
+			moreUsedRuleCounts.empty() ? usedRuleCounts : moreUsedRuleCounts.data(),
+			allowRandomSequence, allowUnusedValuePairs,
+			allowEarlyReturn, allowDuplicatedNames,
+			allowDuplicatedRuleNamesWithDiffTypes,
+			startIndex, outNextIndex, errMsg, warnings);
+}
+
+int cfg::objectGet(const std::vector<NameValuePair>& nvpairsOfObject,
+		const CompiledSelectRules& rules,
+		bool allowRandomSequence, bool allowUnusedValuePairs,
+		bool allowEarlyReturn, bool allowDuplicatedNames,
+		bool allowDuplicatedRuleNamesWithDiffTypes,
+		std::size_t startIndex, std::size_t *outNextIndex,
+		EReset reset, std::string* errMsg, std::string* warnings)
+{
+	if (errMsg) {
+		errMsg->clear();
+	}
+	if (warnings) {
+		warnings->clear();
+	}
+	const SelectRule* ruleArray = rules.getRules();
+	const std::size_t rulesSize = rules.size();
+	for (std::size_t ri = 0; ri < rulesSize; ri++) {
+		resetRule(ruleArray[ri], reset);
+		if (ruleArray[ri].mUsedCount) {
+			*ruleArray[ri].mUsedCount = 0;
+		}
+	}
 
+	// a vector is only used for more than 64 rules
 	std::size_t usedRuleCounts[64] = {};
+	std::vector<std::size_t> moreUsedRuleCounts;
 	if (rulesSize > 64) {
-		if (errMsg) {
-			*errMsg = "Too many config rules (" + std::to_string(rulesSize) + " > 64)";
-		}
-		return -1;
+		moreUsedRuleCounts.resize(rulesSize, 0);
 	}
+	return objectGetWithLookup(nvpairsOfObject, rules,
+			moreUsedRuleCounts.empty() ? usedRuleCounts : moreUsedRuleCounts.data(),
+			allowRandomSequence, allowUnusedValuePairs,
+			allowEarlyReturn, allowDuplicatedNames,
+			allowDuplicatedRuleNamesWithDiffTypes,
+			startIndex, outNextIndex, errMsg, warnings);
+}
 
-	std::size_t i = startIndex;
-	bool prevTypeWasWrong = false;
-	for (; storeCount < rulesSize; ++i) {
-		if (prevTypeWasWrong) {
-			--i; // revert the ++i from loop
-		}
+//-----------------------------------------------
 
-		// This check must be made after the prevTypeWasWrong check and
-		// not before in the for-condition.
-		// It's not possible to use i < pairCount in for() instead because
-		// then the logic doesn't work correct if the last name-value pair
-		// has a wrong type. Because then ++i would be equal pairCount -->
-		// loop finished --> --i not executed --> no next rule for wrong type
-		// if last name-value pair has rule with wrong type.
-		if (i >= pairCount) {
-			break;
-		}
-		const NameValuePair& vp = nvpairsOfObject[i];
+cfg::CompiledSelectRules::CompiledSelectRules()
+		:mRules(nullptr),
+		mRulesSize(0),
+		mMustExistCount(0),
+		mSlotMask(0)
+{
+}
 
-		if (vp.isEmpty() || vp.isComment()) {
-			// Should never be possible that prevTypeWasWrong is not already false.
-			// But better safe than sorry.
-			prevTypeWasWrong = false;
-			continue;
+cfg::CompiledSelectRules::CompiledSelectRules(const SelectRule *rules)
+		:CompiledSelectRules()
+{
+	compile(rules);
+}
+
+void cfg::CompiledSelectRules::compile(const SelectRule *rules)
+{
+	mRules = rules;
+	mRulesSize = 0;
+	mMustExistCount = 0;
+	mMustExistBits.clear();
+	mNameEntries.clear();
+	mRuleIndices.clear();
+	mNameSlots.clear();
+	mSlotMask = 0;
+
+	while (rules[mRulesSize].mType != SelectRule::TYPE_UNKNOWN) {
+		++mRulesSize;
+	}
+	if (mRulesSize == 0) {
+		return;
+	}
+
+	mMustExistBits.resize((mRulesSize + 63) / 64, 0);
+	for (std::size_t ri = 0; ri < mRulesSize; ri++) {
+		if (rules[ri].mRule == SelectRule::RULE_MUST_EXIST) {
+			mMustExistBits[ri / 64] |= (uint64_t(1) << (ri % 64));
+			++mMustExistCount;
 		}
+	}
 
-		const std::string& vpAttrName =
-				(vp.mName.mType == Value::TYPE_TEXT) ?
-				vp.mName.mText : "";
-
-		// find the correct rule
-		int ri = getRuleIndex(vpAttrName, curRuleIndex,
-				rules, rulesSize, allowRandomSequence && !prevTypeWasWrong);
-		if (ri < 0) {
-			int riWithRandomSequence = getRuleIndex(vpAttrName, curRuleIndex,
-					rules, rulesSize, !prevTypeWasWrong);
-
-			// now we can reset prevTypeWasWrong (if it was set). Before its not
-			// possible because getRuleIndex() need this variable!
-			prevTypeWasWrong = false;
-
-			// no rule found for this attr name
-			if (allowUnusedValuePairs) {
-				if (riWithRandomSequence >= 0 && warnings) {
-					*warnings += "attr name '" + vpAttrName +
-							"' has the wrong position/order and is ignored (unused name-value pair).\n";
-				}
-				continue;
-			}
-			if (allowEarlyReturn && finalMustExistCount == currentMustExistCount) {
-				std::size_t ii = i;
-				// here i < pairCount is ok in for() because no --i is possible
-				// in this loop. See for() loop above for more infos.
-				for (; i < pairCount && storeCount < rulesSize; ++i) {
-					const NameValuePair& vp = nvpairsOfObject[i];
-					const std::string& vpAttrName =
-							(vp.mName.mType == Value::TYPE_TEXT) ?
-							vp.mName.mText : "";
-					// allowRandomSequence is here independent of prevTypeWasWrong
-					// no && !prevTypeWasWrong for getRuleIndex.
-					if (getRuleIndex(vpAttrName, curRuleIndex,
-							rules, rulesSize, allowRandomSequence) >= 0) {
-						if (errMsg) {
-							*errMsg = "rule for attr name '" + vpAttrName + "' is not allowed here";
-						}
-						return -2;
-					}
-					++curRuleIndex; // no problem if out of range because getRuleIndex() check this
-				}
-				if (outNextIndex) {
-					*outNextIndex = ii;
-				}
-				return static_cast<int>(storeCount);
-			}
-			if (errMsg) {
-				if (riWithRandomSequence >= 0) {
-					*errMsg = "attr name '" + vpAttrName + "' has the wrong position/order. Random sequence is not allowed.";
-				}
-				else {
-					*errMsg = "no rule found for attr name '" + vpAttrName + "'";
-				}
+	// at least twice as many slots as rules (load factor <= 0.5)
+	std::size_t slotCount = 8;
+	while (slotCount < mRulesSize * 2) {
+		slotCount *= 2;
+	}
+	mNameSlots.resize(slotCount, 0);
+	mSlotMask = static_cast<unsigned int>(slotCount - 1);
+
+	// first pass: find or add the name entry of each rule
+	std::vector<unsigned int> entryOfRule(mRulesSize);
+	for (std::size_t ri = 0; ri < mRulesSize; ri++) {
+		unsigned int hash = getNameHash(rules[ri].mName);
+		unsigned int slot = hash & mSlotMask;
+		while (mNameSlots[slot]) {
+			const NameEntry& entry = mNameEntries[mNameSlots[slot] - 1];
+			// mIndexBegin is the first rule index in the first pass
+			if (entry.mHash == hash && rules[entry.mIndexBegin].mName == rules[ri].mName) {
+				break;
 			}
-			return -3;
+			slot = (slot + 1) & mSlotMask;
 		}
-		// now we can reset prevTypeWasWrong (if it was set). Before its not
-		// possible because getRuleIndex() need this variable!
-		prevTypeWasWrong = false;
-
-		curRuleIndex = ri;
-		++usedRuleCounts[curRuleIndex];
-		if (rules[curRuleIndex].mUsedCount) {
-			++*rules[curRuleIndex].mUsedCount;
-		}
-		// check if it was the first time that the rule was used and if the rule must be used
-		if (usedRuleCounts[curRuleIndex] == 1 &&
-				rules[curRuleIndex].mRule == SelectRule::RULE_MUST_EXIST) {
-			++currentMustExistCount;
+		if (!mNameSlots[slot]) {
+			NameEntry entry = {hash, static_cast<unsigned int>(ri), 0};
+			mNameEntries.push_back(entry);
+			mNameSlots[slot] = static_cast<unsigned int>(mNameEntries.size());
 		}
+		entryOfRule[ri] = mNameSlots[slot] - 1;
+		++mNameEntries[entryOfRule[ri]].mIndexCount;
+	}
 
-		const SelectRule& rule = rules[curRuleIndex];
-		static unsigned int lookup[] = {
-			SelectRule::ALLOW_NONE,   // for Value::TYPE_NONE   = 0
-			SelectRule::ALLOW_NULL,   // for Value::TYPE_NULL   = 1
-			SelectRule::ALLOW_BOOL,   // for Value::TYPE_BOOL   = 2
-			SelectRule::ALLOW_FLOAT,  // for Value::TYPE_FLOAT  = 3
-			SelectRule::ALLOW_INT,    // for Value::TYPE_INT    = 4
-			SelectRule::ALLOW_TEXT,   // for Value::TYPE_TEXT   = 5
-			0, // ALLOW_COMMENT not exist // for Value::TYPE_COMMENT = 6
-			SelectRule::ALLOW_ARRAY,  // for Value::TYPE_ARRAY  = 7
-			SelectRule::ALLOW_OBJECT, // for Value::TYPE_OBJECT = 8
-		};
-		if (!(rule.mAllowedTypes & lookup[vp.mValue.mType])) {
-			if (allowDuplicatedRuleNamesWithDiffTypes) {
-				prevTypeWasWrong = true;
-				// revert rule count because this rule was not used (because of wrong type)
+	// second pass: store the rule indices grouped by name (ascending)
+	unsigned int indexBegin = 0;
+	for (NameEntry& entry : mNameEntries) {
+		entry.mIndexBegin = indexBegin;
+		indexBegin += entry.mIndexCount;
+		entry.mIndexCount = 0;
+	}
+	mRuleIndices.resize(mRulesSize);
+	for (std::size_t ri = 0; ri < mRulesSize; ri++) {
+		NameEntry& entry = mNameEntries[entryOfRule[ri]];
+		mRuleIndices[entry.mIndexBegin + entry.mIndexCount] = static_cast<unsigned int>(ri);
+		++entry.mIndexCount;
+	}
+}
 
-				// check if it was the first time that the rule was used and if the rule must be used
-				// then the "current must exist count" must also be reverted
-				if (usedRuleCounts[curRuleIndex] == 1 &&
-						rules[curRuleIndex].mRule == SelectRule::RULE_MUST_EXIST) {
-					--currentMustExistCount;
-				}
-				--usedRuleCounts[curRuleIndex];
-				if (rules[curRuleIndex].mUsedCount) {
-					--*rules[curRuleIndex].mUsedCount;
+int cfg::CompiledSelectRules::getRuleIndex(const std::string& ruleName,
+		std::size_t curRuleIndex, bool allowRandomSequence) const
+{
+	// rules are mostly in the same order as the name-value pairs
+	if (curRuleIndex < mRulesSize && ruleName == mRules[curRuleIndex].mName) {
+		return static_cast<int>(curRuleIndex);
+	}
+	if (mNameSlots.empty()) {
+		return -1;
+	}
+	unsigned int hash = getNameHash(ruleName);
+	unsigned int slot = hash & mSlotMask;
+	while (mNameSlots[slot]) {
+		const NameEntry& entry = mNameEntries[mNameSlots[slot] - 1];
+		if (entry.mHash == hash &&
+				mRules[mRuleIndices[entry.mIndexBegin]].mName == ruleName) {
+			const unsigned int* indices = &mRuleIndices[entry.mIndexBegin];
+			// first rule after the current rule index
+			for (unsigned int i = 0; i < entry.mIndexCount; i++) {
+				if (indices[i] > curRuleIndex) {
+					return static_cast<int>(indices[i]);
 				}
-				curRuleIndex++; // no problem if out of range because getRuleIndex() check this
-				continue;
-			}
-			if (errMsg) {
-				*errMsg = "Type is not allowed for rule '" + vpAttrName +
-						"'. allowed " + std::to_string(rule.mAllowedTypes) +
-						", lookup " + std::to_string(lookup[vp.mValue.mType]) +
-						", type " + std::to_string(vp.mValue.mType);
-			}
-			return -5;
-		}
-
-		// The duplication check must be here after the type check. Because
-		// if the type is wrong then the rule is not applied and therefore
-		// not duplicated.
-		if (usedRuleCounts[curRuleIndex] > 1) {
-			if (allowDuplicatedNames) {
-				curRuleIndex++; // no problem if out of range because getRuleIndex() check this
-				continue; // ignore duplicates --> jump to next
 			}
-			if (errMsg) {
-				*errMsg = "found duplicated rule for attr name '" + vpAttrName + "'";
+			if (!allowRandomSequence) {
+				return -1; // no other rule allowed
 			}
-			return -4;
-		}
-
-		switch (rule.mType) {
-			case SelectRule::TYPE_UNKNOWN:
-				return -1; // unknown is not allowed
-			case SelectRule::TYPE_NULL:
-				*rule.mStorePtr.mNull = true;
-				break;
-			case SelectRule::TYPE_BOOL:
-				*rule.mStorePtr.mBool = vp.mValue.mBool;
-				break;
-			case SelectRule::TYPE_FLOAT:
-				*rule.mStorePtr.mFloat = vp.mValue.mFloatingPoint;
-				break;
-			case SelectRule::TYPE_DOUBLE:
-				*rule.mStorePtr.mDouble = vp.mValue.mFloatingPoint;
-				break;
-			case SelectRule::TYPE_INT:
-				*rule.mStorePtr.mInt = vp.mValue.mInteger;
-				break;
-			case SelectRule::TYPE_UINT:
-				*rule.mStorePtr.mUInt = (vp.mValue.mInteger >= 0) ?
-						vp.mValue.mInteger : 0;
-				break;
-			case SelectRule::TYPE_STRING:
-				*rule.mStorePtr.mStr = vp.mValue.mText;
-				break;
-			case SelectRule::TYPE_ARRAY:
-				*rule.mStorePtr.mArray = &vp.mValue.mArray;
-				break;
-			case SelectRule::TYPE_OBJECT:
-				*rule.mStorePtr.mObject = &vp.mValue.mObject;
-				break;
-			case SelectRule::TYPE_VALUE:
-				*rule.mStorePtr.mValue = &vp.mValue;
-				break;
-			case SelectRule::TYPE_VALUE_PAIR:
-				*rule.mStorePtr.mValuePair = &vp;
-				break;
+			// first rule before the current rule index
+			return static_cast<int>(indices[0]);
 		}
-		curRuleIndex++; // no problem if out of range because getRuleIndex() check this
-		storeCount++;
+		slot = (slot + 1) & mSlotMask;
 	}
+	return -1; // no rule found
+}
 
-	// now check if the rules are complied
-#if 1
-	for (std::size_t ri = 0; ri < rulesSize; ri++) {
-		if (rules[ri].mRule == SelectRule::RULE_MUST_EXIST && !usedRuleCounts[ri]) {
-			if (errMsg) {
-				*errMsg = "rule '" + rules[ri].mName + "' with index " +
-						std::to_string(ri) + " is not used (but is RULE_MUST_EXIST)";
+int cfg::CompiledSelectRules::getUnusedMustExistIndex(
+		const std::size_t* usedRuleCounts) const
+{
+	for (std::size_t w = 0; w < mMustExistBits.size(); w++) {
+		uint64_t bits = mMustExistBits[w];
+		for (std::size_t ri = w * 64; bits; ri++, bits >>= 1) {
+			if ((bits & 1) && !usedRuleCounts[ri]) {
+				return static_cast<int>(ri);
 			}
-			return -6;
-		}
-	}
-#endif
-	// this version should be enougth. Loop above is not necessary.
-	if (currentMustExistCount < finalMustExistCount) {
-		if (errMsg) {
-			*errMsg = "wrong used count for 'must exist' rules. " +
-					std::to_string(currentMustExistCount) + " < " +
-					std::to_string(finalMustExistCount);
 		}
-		return -7;
-	}
-	if (outNextIndex) {
-		*outNextIndex = i;
 	}
-	return static_cast<int>(storeCount);
+	return -1;
 }
-
 //-----------------------------------------------
 
 cfg::NameValuePair::NameValuePair()
@@ -1046,7 +1903,12 @@ cfg::NameValuePair::NameValuePair(const Value& name, const Value& value, int dee
 {
 }
 
-cfg::NameValuePair::NameValuePair(NameValuePair&& other)
+cfg::NameValuePair::NameValuePair(Value&& name, Value&& value, int deep)
+		:mName(std::move(name)), mValue(std::move(value)), mDeep(deep)
+{
+}
+
+cfg::NameValuePair::NameValuePair(NameValuePair&& other) noexcept
 	:mName(std::move(other.mName)),
 	mValue(std::move(other.mValue)),
 	mDeep(std::move(other.mDeep))
@@ -1054,7 +1916,7 @@ cfg::NameValuePair::NameValuePair(NameValuePair&& other)
 	other.mDeep = -1;
 }
 
-cfg::NameValuePair& cfg::NameValuePair::operator=(NameValuePair&& other)
+cfg::NameValuePair& cfg::NameValuePair::operator=(NameValuePair&& other) noexcept
 {
 	if (this == &other) {
 		return *this;
@@ -1069,6 +1931,175 @@ cfg::NameValuePair& cfg::NameValuePair::operator=(NameValuePair&& other)
 	return *this;
 }
 
+cfg::ObjectPairRange::const_iterator::const_iterator(const NameValuePair* pos,
+		const NameValuePair* end, const char* name, std::size_t nameLength)
+		:mPos(pos), mEnd(end), mName(name), mNameLength(nameLength)
+{
+	skip();
+}
+
+cfg::ObjectPairRange::const_iterator& cfg::ObjectPairRange::const_iterator::operator++()
+{
+	++mPos;
+	skip();
+	return *this;
+}
+
+cfg::ObjectPairRange::const_iterator cfg::ObjectPairRange::const_iterator::operator++(int)
+{
+	const_iterator prev = *this;
+	++(*this);
+	return prev;
+}
+
+void cfg::ObjectPairRange::const_iterator::skip()
+{
+	while (mPos != mEnd && !isTextName(mPos->mName, mName, mNameLength)) {
+		++mPos;
+	}
+}
+
+cfg::ObjectPairRange::const_iterator cfg::ObjectPairRange::begin() const
+{
+	return const_iterator(mBegin, mEnd, mName, mNameLength);
+}
+
+cfg::ObjectPairRange::const_iterator cfg::ObjectPairRange::end() const
+{
+	return const_iterator(mEnd, mEnd, mName, mNameLength);
+}
+
+std::size_t cfg::ObjectPairRange::size() const
+{
+	std::size_t count = 0;
+	for (const_iterator it = begin(); it != end(); ++it) {
+		++count;
+	}
+	return count;
+}
+
+std::size_t cfg::PackedArray::size() const
+{
+	switch (mElementType) {
+		case Value::TYPE_INT:
+			return mIntegers.size();
+		case Value::TYPE_FLOAT:
+			return mFloats.size();
+		case Value::TYPE_DOUBLE:
+			return mDoubles.size();
+		default:
+			return 0;
+	}
+}
+
+void cfg::PackedArray::getElement(std::size_t index, Value& outValue) const
+{
+	switch (mElementType) {
+		case Value::TYPE_INT:
+			outValue.setInteger(mIntegers[index]);
+			break;
+		case Value::TYPE_FLOAT:
+			outValue.setFloatingPoint(mFloats[index]);
+			break;
+		case Value::TYPE_DOUBLE:
+			outValue.setDouble(mDoubles[index]);
+			break;
+		default:
+			outValue.clear();
+			break;
+	}
+}
+
+bool cfg::PackedArray::add(const Value& element)
+{
+	if (mElementType == Value::TYPE_NONE) {
+		if (element.mType != Value::TYPE_INT && element.mType != Value::TYPE_FLOAT &&
+				element.mType != Value::TYPE_DOUBLE) {
+			return false;
+		}
+		mElementType = element.mType;
+	}
+	else if (element.mType != mElementType) {
+		return false;
+	}
+	switch (mElementType) {
+		case Value::TYPE_INT:
+			mIntegers.push_back(element.mInteger);
+			break;
+		case Value::TYPE_FLOAT:
+			mFloats.push_back(element.mFloatingPoint);
+			break;
+		default:
+			mDoubles.push_back(element.mDouble);
+			break;
+	}
+	return true;
+}
+
+cfg::ArrayBuilder::ArrayBuilder(Value& array, std::size_t count, bool pack)
+		:mValue(array),
+		mCount(count)
+{
+	mValue.setArray();
+	if (pack) {
+		mPacked = std::unique_ptr<PackedArray>(new PackedArray());
+	}
+	else {
+		mValue.mArray.reserve(count);
+	}
+}
+
+void cfg::ArrayBuilder::add(Value&& element)
+{
+	if (mPacked) {
+		if (mPacked->add(element)) {
+			if (mPacked->size() == 1) {
+				// the type is known with the first element
+				mPacked->mIntegers.reserve(mPacked->mElementType == Value::TYPE_INT ? mCount : 0);
+				mPacked->mFloats.reserve(mPacked->mElementType == Value::TYPE_FLOAT ? mCount : 0);
+				mPacked->mDoubles.reserve(mPacked->mElementType == Value::TYPE_DOUBLE ? mCount : 0);
+			}
+			return;
+		}
+		// --> not packable, move the previous numbers to mArray
+		std::size_t packedCount = mPacked->size();
+		mValue.mArray.reserve(std::max(mCount, packedCount + 1));
+		for (std::size_t i = 0; i < packedCount; ++i) {
+			mValue.mArray.emplace_back();
+			mPacked->getElement(i, mValue.mArray.back());
+			mValue.mArray.back().mFilename = mValue.mFilename;
+		}
+		mPacked.reset();
+	}
+	mValue.mArray.push_back(std::move(element));
+}
+
+void cfg::ArrayBuilder::finish()
+{
+	if (mPacked && mPacked->size()) {
+		mValue.setPackedArray(std::move(mPacked));
+	}
+	mPacked.reset();
+}
+
+void cfg::packNumericArrays(Value& value)
+{
+	if (value.isArray()) {
+		if (value.packArray()) {
+			return;
+		}
+		for (Value& element : value.mArray) {
+			packNumericArrays(element);
+		}
+	}
+	else if (value.isObject()) {
+		for (NameValuePair& nvp : value.mObject) {
+			packNumericArrays(nvp.mName);
+			packNumericArrays(nvp.mValue);
+		}
+	}
+}
+
 void cfg::NameValuePair::clear()
 {
 	mName.clear();
@@ -1,5 +1,6 @@
 #include <cfg/cfg_cppstring.h>
 #include <cfg/cfg.h>
+#include <cfg/cfg_number.h>
 #include <sstream>
 
 namespace {
@@ -34,6 +35,11 @@ namespace {
 std::string cfg::cppstring::valueToString(unsigned int deep,
 		const Value &cfgValue, bool addFormatArguments, bool addIndentation)
 {
+	if (cfgValue.isPackedArray()) {
+		Value unpacked = cfgValue;
+		unpacked.unpackArray();
+		return valueToString(deep, unpacked, addFormatArguments, addIndentation);
+	}
 	std::string ns = "cfg";
 	std::stringstream ss;
 	bool addVector = false;
@@ -59,9 +65,18 @@ std::string cfg::cppstring::valueToString(unsigned int deep,
 		case Value::TYPE_INT:
 			ss << "intValue(" << cfgValue.mInteger;
 			if (cfgValue.mParseBase != 10) {
-				ss << ", " << cfgValue.mParseBase;
+				ss << ", " << static_cast<int>(cfgValue.mParseBase);
 			}
 			break;
+		case Value::TYPE_INT64:
+			ss << "int64Value(INT64_C(" << cfgValue.mInteger64 << ")";
+			if (cfgValue.mParseBase != 10) {
+				ss << ", " << static_cast<int>(cfgValue.mParseBase);
+			}
+			break;
+		case Value::TYPE_DOUBLE:
+			ss << "doubleValue(" << number::doubleToString(cfgValue.mDouble, true);
+			break;
 		case Value::TYPE_TEXT:
 			// TODO escape special characters
 			ss << "text(\"" << cfgValue.mText << "\"";
@@ -1,38 +1,40 @@
 #include <cfg/cfg_creator.h>
 #include <sstream>
 
-namespace
+cfg::CfgCreator::CfgCreator()
 {
-	cfg::Value& getCurrent(cfg::Value& cfg, unsigned int deep, unsigned int arrayIndex)
-	{
-		if (deep == 0) {
-			return cfg;
-		}
-		// --> deep > 1
-		if (cfg.isObject()) {
-			if (cfg.mObject.empty()) {
-				cfg.mObject.emplace_back();
+	mCfg.setObject();
+	mStack.push_back(&mCfg);
+}
 
-				cfg.mObject.back().mName.setNull();
-				cfg.mObject.back().mValue.setObject();
-			}
-			return getCurrent(cfg.mObject.back().mValue, deep - 1, arrayIndex);
-		}
-		if (cfg.isArray()) {
-			// --> deep > 1
-			if (cfg.mArray.empty()) {
-				cfg.mArray.emplace_back();
-				cfg.mArray.back().setObject();
-			}
-			return getCurrent(cfg.mArray.back(), deep - 1, arrayIndex);
-		}
-		return cfg;
-	}
+cfg::CfgCreator::CfgCreator(CfgCreator&& other)
+		:isParseTextWithQuotesForName(other.isParseTextWithQuotesForName),
+		isParseTextWithQuotesForValue(other.isParseTextWithQuotesForValue),
+		mCfg(std::move(other.mCfg)),
+		mStack(std::move(other.mStack)),
+		mAssign(other.mAssign),
+		mWarnings(std::move(other.mWarnings))
+{
+	// the children are moved with the buffers of their vectors
+	// --> only the root has a new address
+	mStack.front() = &mCfg;
+	other.restart();
 }
 
-cfg::CfgCreator::CfgCreator()
+cfg::CfgCreator& cfg::CfgCreator::operator=(CfgCreator&& other)
 {
-	mCfg.setObject();
+	if (this == &other) {
+		return *this;
+	}
+	isParseTextWithQuotesForName = other.isParseTextWithQuotesForName;
+	isParseTextWithQuotesForValue = other.isParseTextWithQuotesForValue;
+	mCfg = std::move(other.mCfg);
+	mStack = std::move(other.mStack);
+	mStack.front() = &mCfg;
+	mAssign = other.mAssign;
+	mWarnings = std::move(other.mWarnings);
+	other.restart();
+	return *this;
 }
 
 cfg::CfgCreator& cfg::CfgCreator::configParseTextWithQuotes(bool enable)
@@ -64,40 +66,34 @@ cfg::CfgCreator& cfg::CfgCreator::empty()
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::comment(const std::string& comment,
+cfg::CfgCreator& cfg::CfgCreator::comment(std::string comment,
 		bool withSpace)
 {
+	if (withSpace) {
+		comment.insert(comment.begin(), ' ');
+	}
 	Value& val = getCurrent();
 	if (val.isObject()) {
 		val.mObject.emplace_back();
-		if (withSpace) {
-			val.mObject.back().setComment(" " + comment);
-		}
-		else {
-			val.mObject.back().setComment(comment);
-		}
+		val.mObject.back().mName.setComment(std::move(comment));
 	}
 	else if (val.isArray()) {
 		val.mArray.emplace_back();
-		if (withSpace) {
-			val.mArray.back().setComment(" " + comment);
-		}
-		else {
-			val.mArray.back().setComment(comment);
-		}
+		val.mArray.back().setComment(std::move(comment));
 	}
 	checkForResetAssign();
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::pushObject(const std::string& name)
+cfg::CfgCreator& cfg::CfgCreator::pushObject(std::string name)
 {
 	Value& val = getCurrent();
 	if (val.isObject()) {
 		val.mObject.emplace_back();
-		val.mObject.back().setObject(name);
-		val.mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
-		++mDeep;
+		NameValuePair& nvp = val.mObject.back();
+		nvp.mName.setText(std::move(name), isParseTextWithQuotesForName);
+		nvp.mValue.setObject();
+		mStack.push_back(&nvp.mValue);
 	}
 	else if (val.isArray()) {
 		val.mArray.emplace_back();
@@ -105,7 +101,7 @@ cfg::CfgCreator& cfg::CfgCreator::pushObject(const std::string& name)
 			addWarning("pushObject: object name '" + name + "' is ignored inside an array.");
 		}
 		val.mArray.back().setObject();
-		++mDeep;
+		mStack.push_back(&val.mArray.back());
 	}
 	checkForResetAssign();
 	return *this;
@@ -115,8 +111,8 @@ cfg::CfgCreator& cfg::CfgCreator::popObject()
 {
 	Value& val = getCurrent();
 	if (val.isObject()) {
-		if (mDeep > 0) {
-			--mDeep;
+		if (mStack.size() > 1) {
+			mStack.pop_back();
 		}
 		else {
 			addWarning("popObject: deep is already 0.");
@@ -129,14 +125,15 @@ cfg::CfgCreator& cfg::CfgCreator::popObject()
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::pushArray(const std::string& name)
+cfg::CfgCreator& cfg::CfgCreator::pushArray(std::string name)
 {
 	Value& val = getCurrent();
 	if (val.isObject()) {
 		val.mObject.emplace_back();
-		val.mObject.back().setTextArray(name);
-		val.mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
-		++mDeep;
+		NameValuePair& nvp = val.mObject.back();
+		nvp.mName.setText(std::move(name), isParseTextWithQuotesForName);
+		nvp.mValue.setArray();
+		mStack.push_back(&nvp.mValue);
 	}
 	else if (val.isArray()) {
 		val.mArray.emplace_back();
@@ -144,7 +141,7 @@ cfg::CfgCreator& cfg::CfgCreator::pushArray(const std::string& name)
 			addWarning("pushArray: array name '" + name + "' is ignored inside an array.");
 		}
 		val.mArray.back().setArray();
-		++mDeep;
+		mStack.push_back(&val.mArray.back());
 	}
 	checkForResetAssign();
 	return *this;
@@ -154,8 +151,8 @@ cfg::CfgCreator& cfg::CfgCreator::popArray()
 {
 	Value& val = getCurrent();
 	if (val.isArray()) {
-		if (mDeep > 0) {
-			--mDeep;
+		if (mStack.size() > 1) {
+			mStack.pop_back();
 		}
 		else {
 			addWarning("popArray: deep is already 0.");
@@ -168,98 +165,56 @@ cfg::CfgCreator& cfg::CfgCreator::popArray()
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::nvpNull(const std::string& name)
+cfg::CfgCreator& cfg::CfgCreator::nvpNull(std::string name)
 {
-	Value& val = getCurrent();
-	if (val.isObject()) {
-		val.mObject.emplace_back();
-		val.mObject.back().mName.setText(name, isParseTextWithQuotesForName);
-		val.mObject.back().mValue.setNull();
-	}
-	else if (val.isArray()) {
-		val.mArray.emplace_back();
-		val.mArray.back().setObject();
-		val.mArray.back().mObject.emplace_back();
-		val.mArray.back().mObject.back().mName.setText(name, isParseTextWithQuotesForName);
-		val.mArray.back().mObject.back().mName.setNull();
+	NameValuePair* nvp = addNameValuePair();
+	if (nvp) {
+		nvp->mName.setText(std::move(name), isParseTextWithQuotesForName);
+		nvp->mValue.setNull();
 	}
 	checkForResetAssign();
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::nvpBool(const std::string& name, bool value)
+cfg::CfgCreator& cfg::CfgCreator::nvpBool(std::string name, bool value)
 {
-	Value& val = getCurrent();
-	if (val.isObject()) {
-		val.mObject.emplace_back();
-		val.mObject.back().setTextBool(name, value);
-		val.mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
-	}
-	else if (val.isArray()) {
-		val.mArray.emplace_back();
-		val.mArray.back().setObject();
-		val.mArray.back().mObject.emplace_back();
-		val.mArray.back().mObject.back().setTextBool(name, value);
-		val.mArray.back().mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
+	NameValuePair* nvp = addNameValuePair();
+	if (nvp) {
+		nvp->mName.setText(std::move(name), isParseTextWithQuotesForName);
+		nvp->mValue.setBool(value);
 	}
 	checkForResetAssign();
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::nvpFloat(const std::string& name, float value)
+cfg::CfgCreator& cfg::CfgCreator::nvpFloat(std::string name, float value)
 {
-	Value& val = getCurrent();
-	if (val.isObject()) {
-		val.mObject.emplace_back();
-		val.mObject.back().setTextFloat(name, value);
-		val.mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
-	}
-	else if (val.isArray()) {
-		val.mArray.emplace_back();
-		val.mArray.back().setObject();
-		val.mArray.back().mObject.emplace_back();
-		val.mArray.back().mObject.back().setTextFloat(name, value);
-		val.mArray.back().mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
+	NameValuePair* nvp = addNameValuePair();
+	if (nvp) {
+		nvp->mName.setText(std::move(name), isParseTextWithQuotesForName);
+		nvp->mValue.setFloatingPoint(value);
 	}
 	checkForResetAssign();
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::nvpInt(const std::string& name, int value)
+cfg::CfgCreator& cfg::CfgCreator::nvpInt(std::string name, int value)
 {
-	Value& val = getCurrent();
-	if (val.isObject()) {
-		val.mObject.emplace_back();
-		val.mObject.back().setTextInt(name, value);
-		val.mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
-	}
-	else if (val.isArray()) {
-		val.mArray.emplace_back();
-		val.mArray.back().setObject();
-		val.mArray.back().mObject.emplace_back();
-		val.mArray.back().mObject.back().setTextInt(name, value);
-		val.mArray.back().mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
+	NameValuePair* nvp = addNameValuePair();
+	if (nvp) {
+		nvp->mName.setText(std::move(name), isParseTextWithQuotesForName);
+		nvp->mValue.setInteger(value);
 	}
 	checkForResetAssign();
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::nvpText(const std::string& name, const std::string& value)
+cfg::CfgCreator& cfg::CfgCreator::nvpText(std::string name, std::string value)
 {
-	Value& val = getCurrent();
-	if (val.isObject()) {
-		val.mObject.emplace_back();
-		val.mObject.back().setTextText(name, value);
-		val.mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
-		val.mObject.back().mValue.mParseTextWithQuotes = isParseTextWithQuotesForValue;
-	}
-	else if (val.isArray()) {
-		val.mArray.emplace_back();
-		val.mArray.back().setObject();
-		val.mArray.back().mObject.emplace_back();
-		val.mArray.back().mObject.back().setTextText(name, value);
-		val.mArray.back().mObject.back().mName.mParseTextWithQuotes = isParseTextWithQuotesForName;
-		val.mArray.back().mObject.back().mValue.mParseTextWithQuotes = isParseTextWithQuotesForValue;
+	NameValuePair* nvp = addNameValuePair();
+	if (nvp) {
+		nvp->mName.setText(std::move(name), isParseTextWithQuotesForName);
+		nvp->mValue.setText(std::move(value), isParseTextWithQuotesForValue);
 	}
 	checkForResetAssign();
 	return *this;
@@ -369,13 +324,13 @@ cfg::CfgCreator& cfg::CfgCreator::valInt(int value)
 	return *this;
 }
 
-cfg::CfgCreator& cfg::CfgCreator::valText(const std::string& value)
+cfg::CfgCreator& cfg::CfgCreator::valText(std::string value)
 {
 	Value& val = getCurrent();
 	if (val.isObject()) {
 		if (!mAssign) {
 			val.mObject.emplace_back();
-			val.mObject.back().mName.setText(value, isParseTextWithQuotesForName);
+			val.mObject.back().mName.setText(std::move(value), isParseTextWithQuotesForName);
 		}
 		else {
 			if (val.mObject.empty()) {
@@ -383,13 +338,13 @@ cfg::CfgCreator& cfg::CfgCreator::valText(const std::string& value)
 				val.mObject.back().mName.setNull(); // set unused name to null
 				addWarning("valText: assign is used at an invalid status.");
 			}
-			val.mObject.back().mValue.setText(value, isParseTextWithQuotesForValue);
+			val.mObject.back().mValue.setText(std::move(value), isParseTextWithQuotesForValue);
 			mAssign = false;
 		}
 	}
 	else if (val.isArray()) {
 		val.mArray.emplace_back();
-		val.mArray.back().setText(value);
+		val.mArray.back().setText(std::move(value));
 		// Currently an array is only supported for a value by CfgCreator.
 		// Using an array for the name is currently NOT possible by the CfgCreator.
 		// --> use value
@@ -429,6 +384,21 @@ cfg::Value cfg::CfgCreator::getCfg() const
 	return mCfg;
 }
 
+cfg::Value cfg::CfgCreator::takeCfg()
+{
+	Value cfg = std::move(mCfg);
+	restart();
+	return cfg;
+}
+
+void cfg::CfgCreator::restart()
+{
+	mCfg.setObject();
+	mStack.clear();
+	mStack.push_back(&mCfg);
+	mAssign = false;
+}
+
 std::string cfg::CfgCreator::getWarningsAsString() const
 {
 	std::stringstream ss;
@@ -439,9 +409,21 @@ std::string cfg::CfgCreator::getWarningsAsString() const
 	return ss.str();
 }
 
-cfg::Value& cfg::CfgCreator::getCurrent()
+cfg::NameValuePair* cfg::CfgCreator::addNameValuePair()
 {
-	return ::getCurrent(mCfg, mDeep, 0);
+	Value& val = getCurrent();
+	if (val.isObject()) {
+		val.mObject.emplace_back();
+		return &val.mObject.back();
+	}
+	if (val.isArray()) {
+		// inside an array each name value pair is an own object
+		val.mArray.emplace_back();
+		val.mArray.back().setObject();
+		val.mArray.back().mObject.emplace_back();
+		return &val.mArray.back().mObject.back();
+	}
+	return nullptr;
 }
 
 void cfg::CfgCreator::addWarning(const std::string& warning)
@@ -12,8 +12,10 @@ const char* cfg::enumstring::getValueTypeAsString(Value::EValueType valueType)
 			"TYPE_COMMENT",
 			"TYPE_ARRAY",
 			"TYPE_OBJECT",
+			"TYPE_INT64",
+			"TYPE_DOUBLE",
 
 			"error"
 	};
-	return strType[(valueType < 9) ? valueType : 9];
+	return strType[(valueType < 11) ? valueType : 11];
 }
@@ -0,0 +1,442 @@
+#include <cfg/cfg_frozen.h>
+#include <algorithm>
+#include <cstring>
+
+namespace cfg
+{
+	namespace
+	{
+		// FNV-1a (same as for CompiledSelectRules)
+		uint32_t getNameHash(const char* text, std::size_t length)
+		{
+			uint32_t hash = 2166136261u;
+			for (std::size_t i = 0; i < length; ++i) {
+				hash ^= static_cast<unsigned char>(text[i]);
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+
+		void countNodes(const Value& value, std::size_t& nodeCount,
+				std::size_t& stringPoolSize, std::size_t& memberCount)
+		{
+			++nodeCount;
+			if (value.mType == Value::TYPE_TEXT || value.mType == Value::TYPE_COMMENT) {
+				stringPoolSize += value.mText.size() + 1;
+			}
+			if (value.isPackedArray()) {
+				// elements are numbers --> no children and no texts
+				nodeCount += value.mPackedArray->size();
+			}
+			for (const Value& element : value.mArray) {
+				countNodes(element, nodeCount, stringPoolSize, memberCount);
+			}
+			for (const NameValuePair& nvp : value.mObject) {
+				if (nvp.mName.mType == Value::TYPE_TEXT) {
+					++memberCount;
+				}
+				countNodes(nvp.mName, nodeCount, stringPoolSize, memberCount);
+				countNodes(nvp.mValue, nodeCount, stringPoolSize, memberCount);
+			}
+		}
+	}
+}
+
+cfg::FrozenDocument::FrozenDocument()
+		:mNodes(1)
+{
+	setNode(0, Value());
+}
+
+cfg::FrozenDocument::FrozenDocument(const Value& value)
+{
+	std::size_t nodeCount = 0;
+	std::size_t stringPoolSize = 0;
+	std::size_t memberCount = 0;
+	countNodes(value, nodeCount, stringPoolSize, memberCount);
+	mNodes.reserve(nodeCount);
+	mStrings.reserve(stringPoolSize);
+	mMembers.reserve(memberCount);
+	mNodes.resize(1);
+	setNode(0, value);
+}
+
+cfg::FrozenDocument::FrozenDocument(FrozenDocument&& other) noexcept
+		:mNodes(std::move(other.mNodes)),
+		mMembers(std::move(other.mMembers)),
+		mStrings(std::move(other.mStrings))
+{
+}
+
+cfg::FrozenDocument& cfg::FrozenDocument::operator=(FrozenDocument&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+	mNodes = std::move(other.mNodes);
+	mMembers = std::move(other.mMembers);
+	mStrings = std::move(other.mStrings);
+	return *this;
+}
+
+void cfg::FrozenDocument::setNode(uint32_t index, const Value& value)
+{
+	// mNodes can be reallocated by the children --> no reference to the node
+	Node node;
+	node.mInteger64 = value.getInteger64();
+	node.mDouble = value.getDouble();
+	node.mFloatingPoint = value.mFloatingPoint;
+	node.mInteger = value.mInteger;
+	node.mBegin = 0;
+	node.mSize = 0;
+	node.mMemberBegin = 0;
+	node.mMemberCount = 0;
+	node.mType = static_cast<uint8_t>(value.mType);
+	node.mParseBase = static_cast<uint8_t>(value.mParseBase);
+	node.mBool = value.mBool;
+	node.mParseTextWithQuotes = value.mParseTextWithQuotes;
+
+	switch (value.mType) {
+		case Value::TYPE_TEXT:
+		case Value::TYPE_COMMENT:
+			node.mBegin = static_cast<uint32_t>(mStrings.size());
+			node.mSize = static_cast<uint32_t>(value.mText.size());
+			mStrings.append(value.mText);
+			mStrings.push_back('\0');
+			mNodes[index] = node;
+			break;
+		case Value::TYPE_ARRAY: {
+			// the elements are contiguous --> reserve all of them before
+			// the children of the elements are added
+			std::size_t count = value.arraySize();
+			node.mBegin = static_cast<uint32_t>(mNodes.size());
+			node.mSize = static_cast<uint32_t>(count);
+			mNodes[index] = node;
+			mNodes.resize(mNodes.size() + count);
+			if (value.isPackedArray()) {
+				Value element;
+				for (std::size_t i = 0; i < count; ++i) {
+					value.mPackedArray->getElement(i, element);
+					setNode(node.mBegin + static_cast<uint32_t>(i), element);
+				}
+				break;
+			}
+			for (std::size_t i = 0; i < count; ++i) {
+				setNode(node.mBegin + static_cast<uint32_t>(i), value.mArray[i]);
+			}
+			break;
+		}
+		case Value::TYPE_OBJECT: {
+			std::size_t count = value.mObject.size();
+			node.mBegin = static_cast<uint32_t>(mNodes.size());
+			node.mSize = static_cast<uint32_t>(count);
+			node.mMemberBegin = static_cast<uint32_t>(mMembers.size());
+			for (std::size_t i = 0; i < count; ++i) {
+				const Value& name = value.mObject[i].mName;
+				if (name.mType == Value::TYPE_TEXT) {
+					Member member;
+					member.mHash = getNameHash(name.mText.c_str(), name.mText.size());
+					member.mPairIndex = static_cast<uint32_t>(i);
+					mMembers.push_back(member);
+				}
+			}
+			node.mMemberCount = static_cast<uint32_t>(mMembers.size()) - node.mMemberBegin;
+			// sorted by hash and for the same hash by pair index
+			// --> the first found pair is the first pair of the object
+			std::sort(mMembers.begin() + node.mMemberBegin, mMembers.end(),
+					[](const Member& a, const Member& b) {
+						return a.mHash != b.mHash ? a.mHash < b.mHash :
+								a.mPairIndex < b.mPairIndex;
+					});
+			mNodes[index] = node;
+			mNodes.resize(mNodes.size() + 2 * count);
+			for (std::size_t i = 0; i < count; ++i) {
+				uint32_t nameIndex = node.mBegin + 2 * static_cast<uint32_t>(i);
+				setNode(nameIndex, value.mObject[i].mName);
+				setNode(nameIndex + 1, value.mObject[i].mValue);
+			}
+			break;
+		}
+		default:
+			mNodes[index] = node;
+			break;
+	}
+}
+
+int cfg::FrozenDocument::findPair(const Node& object, const std::string& attrName,
+		bool unique) const
+{
+	if (object.mType != Value::TYPE_OBJECT || !object.mMemberCount) {
+		return -1;
+	}
+	uint32_t hash = getNameHash(attrName.c_str(), attrName.size());
+	std::vector<Member>::const_iterator begin = mMembers.begin() + object.mMemberBegin;
+	std::vector<Member>::const_iterator end = begin + object.mMemberCount;
+	std::vector<Member>::const_iterator it = std::lower_bound(begin, end, hash,
+			[](const Member& member, uint32_t h) { return member.mHash < h; });
+	int found = -1;
+	for (; it != end && it->mHash == hash; ++it) {
+		const Node& name = mNodes[object.mBegin + 2 * it->mPairIndex];
+		if (name.mSize != attrName.size() ||
+				memcmp(mStrings.data() + name.mBegin, attrName.data(), name.mSize) != 0) {
+			continue;
+		}
+		if (found >= 0) {
+			// --> more than once
+			return -1;
+		}
+		found = static_cast<int>(it->mPairIndex);
+		if (!unique) {
+			break;
+		}
+	}
+	return found;
+}
+
+cfg::Value::EValueType cfg::FrozenValue::getType() const
+{
+	if (!mDoc) {
+		return Value::TYPE_NONE;
+	}
+	return static_cast<Value::EValueType>(mDoc->mNodes[mIndex].mType);
+}
+
+bool cfg::FrozenValue::getBool() const
+{
+	return mDoc ? mDoc->mNodes[mIndex].mBool : false;
+}
+
+float cfg::FrozenValue::getFloatingPoint() const
+{
+	return mDoc ? mDoc->mNodes[mIndex].mFloatingPoint : 0.0f;
+}
+
+int cfg::FrozenValue::getInteger() const
+{
+	return mDoc ? mDoc->mNodes[mIndex].mInteger : 0;
+}
+
+int64_t cfg::FrozenValue::getInteger64() const
+{
+	return mDoc ? mDoc->mNodes[mIndex].mInteger64 : 0;
+}
+
+double cfg::FrozenValue::getDouble() const
+{
+	return mDoc ? mDoc->mNodes[mIndex].mDouble : 0.0;
+}
+
+const char* cfg::FrozenValue::getText() const
+{
+	if (!isText() && !isComment()) {
+		return "";
+	}
+	return mDoc->mStrings.c_str() + mDoc->mNodes[mIndex].mBegin;
+}
+
+std::size_t cfg::FrozenValue::getTextLength() const
+{
+	if (!isText() && !isComment()) {
+		return 0;
+	}
+	return mDoc->mNodes[mIndex].mSize;
+}
+
+bool cfg::FrozenValue::isTextEqual(const std::string& text) const
+{
+	return isText() && getTextLength() == text.size() &&
+			memcmp(getText(), text.data(), text.size()) == 0;
+}
+
+bool cfg::FrozenValue::getParseTextWithQuotes() const
+{
+	return mDoc ? mDoc->mNodes[mIndex].mParseTextWithQuotes : false;
+}
+
+unsigned int cfg::FrozenValue::getParseBase() const
+{
+	return mDoc ? mDoc->mNodes[mIndex].mParseBase : 0;
+}
+
+std::size_t cfg::FrozenValue::arraySize() const
+{
+	return isArray() ? mDoc->mNodes[mIndex].mSize : 0;
+}
+
+cfg::FrozenValue cfg::FrozenValue::arrayAt(std::size_t index) const
+{
+	if (index >= arraySize()) {
+		return FrozenValue();
+	}
+	return FrozenValue(mDoc, mDoc->mNodes[mIndex].mBegin + static_cast<uint32_t>(index));
+}
+
+std::size_t cfg::FrozenValue::objectSize() const
+{
+	return isObject() ? mDoc->mNodes[mIndex].mSize : 0;
+}
+
+cfg::FrozenValue cfg::FrozenValue::objectNameAt(std::size_t index) const
+{
+	if (index >= objectSize()) {
+		return FrozenValue();
+	}
+	return FrozenValue(mDoc, mDoc->mNodes[mIndex].mBegin + 2 * static_cast<uint32_t>(index));
+}
+
+cfg::FrozenValue cfg::FrozenValue::objectValueAt(std::size_t index) const
+{
+	if (index >= objectSize()) {
+		return FrozenValue();
+	}
+	return FrozenValue(mDoc, mDoc->mNodes[mIndex].mBegin + 2 * static_cast<uint32_t>(index) + 1);
+}
+
+cfg::FrozenValue cfg::FrozenValue::objectGetValue(const std::string& attrName) const
+{
+	if (!mDoc) {
+		return FrozenValue();
+	}
+	int pairIndex = mDoc->findPair(mDoc->mNodes[mIndex], attrName, true);
+	if (pairIndex < 0) {
+		return FrozenValue();
+	}
+	return objectValueAt(static_cast<std::size_t>(pairIndex));
+}
+
+int cfg::FrozenValue::objectGetAttrIndex(const std::string& attrName) const
+{
+	if (!mDoc) {
+		return -1;
+	}
+	return mDoc->findPair(mDoc->mNodes[mIndex], attrName, false);
+}
+
+bool cfg::FrozenValue::objectGetText(const std::string& attrName,
+		std::string& attrValue) const
+{
+	FrozenValue value = objectGetValue(attrName);
+	if (!value.isText()) {
+		return false;
+	}
+	attrValue.assign(value.getText(), value.getTextLength());
+	return true;
+}
+
+std::string cfg::FrozenValue::objectGetText(const std::string& attrName) const
+{
+	std::string attrValue;
+	if (!objectGetText(attrName, attrValue)) {
+		return "";
+	}
+	return attrValue;
+}
+
+bool cfg::FrozenValue::objectGetInteger(const std::string& attrName, int& attrValue) const
+{
+	FrozenValue value = objectGetValue(attrName);
+	if (!value.isInteger()) {
+		return false;
+	}
+	attrValue = value.getInteger();
+	return true;
+}
+
+int cfg::FrozenValue::objectGetInteger(const std::string& attrName) const
+{
+	int attrValue = 0;
+	if (!objectGetInteger(attrName, attrValue)) {
+		return 0;
+	}
+	return attrValue;
+}
+
+bool cfg::FrozenValue::objectGetFloat(const std::string& attrName, bool allowInteger,
+		float& attrValue) const
+{
+	FrozenValue value = objectGetValue(attrName);
+	if (!value.isFloat() && !value.isDouble() &&
+			(!allowInteger || (!value.isInteger() && !value.isInteger64()))) {
+		return false;
+	}
+	// if it is an integer then the floating point member also has the correct value
+	attrValue = value.getFloatingPoint();
+	return true;
+}
+
+float cfg::FrozenValue::objectGetFloat(const std::string& attrName, bool allowInteger) const
+{
+	float attrValue = 0.0f;
+	if (!objectGetFloat(attrName, allowInteger, attrValue)) {
+		return 0.0f;
+	}
+	return attrValue;
+}
+
+bool cfg::FrozenValue::objectGetBool(const std::string& attrName, bool& attrValue) const
+{
+	FrozenValue value = objectGetValue(attrName);
+	if (!value.isBool()) {
+		return false;
+	}
+	attrValue = value.getBool();
+	return true;
+}
+
+bool cfg::FrozenValue::objectGetBool(const std::string& attrName) const
+{
+	bool attrValue = false;
+	if (!objectGetBool(attrName, attrValue)) {
+		return false;
+	}
+	return attrValue;
+}
+
+cfg::Value cfg::FrozenValue::toValue() const
+{
+	Value value;
+	if (mDoc) {
+		toValue(value);
+	}
+	return value;
+}
+
+void cfg::FrozenValue::toValue(Value& outValue) const
+{
+	const FrozenDocument::Node& node = mDoc->mNodes[mIndex];
+	// releases a packed array of outValue before mType is overwritten
+	outValue.clear();
+	outValue.mType = static_cast<Value::EValueType>(node.mType);
+	outValue.mBool = node.mBool;
+	outValue.mFloatingPoint = node.mFloatingPoint;
+	outValue.mInteger = node.mInteger;
+	if (outValue.mType == Value::TYPE_DOUBLE) {
+		outValue.mDouble = node.mDouble;
+	}
+	else if (outValue.mType == Value::TYPE_INT64) {
+		outValue.mInteger64 = node.mInteger64;
+	}
+	outValue.mParseBase = node.mParseBase;
+	outValue.mParseTextWithQuotes = node.mParseTextWithQuotes;
+	switch (outValue.mType) {
+		case Value::TYPE_TEXT:
+		case Value::TYPE_COMMENT:
+			outValue.mText.assign(getText(), getTextLength());
+			break;
+		case Value::TYPE_ARRAY:
+			outValue.mArray.resize(node.mSize);
+			for (std::size_t i = 0; i < node.mSize; ++i) {
+				arrayAt(i).toValue(outValue.mArray[i]);
+			}
+			break;
+		case Value::TYPE_OBJECT:
+			outValue.mObject.resize(node.mSize);
+			for (std::size_t i = 0; i < node.mSize; ++i) {
+				objectNameAt(i).toValue(outValue.mObject[i].mName);
+				objectValueAt(i).toValue(outValue.mObject[i].mValue);
+			}
+			break;
+		default:
+			break;
+	}
+}
@@ -1,5 +1,6 @@
 #include <cfg/cfg_include.h>
 #include <cfg/file_loader.h>
+#include <cfg/cfg_pair_splicer.h>
 
 #define MAX_RECURSIVE_DEEP 50
 
@@ -57,6 +58,8 @@ namespace
 			return false;
 		}
 		std::vector<NameValuePair>& pairs = cfgValue.mObject;
+		// pairs are not reallocated before splicer.finish()
+		PairSplicer splicer(pairs);
 		std::size_t cnt = pairs.size();
 		for (std::size_t i = 0; i < cnt; ++i) {
 			NameValuePair& nvp = pairs[i];
@@ -195,24 +198,11 @@ namespace
 				includeValue.mObject.back().mValue = std::move(nvp.mValue);
 			}
 
-			if (includeValue.mObject.empty()) {
-				pairs.erase(pairs.begin() + i);
-				--i;
-				--cnt;
-			}
-			else if (includeValue.mObject.size() == 1) {
-				nvp = std::move(includeValue.mObject[0]);
-			}
-			else {
-				pairs[i] = std::move(includeValue.mObject[0]);
-				pairs.insert(pairs.begin() + i + 1,
-						std::make_move_iterator(includeValue.mObject.begin() + 1),
-						std::make_move_iterator(includeValue.mObject.end()));
-				std::size_t increaseCount = includeValue.mObject.size() - 1;
-				i += increaseCount;
-				cnt += increaseCount;
-			}
+			// The included pairs are already processed (no include
+			// statements) --> nvp is replaced by all of them.
+			splicer.replace(i, includeValue.mObject);
 		}
+		splicer.finish();
 		return true;
 	}
 
@@ -230,6 +220,8 @@ namespace
 			return false;
 		}
 		std::vector<NameValuePair>& pairs = cfgValue.mObject;
+		// pairs are not reallocated before splicer.finish()
+		PairSplicer splicer(pairs);
 		std::size_t cnt = pairs.size();
 		for (std::size_t i = 0; i < cnt; ++i) {
 			NameValuePair& nvp = pairs[i];
@@ -394,23 +386,11 @@ namespace
 				includeValue.mObject.back().mValue = std::move(nvp.mValue);
 			}
 
-			if (includeValue.mObject.empty()) {
-				pairs.erase(pairs.begin() + i);
-				--i;
-				--cnt;
-			} else if (includeValue.mObject.size() == 1) {
-				nvp = std::move(includeValue.mObject[0]);
-			} else {
-				pairs[i] = std::move(includeValue.mObject[0]);
-				pairs.insert(pairs.begin() + i + 1,
-						std::make_move_iterator(includeValue.mObject.begin() + 1),
-						std::make_move_iterator(includeValue.mObject.end()));
-				std::size_t increaseCount =
-						includeValue.mObject.size() - 1;
-				i += increaseCount;
-				cnt += increaseCount;
-			}
+			// The included pairs are already processed (no include
+			// statements) --> nvp is replaced by all of them.
+			splicer.replace(i, includeValue.mObject);
 		}
+		splicer.finish();
 		return true;
 	}
 } // namespace {}
@@ -0,0 +1,269 @@
+#include <cfg/cfg_number.h>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <locale>
+#include <sstream>
+
+namespace cfg
+{
+	namespace
+	{
+		// powers of ten which are exactly representable as double
+		const double powersOfTen[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+		const int maxFastPathExponent = 22;
+		// greatest integer up to which all integers are exact doubles
+		const uint64_t maxExactMantissa = uint64_t(1) << 53;
+		// a uint64_t can store all numbers with 19 digits
+		const unsigned int maxMantissaDigitCount = 19;
+		// Numbers with up to FLT_DIG significant digits are the same
+		// after text -> float -> text. The text of a float has no exponent
+		// (std::ostream with default precision 6) in this range.
+		const unsigned int maxFloatDigitCount = FLT_DIG;
+		const double minFloatWithoutExponent = 1e-4;
+		const double maxFloatWithoutExponent = 1e6;
+
+		bool isDigit(char ch)
+		{
+			return ch >= '0' && ch <= '9';
+		}
+
+		bool isSameDouble(double a, double b)
+		{
+			// without == because of -Wfloat-equal
+			return !(a < b) && !(b < a);
+		}
+	}
+}
+
+bool cfg::number::parseNumber(const char* begin, const char* end,
+		bool allowExponent, Value& outValue)
+{
+	const char* p = begin;
+	bool negative = false;
+	if (p < end && (*p == '+' || *p == '-')) {
+		negative = (*p == '-');
+		++p;
+	}
+
+	// Number = mantissa * 10^exponent. The mantissa stores at most 19
+	// significant digits. If more digits exist then truncated is true.
+	uint64_t mantissa = 0;
+	unsigned int significantDigitCount = 0;
+	bool truncated = false;
+	int exponent = 0;
+	unsigned int digitCount = 0;
+	bool isInteger = true;
+	for (; p < end && isDigit(*p); ++p) {
+		++digitCount;
+		unsigned int digit = static_cast<unsigned int>(*p - '0');
+		if (significantDigitCount < maxMantissaDigitCount) {
+			if (mantissa || digit) {
+				mantissa = mantissa * 10 + digit;
+				++significantDigitCount;
+			}
+		}
+		else {
+			++exponent;
+			truncated = truncated || digit;
+		}
+	}
+	if (p < end && *p == '.') {
+		isInteger = false;
+		++p;
+		for (; p < end && isDigit(*p); ++p) {
+			++digitCount;
+			unsigned int digit = static_cast<unsigned int>(*p - '0');
+			if (significantDigitCount < maxMantissaDigitCount) {
+				if (mantissa || digit) {
+					mantissa = mantissa * 10 + digit;
+					++significantDigitCount;
+				}
+				--exponent;
+			}
+			else {
+				truncated = truncated || digit;
+			}
+		}
+	}
+	if (digitCount == 0) {
+		return false;
+	}
+	if (allowExponent && p < end && (*p == 'e' || *p == 'E')) {
+		isInteger = false;
+		++p;
+		bool negativeExponent = false;
+		if (p < end && (*p == '+' || *p == '-')) {
+			negativeExponent = (*p == '-');
+			++p;
+		}
+		if (p >= end || !isDigit(*p)) {
+			return false;
+		}
+		int exponentValue = 0;
+		for (; p < end && isDigit(*p); ++p) {
+			// greater exponents are anyway out of range (inf or 0.0)
+			if (exponentValue < 100000) {
+				exponentValue = exponentValue * 10 + (*p - '0');
+			}
+		}
+		exponent += negativeExponent ? -exponentValue : exponentValue;
+	}
+	if (p != end) {
+		return false;
+	}
+
+	if (isInteger && exponent == 0) {
+		if (!negative && mantissa <= static_cast<uint64_t>(INT_MAX)) {
+			outValue.setInteger(static_cast<int>(mantissa), 10);
+			return true;
+		}
+		if (negative && mantissa <= static_cast<uint64_t>(INT_MAX) + 1) {
+			outValue.setInteger(static_cast<int>(-static_cast<int64_t>(mantissa)), 10);
+			return true;
+		}
+		if (!negative && mantissa <= static_cast<uint64_t>(INT64_MAX)) {
+			outValue.setInteger64(static_cast<int64_t>(mantissa), 10);
+			return true;
+		}
+		if (negative && mantissa <= static_cast<uint64_t>(INT64_MAX) + 1) {
+			outValue.setInteger64((mantissa == static_cast<uint64_t>(INT64_MAX) + 1) ?
+					INT64_MIN : -static_cast<int64_t>(mantissa), 10);
+			return true;
+		}
+		// --> out of range of int64_t --> stored as double
+	}
+
+	double value = 0.0;
+	if (!truncated && mantissa <= maxExactMantissa &&
+			exponent >= -maxFastPathExponent && exponent <= maxFastPathExponent) {
+		// Fast path: mantissa and 10^exponent are exact doubles. Therefore
+		// the result of one multiplication or division is correctly rounded.
+		value = static_cast<double>(mantissa);
+		if (exponent < 0) {
+			value /= powersOfTen[-exponent];
+		}
+		else {
+			value *= powersOfTen[exponent];
+		}
+		if (negative) {
+			value = -value;
+		}
+	}
+	else {
+		value = stringToDouble(std::string(begin, end));
+	}
+
+	if (isInteger) {
+		outValue.setDouble(value);
+		return true;
+	}
+	// trailing zeros are not significant (1.500 is 1.5)
+	while (mantissa && mantissa % 10 == 0) {
+		mantissa /= 10;
+		--significantDigitCount;
+	}
+	if (!truncated && significantDigitCount <= maxFloatDigitCount &&
+			(mantissa == 0 || (std::fabs(value) >= minFloatWithoutExponent &&
+			std::fabs(value) < maxFloatWithoutExponent))) {
+		outValue.setFloatingPoint(static_cast<float>(value));
+	}
+	else {
+		outValue.setDouble(value);
+	}
+	return true;
+}
+
+std::string cfg::number::doubleToString(double value, bool allowExponent)
+{
+	if (std::isnan(value)) {
+		return "nan";
+	}
+	if (std::isinf(value)) {
+		return (value < 0.0) ? "-inf" : "inf";
+	}
+	// Find the shortest precision which is parsed back to the same value.
+	// With 15 significant digits the decimal number is always the shortest
+	// (after removing the trailing zeros) if it is parsed back correctly.
+	std::ostringstream oss;
+	oss.imbue(std::locale::classic());
+	oss << std::scientific;
+	std::string text;
+	for (int digits = 15; digits <= 17; ++digits) {
+		oss.str(std::string());
+		oss.precision(digits - 1);
+		oss << value;
+		text = oss.str();
+		if (isSameDouble(stringToDouble(text), value)) {
+			break;
+		}
+	}
+
+	// text is [-]d.ddde[+-]dd
+	std::string result;
+	std::string digits;
+	const char* p = text.c_str();
+	if (*p == '-') {
+		result = "-";
+		++p;
+	}
+	for (; *p && *p != 'e'; ++p) {
+		if (isDigit(*p)) {
+			digits.push_back(*p);
+		}
+	}
+	int exponent = (*p == 'e') ? atoi(p + 1) : 0;
+	while (digits.size() > 1 && digits.back() == '0') {
+		digits.pop_back();
+	}
+
+	if (allowExponent && (exponent < -5 || exponent > 20)) {
+		result += digits[0];
+		result += '.';
+		result += (digits.size() > 1) ? digits.substr(1) : "0";
+		result += (exponent < 0) ? "e-" : "e+";
+		result += std::to_string((exponent < 0) ? -exponent : exponent);
+		return result;
+	}
+	// count of digits in front of the decimal point
+	int integerDigitCount = exponent + 1;
+	if (integerDigitCount <= 0) {
+		result += "0.";
+		result.append(static_cast<std::size_t>(-integerDigitCount), '0');
+		result += digits;
+	}
+	else if (static_cast<std::size_t>(integerDigitCount) >= digits.size()) {
+		result += digits;
+		result.append(integerDigitCount - digits.size(), '0');
+		result += ".0";
+	}
+	else {
+		result += digits.substr(0, integerDigitCount);
+		result += '.';
+		result += digits.substr(integerDigitCount);
+	}
+	return result;
+}
+
+double cfg::number::stringToDouble(const std::string& text)
+{
+	std::istringstream iss(text);
+	iss.imbue(std::locale::classic());
+	double value = 0.0;
+	iss >> value;
+	if (iss.fail()) {
+		// out of range --> the stream returns +-DBL_MAX (strtod() +-inf)
+		if (value >= DBL_MAX) {
+			return HUGE_VAL;
+		}
+		if (value <= -DBL_MAX) {
+			return -HUGE_VAL;
+		}
+		return 0.0;
+	}
+	return value;
+}
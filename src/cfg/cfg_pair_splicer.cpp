@@ -0,0 +1,55 @@
+#include <cfg/cfg_pair_splicer.h>
+#include <iterator>
+
+cfg::PairSplicer::PairSplicer(std::vector<NameValuePair>& pairs)
+		:mPairs(pairs),
+		mNewPairs(),
+		mNextIndex(0),
+		mIsUsed(false)
+{
+}
+
+void cfg::PairSplicer::moveUntil(std::size_t index)
+{
+	if (!mIsUsed) {
+		mIsUsed = true;
+		mNewPairs.reserve(mPairs.size());
+	}
+	mNewPairs.insert(mNewPairs.end(),
+			std::make_move_iterator(mPairs.begin() + mNextIndex),
+			std::make_move_iterator(mPairs.begin() + index));
+	mNextIndex = index;
+}
+
+void cfg::PairSplicer::replace(std::size_t index,
+		std::vector<NameValuePair>& newPairs)
+{
+	if (newPairs.size() == 1) {
+		// count of pairs is unchanged --> replace in place
+		mPairs[index] = std::move(newPairs[0]);
+		return;
+	}
+	moveUntil(index);
+	mNewPairs.insert(mNewPairs.end(),
+			std::make_move_iterator(newPairs.begin()),
+			std::make_move_iterator(newPairs.end()));
+	mNextIndex = index + 1;
+}
+
+void cfg::PairSplicer::erase(std::size_t index)
+{
+	moveUntil(index);
+	mNextIndex = index + 1;
+}
+
+void cfg::PairSplicer::finish()
+{
+	if (!mIsUsed) {
+		return;
+	}
+	moveUntil(mPairs.size());
+	mPairs.swap(mNewPairs);
+	mNewPairs.clear();
+	mNextIndex = 0;
+	mIsUsed = false;
+}
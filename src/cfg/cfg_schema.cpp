@@ -122,7 +122,7 @@ namespace cfg {
 					outErrorMsg = cfgMinMax.getFilenameAndPosition() + ": " + keyword + " is already used.";
 					return false;
 				}
-				if (cfgMinMax.isFloat()) {
+				if (cfgMinMax.isFloat() || cfgMinMax.isDouble()) {
 					float& floatMinMax = isMin ? nvfs.mFloatMin : nvfs.mFloatMax;
 					floatMinMax = cfgMinMax.mFloatingPoint;
 					floatMinMaxUsed = true;
@@ -0,0 +1,586 @@
+#include <cfg/cfg_schema_validator.h>
+#include <cfg/cfg_enum_string.h>
+
+namespace cfg
+{
+	namespace
+	{
+		unsigned int getTypeFlag(const Value& value)
+		{
+			switch (value.mType) {
+				case Value::TYPE_NONE:    return SelectRule::ALLOW_NONE;
+				case Value::TYPE_NULL:    return SelectRule::ALLOW_NULL;
+				case Value::TYPE_BOOL:    return SelectRule::ALLOW_BOOL;
+				case Value::TYPE_FLOAT:   return SelectRule::ALLOW_FLOAT;
+				case Value::TYPE_INT:     return SelectRule::ALLOW_INT;
+				case Value::TYPE_TEXT:    return SelectRule::ALLOW_TEXT;
+				case Value::TYPE_COMMENT: return 0;
+				case Value::TYPE_ARRAY:   return SelectRule::ALLOW_ARRAY;
+				case Value::TYPE_OBJECT:  return SelectRule::ALLOW_OBJECT;
+				case Value::TYPE_INT64:   return SelectRule::ALLOW_INT;
+				case Value::TYPE_DOUBLE:  return SelectRule::ALLOW_FLOAT;
+			}
+			return 0;
+		}
+
+		// FNV-1a
+		unsigned int getHash(const std::string& text)
+		{
+			unsigned int hash = 2166136261u;
+			for (char ch : text) {
+				hash ^= static_cast<unsigned char>(ch);
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+
+		double getNumber(const Value& value)
+		{
+			// no loss for all number types
+			return value.getDouble();
+		}
+
+		bool isEqual(const Value& a, const Value& b)
+		{
+			if (a.isNumber() && b.isNumber()) {
+				// integer and float can be compared (10 is equal to 10.0).
+				// Without == because of -Wfloat-equal.
+				double na = getNumber(a);
+				double nb = getNumber(b);
+				return !(na < nb) && !(nb < na);
+			}
+			if (a.mType != b.mType) {
+				return false;
+			}
+			switch (a.mType) {
+				case Value::TYPE_NONE:
+				case Value::TYPE_NULL:
+					return true;
+				case Value::TYPE_BOOL:
+					return a.mBool == b.mBool;
+				case Value::TYPE_TEXT:
+				case Value::TYPE_COMMENT:
+					return a.mText == b.mText;
+				case Value::TYPE_ARRAY:
+					if (a.isPackedArray() || b.isPackedArray()) {
+						// compare the elements of a packed array as values
+						Value unpackedA = a;
+						Value unpackedB = b;
+						unpackedA.unpackArray();
+						unpackedB.unpackArray();
+						return isEqual(unpackedA, unpackedB);
+					}
+					if (a.mArray.size() != b.mArray.size()) {
+						return false;
+					}
+					for (size_t i = 0; i < a.mArray.size(); ++i) {
+						if (!isEqual(a.mArray[i], b.mArray[i])) {
+							return false;
+						}
+					}
+					return true;
+				case Value::TYPE_FLOAT:
+				case Value::TYPE_INT:
+				case Value::TYPE_INT64:
+				case Value::TYPE_DOUBLE:
+				case Value::TYPE_OBJECT:
+					// numbers are already handled and an object is not
+					// supported as value for the keyword 'value'
+					break;
+			}
+			return false;
+		}
+	}
+}
+
+bool cfg::SchemaValidator::compile(const NVFragmentSchema& nvfs,
+		std::string& outErrorMsg)
+{
+	mObjects.clear();
+	mMembers.clear();
+	mConstants.clear();
+	mNameEntries.clear();
+	mNameSlots.clear();
+	mPatternMembers.clear();
+	mMemberStamps.clear();
+	mStreamStack.clear();
+	mStamp = 0;
+	mViolationCount = 0;
+
+	if (nvfs.mObject.empty()) {
+		outErrorMsg = "schema must be an object schema";
+		return false;
+	}
+	unsigned int objectIndex = 0;
+	if (!compileObject(objectIndex, nvfs, outErrorMsg)) {
+		mObjects.clear();
+		return false;
+	}
+	mMemberStamps.resize(mMembers.size(), 0);
+	return true;
+}
+
+bool cfg::SchemaValidator::validate(const Value& cfgValue, std::string& outErrorMsg)
+{
+	outErrorMsg.clear();
+	mViolationCount = 0;
+	if (!isCompiled()) {
+		outErrorMsg = "no schema is compiled";
+		++mViolationCount;
+		return false;
+	}
+	if (!cfgValue.isObject()) {
+		addViolation(cfgValue, "value must be an object", outErrorMsg);
+		return false;
+	}
+	validateObject(0, cfgValue, cfgValue, outErrorMsg);
+	return mViolationCount == 0;
+}
+
+bool cfg::SchemaValidator::compileFragment(Fragment& outFragment,
+		const NVFragmentSchema& nvfs, bool valueIsUsed, std::string& outErrorMsg)
+{
+	outFragment = Fragment();
+	if (!valueIsUsed) {
+		// no schema for the value --> only an empty value is allowed
+		outFragment.mAllowedTypes = SelectRule::ALLOW_NONE;
+		return true;
+	}
+	if (!nvfs.mArray.empty()) {
+		outErrorMsg = "array schema is not supported";
+		return false;
+	}
+	if (!nvfs.mObject.empty()) {
+		unsigned int objectIndex = 0;
+		if (!compileObject(objectIndex, nvfs, outErrorMsg)) {
+			return false;
+		}
+		// outFragment is not invalidated by compileObject() because
+		// it's a copy (see compileObject())
+		outFragment.mAllowedTypes = SelectRule::ALLOW_OBJECT;
+		outFragment.mObjectIndex = static_cast<int>(objectIndex);
+		return true;
+	}
+	outFragment.mAllowedTypes = nvfs.mAllowedTypes;
+	if (nvfs.mIntMinUsed) {
+		outFragment.mFlags |= FLAG_INT_MIN;
+		outFragment.mIntMin = nvfs.mIntMin;
+	}
+	if (nvfs.mIntMaxUsed) {
+		outFragment.mFlags |= FLAG_INT_MAX;
+		outFragment.mIntMax = nvfs.mIntMax;
+	}
+	if (nvfs.mFloatMinUsed) {
+		outFragment.mFlags |= FLAG_FLOAT_MIN;
+		outFragment.mFloatMin = nvfs.mFloatMin;
+	}
+	if (nvfs.mFloatMaxUsed) {
+		outFragment.mFlags |= FLAG_FLOAT_MAX;
+		outFragment.mFloatMax = nvfs.mFloatMax;
+	}
+	if (nvfs.mValueIsUsed) {
+		outFragment.mFlags |= FLAG_VALUE;
+		outFragment.mConstBegin = static_cast<unsigned int>(mConstants.size());
+		if (nvfs.mValue.isArray()) {
+			// more than one value --> each value is allowed
+			for (const Value& val : nvfs.mValue.mArray) {
+				mConstants.push_back(val);
+			}
+		}
+		else {
+			mConstants.push_back(nvfs.mValue);
+		}
+		outFragment.mConstCount = static_cast<unsigned int>(mConstants.size()) -
+				outFragment.mConstBegin;
+	}
+	return true;
+}
+
+bool cfg::SchemaValidator::compileObject(unsigned int& outObjectIndex,
+		const NVFragmentSchema& nvfs, std::string& outErrorMsg)
+{
+	// The members of an object must be stored contiguous. Therefore the
+	// members are reserved before nested objects are compiled.
+	// mMembers can be reallocated by nested objects --> work with copies.
+	outObjectIndex = static_cast<unsigned int>(mObjects.size());
+	mObjects.emplace_back();
+	unsigned int memberBegin = static_cast<unsigned int>(mMembers.size());
+	unsigned int memberCount = static_cast<unsigned int>(nvfs.mObject.size());
+	mMembers.resize(memberBegin + memberCount);
+
+	unsigned int requiredCount = 0;
+	// entries and pattern members of nested objects are added while
+	// compiling --> collect the own ones and add them at the end
+	std::vector<NameEntry> entries;
+	std::vector<unsigned int> patternMembers;
+	for (unsigned int i = 0; i < memberCount; ++i) {
+		const NVPSchema& nvps = nvfs.mObject[i];
+		Member member;
+		if (!compileFragment(member.mName, nvps.mName, true, outErrorMsg)) {
+			return false;
+		}
+		if (!compileFragment(member.mValue, nvps.mValue, nvps.mValueIsUsed, outErrorMsg)) {
+			return false;
+		}
+		bool hasFixedName = false;
+		if (member.mName.mFlags & FLAG_VALUE) {
+			hasFixedName = true;
+			for (unsigned int ci = 0; ci < member.mName.mConstCount; ++ci) {
+				if (!mConstants[member.mName.mConstBegin + ci].isText()) {
+					hasFixedName = false;
+				}
+			}
+		}
+		// a member with a name enumeration is also a fixed name but
+		// not required because only one of the names must exist
+		member.mRequired = hasFixedName && member.mName.mConstCount == 1 &&
+				!nvps.mValue.mDefaultIsUsed &&
+				!(member.mValue.mAllowedTypes & SelectRule::ALLOW_NONE);
+		if (member.mRequired) {
+			++requiredCount;
+		}
+		if (hasFixedName) {
+			for (unsigned int ci = 0; ci < member.mName.mConstCount; ++ci) {
+				NameEntry entry;
+				entry.mConstIndex = member.mName.mConstBegin + ci;
+				entry.mHash = getHash(mConstants[entry.mConstIndex].mText);
+				entry.mMemberIndex = memberBegin + i;
+				entries.push_back(entry);
+			}
+		}
+		else {
+			patternMembers.push_back(memberBegin + i);
+		}
+		mMembers[memberBegin + i] = member;
+	}
+
+	// create hash table (open addressing, linear probing) for the names
+	unsigned int slotCount = 1;
+	while (slotCount < entries.size() * 2) {
+		slotCount *= 2;
+	}
+	unsigned int slotBegin = static_cast<unsigned int>(mNameSlots.size());
+	unsigned int slotMask = slotCount - 1;
+	mNameSlots.resize(slotBegin + slotCount, 0);
+	for (const NameEntry& entry : entries) {
+		unsigned int slot = entry.mHash & slotMask;
+		while (mNameSlots[slotBegin + slot]) {
+			slot = (slot + 1) & slotMask;
+		}
+		mNameEntries.push_back(entry);
+		mNameSlots[slotBegin + slot] = static_cast<unsigned int>(mNameEntries.size());
+	}
+	unsigned int patternBegin = static_cast<unsigned int>(mPatternMembers.size());
+	mPatternMembers.insert(mPatternMembers.end(), patternMembers.begin(),
+			patternMembers.end());
+
+	Object& object = mObjects[outObjectIndex];
+	object.mMemberBegin = memberBegin;
+	object.mMemberCount = memberCount;
+	object.mRequiredCount = requiredCount;
+	object.mSlotBegin = slotBegin;
+	object.mSlotMask = slotMask;
+	object.mPatternBegin = patternBegin;
+	object.mPatternCount = static_cast<unsigned int>(mPatternMembers.size()) - patternBegin;
+	return true;
+}
+
+bool cfg::SchemaValidator::checkFragment(const Fragment& fragment,
+		const Value& value, const Value& positionValue, bool reportViolation,
+		std::string& outErrorMsg)
+{
+	if (fragment.mAllowedTypes && !(fragment.mAllowedTypes & getTypeFlag(value))) {
+		if (reportViolation) {
+			addViolation(positionValue, std::string("type ") +
+					enumstring::getValueTypeAsString(value.mType) + " is not allowed",
+					outErrorMsg);
+		}
+		return false;
+	}
+	if (fragment.mFlags & FLAG_VALUE) {
+		bool found = false;
+		for (unsigned int ci = 0; ci < fragment.mConstCount; ++ci) {
+			if (isEqual(mConstants[fragment.mConstBegin + ci], value)) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			if (reportViolation) {
+				addViolation(positionValue, "value is not allowed", outErrorMsg);
+			}
+			return false;
+		}
+	}
+	if (value.isNumber() && (fragment.mFlags & (FLAG_INT_MIN | FLAG_INT_MAX |
+			FLAG_FLOAT_MIN | FLAG_FLOAT_MAX))) {
+		double number = getNumber(value);
+		if (((fragment.mFlags & FLAG_INT_MIN) && number < fragment.mIntMin) ||
+				((fragment.mFlags & FLAG_FLOAT_MIN) && number < fragment.mFloatMin)) {
+			if (reportViolation) {
+				addViolation(positionValue, "value is less than min", outErrorMsg);
+			}
+			return false;
+		}
+		if (((fragment.mFlags & FLAG_INT_MAX) && number > fragment.mIntMax) ||
+				((fragment.mFlags & FLAG_FLOAT_MAX) && number > fragment.mFloatMax)) {
+			if (reportViolation) {
+				addViolation(positionValue, "value is greater than max", outErrorMsg);
+			}
+			return false;
+		}
+	}
+	if (fragment.mObjectIndex >= 0) {
+		if (reportViolation) {
+			validateObject(static_cast<unsigned int>(fragment.mObjectIndex),
+					value, positionValue, outErrorMsg);
+		}
+	}
+	return true;
+}
+
+int cfg::SchemaValidator::findMember(const Object& object, const Value& name,
+		std::string& outErrorMsg)
+{
+	if (name.isText() && object.mSlotMask) {
+		unsigned int hash = getHash(name.mText);
+		unsigned int slot = hash & object.mSlotMask;
+		for (;;) {
+			unsigned int entryIndex = mNameSlots[object.mSlotBegin + slot];
+			if (!entryIndex) {
+				break;
+			}
+			const NameEntry& entry = mNameEntries[entryIndex - 1];
+			if (entry.mHash == hash && mConstants[entry.mConstIndex].mText == name.mText &&
+					checkFragment(mMembers[entry.mMemberIndex].mName, name, name,
+					false, outErrorMsg)) {
+				return static_cast<int>(entry.mMemberIndex);
+			}
+			slot = (slot + 1) & object.mSlotMask;
+		}
+	}
+	for (unsigned int i = 0; i < object.mPatternCount; ++i) {
+		unsigned int memberIndex = mPatternMembers[object.mPatternBegin + i];
+		if (checkFragment(mMembers[memberIndex].mName, name, name, false, outErrorMsg)) {
+			return static_cast<int>(memberIndex);
+		}
+	}
+	return -1;
+}
+
+void cfg::SchemaValidator::beginObject(Frame& frame, int objectIndex)
+{
+	frame.mObjectIndex = objectIndex;
+	frame.mRequiredFound = 0;
+	frame.mStamp = ++mStamp;
+	if (frame.mStamp == 0) {
+		// overflow --> reset all stamps. Stamps of open objects (only
+		// possible for streaming) are also reset but this happens only
+		// after 2^32 objects.
+		for (unsigned int& s : mMemberStamps) {
+			s = 0;
+		}
+		frame.mStamp = mStamp = 1;
+	}
+}
+
+int cfg::SchemaValidator::useMember(Frame& frame, const Value& name,
+		std::string& outErrorMsg)
+{
+	const Object& object = mObjects[static_cast<unsigned int>(frame.mObjectIndex)];
+	int memberIndex = findMember(object, name, outErrorMsg);
+	if (memberIndex < 0) {
+		addViolation(name, name.isText() ?
+				"name '" + name.mText + "' is not allowed" :
+				std::string("name is not allowed"), outErrorMsg);
+		return -1;
+	}
+	const Member& member = mMembers[static_cast<unsigned int>(memberIndex)];
+	unsigned int& memberStamp = mMemberStamps[static_cast<unsigned int>(memberIndex)];
+	if (member.mName.mFlags & FLAG_VALUE) {
+		if (memberStamp == frame.mStamp) {
+			addViolation(name, "name '" + name.mText + "' is already used",
+					outErrorMsg);
+		}
+		else if (member.mRequired) {
+			++frame.mRequiredFound;
+		}
+	}
+	memberStamp = frame.mStamp;
+	return memberIndex;
+}
+
+void cfg::SchemaValidator::endObject(const Frame& frame,
+		const Value& positionValue, std::string& outErrorMsg)
+{
+	const Object& object = mObjects[static_cast<unsigned int>(frame.mObjectIndex)];
+	if (frame.mRequiredFound == object.mRequiredCount) {
+		return;
+	}
+	// --> one or more required members are missing
+	unsigned int memberEnd = object.mMemberBegin + object.mMemberCount;
+	for (unsigned int mi = object.mMemberBegin; mi < memberEnd; ++mi) {
+		const Member& member = mMembers[mi];
+		if (member.mRequired && mMemberStamps[mi] != frame.mStamp) {
+			addViolation(positionValue, "name '" +
+					mConstants[member.mName.mConstBegin].mText + "' is missing",
+					outErrorMsg);
+		}
+	}
+}
+
+void cfg::SchemaValidator::validateObject(unsigned int objectIndex,
+		const Value& obj, const Value& positionValue, std::string& outErrorMsg)
+{
+	// the stamp of a nested object is different --> members of
+	// this object are not touched by validating a nested object
+	// because the schema is a tree.
+	Frame frame;
+	beginObject(frame, static_cast<int>(objectIndex));
+	for (const NameValuePair& nvp : obj.mObject) {
+		if (nvp.isEmptyOrComment()) {
+			continue;
+		}
+		int memberIndex = useMember(frame, nvp.mName, outErrorMsg);
+		if (memberIndex < 0) {
+			continue;
+		}
+		// for an empty value or an object the position of the name is more useful
+		checkFragment(mMembers[static_cast<unsigned int>(memberIndex)].mValue,
+				nvp.mValue,
+				(nvp.mValue.isEmpty() || nvp.mValue.isObject()) ? nvp.mName : nvp.mValue,
+				true, outErrorMsg);
+	}
+	endObject(frame, positionValue, outErrorMsg);
+}
+
+void cfg::SchemaValidator::beginStream(const std::shared_ptr<const std::string>& filename)
+{
+	mViolationCount = 0;
+	mStreamStack.clear();
+	if (!isCompiled()) {
+		return;
+	}
+	mStreamStack.emplace_back();
+	mStreamStack.back().mPosition.mFilename = filename;
+	beginObject(mStreamStack.back(), 0);
+}
+
+bool cfg::SchemaValidator::streamNameValuePair(const NameValuePair& nvp,
+		std::string& outErrorMsg)
+{
+	if (nvp.isEmptyOrComment()) {
+		return true;
+	}
+	if (mStreamStack.empty()) {
+		outErrorMsg += "no object for name-value-pair (streaming is not started)\n";
+		++mViolationCount;
+		return false;
+	}
+	Frame& frame = mStreamStack.back();
+	if (frame.mObjectIndex < 0) {
+		// the object is not allowed by the schema (already reported)
+		// --> the content is not checked
+		return true;
+	}
+	unsigned int violationCount = mViolationCount;
+	int memberIndex = useMember(frame, nvp.mName, outErrorMsg);
+	if (memberIndex >= 0) {
+		checkFragment(mMembers[static_cast<unsigned int>(memberIndex)].mValue,
+				nvp.mValue,
+				(nvp.mValue.isEmpty() || nvp.mValue.isObject()) ? nvp.mName : nvp.mValue,
+				true, outErrorMsg);
+	}
+	return violationCount == mViolationCount;
+}
+
+bool cfg::SchemaValidator::streamBeginObject(const Value& name,
+		std::string& outErrorMsg)
+{
+	if (mStreamStack.empty()) {
+		outErrorMsg += "no object for begin of object (streaming is not started)\n";
+		++mViolationCount;
+		return false;
+	}
+	unsigned int violationCount = mViolationCount;
+	int objectIndex = -1;
+	Frame& parent = mStreamStack.back();
+	if (parent.mObjectIndex >= 0) {
+		int memberIndex = useMember(parent, name, outErrorMsg);
+		if (memberIndex >= 0) {
+			const Fragment& fragment = mMembers[static_cast<unsigned int>(memberIndex)].mValue;
+			if (fragment.mObjectIndex >= 0) {
+				objectIndex = fragment.mObjectIndex;
+			}
+			else if (fragment.mAllowedTypes &&
+					!(fragment.mAllowedTypes & SelectRule::ALLOW_OBJECT)) {
+				addViolation(name, std::string("type ") +
+						enumstring::getValueTypeAsString(Value::TYPE_OBJECT) +
+						" is not allowed", outErrorMsg);
+			}
+			// else --> any object is allowed (no object schema) --> content is not checked
+		}
+	}
+	// parent can be invalid after emplace_back() --> not used anymore
+	mStreamStack.emplace_back();
+	Frame& frame = mStreamStack.back();
+	frame.mPosition.mFilename = name.mFilename;
+	frame.mPosition.mLineNumber = name.mLineNumber;
+	frame.mPosition.mOffset = name.mOffset;
+	if (objectIndex >= 0) {
+		beginObject(frame, objectIndex);
+	}
+	else {
+		frame.mObjectIndex = -1;
+	}
+	return violationCount == mViolationCount;
+}
+
+bool cfg::SchemaValidator::streamEndObject(std::string& outErrorMsg)
+{
+	if (mStreamStack.size() <= 1) {
+		// the root object is closed by endStream()
+		outErrorMsg += "end of object without begin\n";
+		++mViolationCount;
+		return false;
+	}
+	unsigned int violationCount = mViolationCount;
+	const Frame& frame = mStreamStack.back();
+	if (frame.mObjectIndex >= 0) {
+		endObject(frame, frame.mPosition, outErrorMsg);
+	}
+	mStreamStack.pop_back();
+	return violationCount == mViolationCount;
+}
+
+bool cfg::SchemaValidator::endStream(std::string& outErrorMsg)
+{
+	if (!isCompiled()) {
+		outErrorMsg += "no schema is compiled\n";
+		++mViolationCount;
+		return false;
+	}
+	if (mStreamStack.empty()) {
+		outErrorMsg += "streaming is not started\n";
+		++mViolationCount;
+		return false;
+	}
+	while (mStreamStack.size() > 1) {
+		streamEndObject(outErrorMsg);
+	}
+	endObject(mStreamStack.back(), mStreamStack.back().mPosition, outErrorMsg);
+	mStreamStack.clear();
+	return mViolationCount == 0;
+}
+
+void cfg::SchemaValidator::addViolation(const Value& positionValue,
+		const std::string& msg, std::string& outErrorMsg)
+{
+	++mViolationCount;
+	std::string position = positionValue.getFilenameAndPosition();
+	if (!position.empty()) {
+		// e.g. btml has no file position
+		outErrorMsg += position + ": ";
+	}
+	outErrorMsg += msg + "\n";
+}
@@ -0,0 +1,107 @@
+#include <cfg/cfg_shared_value.h>
+
+cfg::SharedValue::SharedValue()
+		:mNode(std::make_shared<Node>())
+{
+}
+
+cfg::SharedValue::SharedValue(const Value& value)
+{
+	std::shared_ptr<Node> node = std::make_shared<Node>();
+	node->mHead.copyWithoutChildren(value);
+	node->mArray.reserve(value.mArray.size());
+	for (const Value& element : value.mArray) {
+		node->mArray.emplace_back(element);
+	}
+	node->mObject.reserve(value.mObject.size());
+	for (const NameValuePair& nvp : value.mObject) {
+		node->mObject.emplace_back(nvp);
+	}
+	mNode = std::move(node);
+}
+
+cfg::SharedValue::SharedValue(Value&& value)
+{
+	std::shared_ptr<Node> node = std::make_shared<Node>();
+	std::vector<Value> array = std::move(value.mArray);
+	std::vector<NameValuePair> object = std::move(value.mObject);
+	node->mHead = std::move(value);
+	node->mArray.reserve(array.size());
+	for (Value& element : array) {
+		node->mArray.emplace_back(std::move(element));
+	}
+	node->mObject.reserve(object.size());
+	for (NameValuePair& nvp : object) {
+		node->mObject.emplace_back(std::move(nvp));
+	}
+	mNode = std::move(node);
+}
+
+cfg::Value cfg::SharedValue::toValue() const
+{
+	Value value;
+	toValue(value);
+	return value;
+}
+
+void cfg::SharedValue::toValue(Value& outValue) const
+{
+	outValue = mNode->mHead;
+	outValue.mArray.resize(mNode->mArray.size());
+	for (std::size_t i = 0; i < mNode->mArray.size(); ++i) {
+		mNode->mArray[i].toValue(outValue.mArray[i]);
+	}
+	outValue.mObject.resize(mNode->mObject.size());
+	for (std::size_t i = 0; i < mNode->mObject.size(); ++i) {
+		const SharedPair& pair = mNode->mObject[i];
+		NameValuePair& nvp = outValue.mObject[i];
+		pair.mName.toValue(nvp.mName);
+		pair.mValue.toValue(nvp.mValue);
+		nvp.mDeep = pair.mDeep;
+	}
+}
+
+cfg::Value& cfg::SharedValue::mutableHead()
+{
+	return makeUnique().mHead;
+}
+
+std::vector<cfg::SharedValue>& cfg::SharedValue::mutableArray()
+{
+	return makeUnique().mArray;
+}
+
+std::vector<cfg::SharedPair>& cfg::SharedValue::mutableObject()
+{
+	return makeUnique().mObject;
+}
+
+cfg::SharedValue::Node& cfg::SharedValue::makeUnique()
+{
+	if (mNode.use_count() > 1) {
+		// clone only this node, the children are shared by the copy
+		mNode = std::make_shared<Node>(*mNode);
+	}
+	// The node is only used by this SharedValue. Therefore it can be
+	// changed (each node is created as non const Node).
+	return const_cast<Node&>(*mNode);
+}
+
+cfg::SharedPair::SharedPair(const NameValuePair& nvp)
+		:mName(nvp.mName),
+		mValue(nvp.mValue),
+		mDeep(nvp.mDeep)
+{
+}
+
+cfg::SharedPair::SharedPair(NameValuePair&& nvp)
+		:mName(std::move(nvp.mName)),
+		mValue(std::move(nvp.mValue)),
+		mDeep(nvp.mDeep)
+{
+}
+
+cfg::NameValuePair cfg::SharedPair::toNameValuePair() const
+{
+	return NameValuePair(mName.toValue(), mValue.toValue(), mDeep);
+}
@@ -1,6 +1,7 @@
 #include <cfg/cfg_string.h>
 #include <cfg/cfg_enum_string.h>
 #include <cfg/cfg.h>
+#include <cfg/cfg_number.h>
 #include <sstream>
 
 namespace {
@@ -43,7 +44,7 @@ std::string cfg::cfgstring::valueToString(unsigned int deep,
 	ss << "VALUE" << cfgValue.getFilePosition() << ": {";
 	//addTab(ss, deep + 1);
 	ss << "NVP-DEEP: " << cfgValue.mNvpDeep <<
-			", TYPE: " << enumstring::getValueTypeAsString(cfgValue.mType) << "(" << cfgValue.mType << ")";
+			", TYPE: " << enumstring::getValueTypeAsString(cfgValue.mType) << "(" << static_cast<int>(cfgValue.mType) << ")";
 	bool newline = false;
 	switch (cfgValue.mType) {
 		case Value::TYPE_NONE:
@@ -58,9 +59,16 @@ std::string cfg::cfgstring::valueToString(unsigned int deep,
 			ss << ", FLOAT: " << cfgValue.mFloatingPoint;
 			break;
 		case Value::TYPE_INT:
-			ss << ", PARSE BASE: " << cfgValue.mParseBase;
+			ss << ", PARSE BASE: " << static_cast<int>(cfgValue.mParseBase);
 			ss << ", INT: " << cfgValue.mInteger;
 			break;
+		case Value::TYPE_INT64:
+			ss << ", PARSE BASE: " << static_cast<int>(cfgValue.mParseBase);
+			ss << ", INT64: " << cfgValue.mInteger64;
+			break;
+		case Value::TYPE_DOUBLE:
+			ss << ", DOUBLE: " << number::doubleToString(cfgValue.mDouble, true);
+			break;
 		case Value::TYPE_TEXT:
 			ss << ", TEXT: \"" << cfgValue.mText << "\"";
 			break;
@@ -68,9 +76,14 @@ std::string cfg::cfgstring::valueToString(unsigned int deep,
 			ss << ", TEXT: \"" << cfgValue.mText << "\"";
 			break;
 		case Value::TYPE_ARRAY: {
-			ss << ", SIZE: " << cfgValue.mArray.size() << ",\n";
+			ss << ", SIZE: " << cfgValue.arraySize() << ",\n";
+			Value unpacked;
+			if (cfgValue.isPackedArray()) {
+				unpacked = cfgValue;
+				unpacked.unpackArray();
+			}
 			int i = 0;
-			for (const auto &cfgvalue : cfgValue.mArray) {
+			for (const auto &cfgvalue : (cfgValue.isPackedArray() ? unpacked : cfgValue).mArray) {
 				ss << valueToString(deep + 1, cfgvalue,
 						"index " + std::to_string(i));
 				++i;
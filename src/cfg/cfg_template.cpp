@@ -1,6 +1,7 @@
 #include <cfg/cfg_template.h>
 #include <tml/tml_string.h>
 #include <tml/tml_parser.h>
+#include <cfg/cfg_pair_splicer.h>
 #include <sstream>
 
 #define MAX_RECURSIVE_DEEP 50
@@ -44,6 +45,22 @@ namespace cfg
 				}
 			}
 
+			/**
+			 * Get the lowest defined deep (>= 0) of the pair and its children.
+			 * outMinDeep is unchanged if no lower deep exists.
+			 */
+			void getMinDeepNumber(const NameValuePair& nvp, int& outMinDeep) {
+				if (nvp.mDeep >= 0 && (outMinDeep < 0 || nvp.mDeep < outMinDeep)) {
+					outMinDeep = nvp.mDeep;
+				}
+				for (const auto& child : nvp.mName.mObject) {
+					getMinDeepNumber(child, outMinDeep);
+				}
+				for (const auto& child : nvp.mValue.mObject) {
+					getMinDeepNumber(child, outMinDeep);
+				}
+			}
+
 			/**
 			 * Replace the used parameters by there arguments
 			 */
@@ -171,12 +188,13 @@ namespace cfg
 
 					Value expr;
 					expr.setArray();
+					expr.mArray.reserve(nextStartIndex - curStartIndex);
 
 					// ci ... copy index
 					for (unsigned int ci = curStartIndex; ci < nextStartIndex; ++ci) {
 						expr.mArray.push_back(array[ci]);
 					}
-					tmpResult.mArray.push_back(expr);
+					tmpResult.mArray.push_back(std::move(expr));
 				}
 
 				if (expressionCount > 0) {
@@ -271,39 +289,36 @@ namespace cfg
 
 			bool applyTemplates(const TemplateMap& templateMap,
 					std::vector<NameValuePair>& pairs,
-					int pairStartIndex, int pairCount,
 					const std::string& keywordForUsingTemplate,
 					bool checkForInterpreterExpressions,
 					bool allowInterpretationWithQuotes,
 					int currentRecursiveReplaceDeep,
 					std::vector<std::string>& templateNameStack,
-					int& outPairAddRemoveCount, std::string& outErrorMsg);
+					std::string& outErrorMsg);
 
 			/**
 			 * Replace a "use-template" reference by the referenced template.
-			 * None, one or more pairs can be added by the replacing.
+			 * None, one or more pairs can be the result of the replacing.
 			 *
 			 * The methode is recursive. Which means that a replaced template
 			 * can have again a "use-template" reference which will be also
 			 * replaced by the referenced template and so on.
 			 *
 			 * @param templateMap Map of all templates
-			 * @param pairs pairs of the current object
-			 * @param index Index of the "use-template" reference which will be replaced
+			 * @param nvp The "use-template" reference which will be replaced.
+			 *        It is not changed.
+			 * @param outPairs The pairs which replace nvp. All "use-template"
+			 *        references inside of outPairs are already replaced.
+			 *        An empty vector means that nvp is erased.
 			 * @param keywordForUsingTemplate The used keyword (usually "use-template")
 			 * @param currentRecursiveReplaceDeep Is needed to limit to a max recursive deep
 			 * @param templateNameStack Is needed to check recursive loops
-			 * @param outErrorMsg Error message. In this case -1 is returned.
-			 * @return The count of modified and added name-value-pairs.
-			 *         Value of 0 means the pair pairs[index] is erased.
-			 *         Value of 1 means the pair pairs[index] is replaced.
-			 *         A Value of n means the pair pairs[index] is replaced
-			 *         and the pairs pairs[index + 1] to pairs[index + n - 1] are
-			 *         inserted. --> n - 1 are inserted.
-			 *         Return -1 for an error.
+			 * @param outErrorMsg Error message. In this case false is returned.
+			 * @return Return true for success.
 			 */
-			int replaceTemplate(const TemplateMap& templateMap,
-					std::vector<NameValuePair>& pairs, std::size_t index,
+			bool replaceTemplate(const TemplateMap& templateMap,
+					const NameValuePair& nvp,
+					std::vector<NameValuePair>& outPairs,
 					const std::string& keywordForUsingTemplate,
 					bool checkForInterpreterExpressions,
 					bool allowInterpretationWithQuotes,
@@ -311,7 +326,6 @@ namespace cfg
 					std::vector<std::string>& templateNameStack,
 					std::string& outErrorMsg)
 			{
-				NameValuePair& nvp = pairs[index];
 				ParameterMap parameterMap;
 				const CfgTemplate* cfgTemp = getTemplate(templateMap,
 						nvp.mName,
@@ -319,7 +333,7 @@ namespace cfg
 						allowInterpretationWithQuotes,
 						parameterMap, outErrorMsg);
 				if (!cfgTemp) {
-					return -1;
+					return false;
 				}
 				std::string tempName = nvp.mName.mArray[1].mText;
 				for (const auto& name : templateNameStack) {
@@ -330,49 +344,40 @@ namespace cfg
 							outErrorMsg += n + " --> ";
 						}
 						outErrorMsg += tempName;
-						return -1;
+						return false;
 					}
 				}
 				const CfgTemplate& cfgTemplate = *cfgTemp;
 				const std::vector<NameValuePair>& tmpPairs = cfgTemplate.getPairs();
-				if (tmpPairs.empty()) {
-					pairs.erase(pairs.begin() + index);
-					return 0;
-				}
-				int origDeep = pairs[index].mDeep;
-				pairs[index] = tmpPairs[0];
-				pairs.insert(pairs.begin() + index + 1, tmpPairs.begin() + 1,
-						tmpPairs.end());
-				std::size_t cnt = tmpPairs.size();
-				for (std::size_t i = 0; i < cnt; ++i) {
-					replaceValueByParameters(parameterMap, pairs[index + i]);
-					if (origDeep >= 0) {
-						int tempDeep = pairs[index + i].mDeep;
-						replaceDeepNumber(pairs[index + i], origDeep,
+				outPairs.assign(tmpPairs.begin(), tmpPairs.end());
+				if (outPairs.empty()) {
+					return true;
+				}
+				int origDeep = nvp.mDeep;
+				for (NameValuePair& pair : outPairs) {
+					replaceValueByParameters(parameterMap, pair);
+					// The template pairs are stored with deep 0 (see
+					// addTemplates()) --> a template which is used at
+					// deep 0 needs no walk through the subtree.
+					int tempDeep = pair.mDeep;
+					if (origDeep >= 0 && origDeep != tempDeep) {
+						replaceDeepNumber(pair, origDeep,
 								origDeep - tempDeep, tempDeep >= 0);
 					}
 				}
-				int pairAddRemoveCount = 0;
 				templateNameStack.push_back(tempName);
-				if (!applyTemplates(templateMap, pairs, static_cast<int>(index), static_cast<int>(tmpPairs.size()),
+				if (!applyTemplates(templateMap, outPairs,
 						keywordForUsingTemplate,
 						checkForInterpreterExpressions,
 						allowInterpretationWithQuotes,
 						currentRecursiveReplaceDeep + 1,
-						templateNameStack,
-						pairAddRemoveCount, outErrorMsg)) {
+						templateNameStack, outErrorMsg)) {
 					templateNameStack.pop_back();
-					return -1;
+					return false;
 				}
 				templateNameStack.pop_back();
-				if (pairAddRemoveCount < -int(tmpPairs.size())) {
-					// should not be possible
-					outErrorMsg = "Recursive error";
-					return -1;
-				}
-				return int(tmpPairs.size()) + pairAddRemoveCount;
+				return true;
 			}
-
 			/**
 			 * Replace a "use-template" reference by the referenced template.
 			 * Only a simple template is allowed which means that the
@@ -493,70 +498,50 @@ namespace cfg
 			 * can have again a "use-template" reference which will be also
 			 * replaced by the referenced template and so on.
 			 *
+			 * The pairs are rebuilt in one pass (see PairSplicer). Therefore
+			 * the time is linear to the count of pairs also if many pairs
+			 * are replaced by templates.
+			 *
 			 * @param templateMap Map of all templates
 			 * @param pairs pairs of the current object
-			 * @param pairStartIndex start index of the first nv-pair which
-			 *        should be used. Or -1 for default (which is 0).
-			 * @param pairCount Count of used nv-pairs starting with pairStartIndex.
-			 *        -1 for the max possible count (start from pairStartIndex).
 			 * @param keywordForUsingTemplate The used keyword (usually "use-template")
 			 * @param currentRecursiveReplaceDeep Is needed to limit to a max recursive deep.
 			 *        This has nothing to do with the current deep of the
 			 *        "value tree". This deep value is only for the recursive
 			 *        replacement of templates.
 			 * @param templateNameStack Is needed to check recursive loops
-			 * @param outPairAddRemoveCount Count of added or removed pairs.
-			 *        Positive for added count. Negative for removed count.
 			 * @param outErrorMsg Error message. In this case false is returned.
 			 * @return True for success. False for error.
 			 */
 			bool applyTemplates(const TemplateMap& templateMap,
 					std::vector<NameValuePair>& pairs,
-					int pairStartIndex, int pairCount,
 					const std::string& keywordForUsingTemplate,
 					bool checkForInterpreterExpressions,
 					bool allowInterpretationWithQuotes,
 					int currentRecursiveReplaceDeep,
 					std::vector<std::string>& templateNameStack,
-					int& outPairAddRemoveCount, std::string& outErrorMsg)
+					std::string& outErrorMsg)
 			{
 				if (currentRecursiveReplaceDeep > MAX_RECURSIVE_DEEP) {
 					outErrorMsg = "Reach max recursive deep for template replacement! (deep " +
 							std::to_string(currentRecursiveReplaceDeep) + ")";
 					return false;
 				}
-				outPairAddRemoveCount = 0;
-				if (pairStartIndex < 0) {
-					pairStartIndex = 0;
-				}
-				if (pairStartIndex >= int(pairs.size())) {
-					// nothing to do
-					return true;
-				}
-				if (pairCount < 0) {
-					pairCount = int(pairs.size()) - pairStartIndex;
-				}
-				int limit = pairStartIndex + pairCount;
-				for (int i = 0; i < limit; ++i) {
-					bool isReplaced = false;
-					if (i < 0) {
-						outErrorMsg = "Apply templates: Out of range " + std::to_string(i) + " < 0. size: " + std::to_string(pairs.size());
-						return false;
-					}
-					if (i >= int(pairs.size())) {
-						outErrorMsg = "Apply templates: Out of range " + std::to_string(i) + " >= " + std::to_string(pairs.size());
-						return false;
-					}
+				// pairs are not reallocated before splicer.finish()
+				// --> nvp pointers stay valid
+				PairSplicer splicer(pairs);
+				std::vector<NameValuePair> templatePairs;
+				std::size_t cnt = pairs.size();
+				for (std::size_t i = 0; i < cnt; ++i) {
 					NameValuePair* nvp = &pairs[i];
+					bool isReplacedByPairs = false;
 					if (nvp->isObject()) {
-						int pairDiffCount = 0;
 						std::vector<std::string> tempStack;
 						if (!applyTemplates(templateMap, nvp->mValue.mObject,
-								-1, -1, keywordForUsingTemplate,
+								keywordForUsingTemplate,
 								checkForInterpreterExpressions,
 								allowInterpretationWithQuotes,
-								0, tempStack,
-								pairDiffCount, outErrorMsg)) {
+								0, tempStack, outErrorMsg)) {
 							return false;
 						}
 					}
@@ -564,58 +549,29 @@ namespace cfg
 						if (nvp->mValue.isEmpty() || nvp->mValue.isObject()) {
 							cfg::Value origValue = std::move(nvp->mValue);
 							// full replacment with none, one or more name-value-pairs are allowed
-							int insertCnt = replaceTemplate(templateMap, pairs,
-									i, keywordForUsingTemplate,
+							templatePairs.clear();
+							if (!replaceTemplate(templateMap, *nvp, templatePairs,
+									keywordForUsingTemplate,
 									checkForInterpreterExpressions,
 									allowInterpretationWithQuotes,
 									currentRecursiveReplaceDeep,
 									templateNameStack,
-									outErrorMsg);
-							if (insertCnt < 0) {
-								return false;
-							}
-
-							// --i --> jump one back --> repeat the template check at next iteration.
-							// This is necessary because the used template can
-							// also use a template ...
-							//--i;
-							i += insertCnt - 1; // this would be the opposite. omit all new added pairs
-							// i can be -1 if insertCnt is 0 and i was 0 --> result: -1
-							// this is no problem
-							outPairAddRemoveCount += insertCnt - 1;
-							isReplaced = true;
-							limit += insertCnt - 1;
-
-							// replaceTemplate() can change the pairs
-							// --> pairs maybe make a reallocation for increasing
-							// --> nvp is NOT valid any more
-							// --> reassign nvp to current name value pair
-							if (i >= int(pairs.size())) {
-								outErrorMsg = "Apply templates: Out of range after replace " + std::to_string(i) + " >= " + std::to_string(pairs.size());
+									outErrorMsg)) {
 								return false;
 							}
-							// set to null if insertCnt is 0. &pairs[i] is not always valid because i can be -1 if insertCnt is 0!
-							nvp = (insertCnt == 0) ? nullptr : &pairs[i]; // VERY IMPORTANT!!!!!
-
 							if (origValue.isObject()) {
-								if (insertCnt == 0) {
-									outErrorMsg = "Can't add children after an empty template";
-									return false;
-								}
-								int realInsertCnt = insertCnt;
 								// find a valid name-value pair.
 								// A empty name-value pair is not allowed therefore
 								// search the last non-empty name-value pair.
-								NameValuePair* validNvp = &pairs[i];
-								for (int revert = 0;
-										realInsertCnt >= 1 && validNvp->isEmpty();
-										++revert, --realInsertCnt, validNvp = &pairs[i - revert])
-									;
-								if (realInsertCnt <= 0) {
+								std::size_t validIndex = templatePairs.size();
+								while (validIndex > 0 && templatePairs[validIndex - 1].isEmpty()) {
+									--validIndex;
+								}
+								if (validIndex == 0) {
 									outErrorMsg = "Can't add children after an empty template";
 									return false;
 								}
-
+								NameValuePair* validNvp = &templatePairs[validIndex - 1];
 								if (validNvp->isEmptyOrComment() ||
 										validNvp->mName.isEmpty() || validNvp->mName.isComment()) {
 									outErrorMsg = "Can't add children to an empty name or comment";
@@ -634,6 +590,13 @@ namespace cfg
 										std::make_move_iterator(origValue.mObject.begin()),
 										std::make_move_iterator(origValue.mObject.end()));
 							}
+							if (templatePairs.empty()) {
+								splicer.erase(i);
+								continue;
+							}
+							// the value of the last new pair is checked below
+							nvp = &templatePairs.back();
+							isReplacedByPairs = true;
 						}
 						else {
 							// only a simple replacement is allowed
@@ -645,15 +608,9 @@ namespace cfg
 									templateNameStack, outErrorMsg)) {
 								return false;
 							}
-							// --i --> jump one back --> repeat the template check at next iteration.
-							// This is necessary because the used template can
-							// also use a template ...
-							//--i;
-							isReplaced = true;
 						}
 					}
-					// nvp can be null here if insertCnt of replaceTemplate was 0
-					if (nvp && isUsingTemplate(nvp->mValue, keywordForUsingTemplate)) {
+					if (isUsingTemplate(nvp->mValue, keywordForUsingTemplate)) {
 						// only a simple replacement is allowed
 						if (!replaceSimpleTemplate(templateMap, nvp->mValue,
 								keywordForUsingTemplate,
@@ -663,13 +620,12 @@ namespace cfg
 								templateNameStack, outErrorMsg)) {
 							return false;
 						}
-						// check if i must be decreased for repeat the check.
-						// if i is already decreased (--i) then this is not necessary (otherwise wrong i value)
-						if (!isReplaced) {
-							//--i;
-						}
+					}
+					if (isReplacedByPairs) {
+						splicer.replace(i, templatePairs);
 					}
 				}
+				splicer.finish();
 				return true;
 			}
 		}
@@ -678,7 +634,7 @@ namespace cfg
 
 cfg::CfgTemplate::CfgTemplate(const std::string& name,
 		const std::vector<std::string>& parameters)
-		:mName(name), mParameters(parameters), mObject()
+		:mName(name), mParameters(parameters), mObject(), mDeepOffset(0)
 {
 }
 
@@ -686,7 +642,7 @@ cfg::CfgTemplate::CfgTemplate(const std::string& name,
 		const std::vector<std::string>& parameters,
 		const std::vector<NameValuePair>::const_iterator& begin,
 		const std::vector<NameValuePair>::const_iterator& end)
-		:mName(name), mParameters(parameters), mObject(begin, end)
+		:mName(name), mParameters(parameters), mObject(begin, end), mDeepOffset(0)
 {
 }
 
@@ -705,11 +661,34 @@ std::string cfg::CfgTemplate::toString() const
 	ss << "\n";
 	ss << "tml:\n";
 	for (const auto& pair : mObject) {
-		cfg::tmlstring::nameValuePairToStream(1, pair, ss, false);
+		if (mDeepOffset > 0) {
+			// print with the original deep (for comments and empty lines)
+			NameValuePair origPair = pair;
+			cfgtemp::replaceDeepNumber(origPair, 0, mDeepOffset, true);
+			cfg::tmlstring::nameValuePairToStream(1, origPair, ss, false);
+		}
+		else {
+			cfg::tmlstring::nameValuePairToStream(1, pair, ss, false);
+		}
 	}
 	return ss.str();
 }
 
+void cfg::CfgTemplate::moveDeepToZero()
+{
+	int minDeep = -1;
+	for (const auto& pair : mObject) {
+		cfgtemp::getMinDeepNumber(pair, minDeep);
+	}
+	if (minDeep <= 0) {
+		return;
+	}
+	for (auto& pair : mObject) {
+		cfgtemp::replaceDeepNumber(pair, 0, -minDeep, true);
+	}
+	mDeepOffset += minDeep;
+}
+
 bool cfg::cfgtemp::addTemplates(TemplateMap& templateMap,
 		const std::string& tmlFilename, bool inclEmptyLines, bool inclComments,
 		const std::string& templateKeyword)
@@ -742,6 +721,8 @@ bool cfg::cfgtemp::addTemplates(TemplateMap& templateMap, Value& cfgValue,
 		return false;
 	}
 	std::vector<NameValuePair>& pairs = cfgValue.mObject;
+	// pairs are not reallocated before splicer.finish()
+	PairSplicer splicer(pairs);
 	std::size_t cnt = pairs.size();
 	for (std::size_t i = 0; i < cnt; ++i) {
 		NameValuePair& nvp = pairs[i];
@@ -851,18 +832,28 @@ bool cfg::cfgtemp::addTemplates(TemplateMap& templateMap, Value& cfgValue,
 			std::vector<NameValuePair>& tempPairs = rv.first->second.getPairs();
 			tempPairs.reserve(pairTmpCnt - (paramsPairIndex + 1));
 			for (std::size_t ii = paramsPairIndex + 1; ii < pairTmpCnt; ++ii) {
-				if (!pairsFromTmp[ii].isEmptyOrComment()) {
+				if (pairsFromTmp[ii].isEmptyOrComment()) {
+					continue;
+				}
+				if (removeTemplatesFromCfgValue) {
+					// the template definition is erased below
+					tempPairs.push_back(std::move(pairsFromTmp[ii]));
+				}
+				else {
 					tempPairs.push_back(pairsFromTmp[ii]);
 				}
 			}
+			// Otherwise each usage of the template at the root would
+			// have to walk through the whole copied subtree for
+			// correcting the deep.
+			rv.first->second.moveDeepToZero();
 #endif
 			if (removeTemplatesFromCfgValue) {
-				pairs.erase(pairs.begin() + i);
-				--i;
-				--cnt;
+				splicer.erase(i);
 			}
 		}
 	}
+	splicer.finish();
 	return true;
 }
 
@@ -882,11 +873,9 @@ bool cfg::cfgtemp::useTemplates(const TemplateMap& templateMap, Value& cfgValue,
 	if (!cfgValue.isObject()) {
 		return true;
 	}
-	int pairDiffCount = 0;
 	std::vector<std::string> templateNameStack;
-	return applyTemplates(templateMap, cfgValue.mObject, -1, -1,
+	return applyTemplates(templateMap, cfgValue.mObject,
 			useTemplateKeyword,
 			checkForInterpreterExpressions, allowInterpretationWithQuotes,
-			0, templateNameStack,
-			pairDiffCount, outErrorMsg);
+			0, templateNameStack, outErrorMsg);
 }
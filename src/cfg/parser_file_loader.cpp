@@ -141,16 +141,10 @@ bool cfg::ParserFileLoader::loadAndPush(Value& outValue, std::string& outFullFil
 		}
 	}
 	if (loadWithParser) {
-		mParser->setFilename(outFullFilename);
-		if (!mParser->getAsTree(outValue, inclEmptyLines, inclComments)) {
-			outErrorMsg = mParser->getExtendedErrorMsg();
-			// must happend after reading err msg with getExtendedErrorMsg()
-			// otherwise the error message is empty
-			mParser->reset();
-			outValue.clear();
+		if (!parseFile(outValue, outFullFilename, inclEmptyLines,
+				inclComments, outErrorMsg)) {
 			return false;
 		}
-		mParser->reset();
 		if (mBuffering) {
 			// buffering is active --> filenameKey has already correct key (not empty)!
 			mBufferedFiles[filenameKey] = outValue; // create a copy (no move etc.)
@@ -160,6 +154,23 @@ bool cfg::ParserFileLoader::loadAndPush(Value& outValue, std::string& outFullFil
 	return true;
 }
 
+bool cfg::ParserFileLoader::parseFile(Value& outValue,
+		const std::string& fullFilename, bool inclEmptyLines,
+		bool inclComments, std::string& outErrorMsg)
+{
+	mParser->setFilename(fullFilename);
+	if (!mParser->getAsTree(outValue, inclEmptyLines, inclComments)) {
+		outErrorMsg = mParser->getExtendedErrorMsg();
+		// must happend after reading err msg with getExtendedErrorMsg()
+		// otherwise the error message is empty
+		mParser->reset();
+		outValue.clear();
+		return false;
+	}
+	mParser->reset();
+	return true;
+}
+
 bool cfg::ParserFileLoader::pop()
 {
 	if (mPathStack.empty()) {
@@ -0,0 +1,314 @@
+#include <cfg/value_writer.h>
+#include <sstream>
+
+cfg::ValueWriter::ValueWriter()
+{
+	mIsArrayStack.push_back(false);
+}
+
+cfg::ValueWriter& cfg::ValueWriter::configParseTextWithQuotes(bool enable)
+{
+	isParseTextWithQuotesForName = enable;
+	isParseTextWithQuotesForValue = enable;
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::configParseTextWithQuotesForName(bool enable)
+{
+	isParseTextWithQuotesForName = enable;
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::configParseTextWithQuotesForValue(bool enable)
+{
+	isParseTextWithQuotesForValue = enable;
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::empty()
+{
+	prepareEntry();
+	if (!isCurrentArray()) {
+		writePair(NameValuePair());
+	}
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::comment(std::string comment, bool withSpace)
+{
+	prepareEntry();
+	if (withSpace) {
+		comment.insert(comment.begin(), ' ');
+	}
+	if (isCurrentArray()) {
+		Value value;
+		value.setComment(std::move(comment));
+		writeElement(value);
+	}
+	else {
+		NameValuePair nvp;
+		nvp.mName.setComment(std::move(comment));
+		writePair(nvp);
+	}
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::pushObject(std::string name)
+{
+	prepareEntry();
+	if (isCurrentArray()) {
+		if (!name.empty()) {
+			addWarning("pushObject: object name '" + name + "' is ignored inside an array.");
+		}
+		beginObject(nullptr);
+	}
+	else {
+		Value nameValue;
+		nameValue.setText(std::move(name), isParseTextWithQuotesForName);
+		beginObject(&nameValue);
+	}
+	mIsArrayStack.push_back(false);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::popObject()
+{
+	prepareEntry();
+	if (isCurrentArray()) {
+		addWarning("popObject: is no object.");
+	}
+	else if (mIsArrayStack.size() <= 1) {
+		addWarning("popObject: deep is already 0.");
+	}
+	else {
+		endObject();
+		mIsArrayStack.pop_back();
+	}
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::pushArray(std::string name)
+{
+	prepareEntry();
+	if (isCurrentArray()) {
+		if (!name.empty()) {
+			addWarning("pushArray: array name '" + name + "' is ignored inside an array.");
+		}
+		beginArray(nullptr);
+	}
+	else {
+		Value nameValue;
+		nameValue.setText(std::move(name), isParseTextWithQuotesForName);
+		beginArray(&nameValue);
+	}
+	mIsArrayStack.push_back(true);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::popArray()
+{
+	prepareEntry();
+	if (!isCurrentArray()) {
+		addWarning("popArray: is no array.");
+	}
+	else {
+		// the root is always an object --> an array is never the root
+		endArray();
+		mIsArrayStack.pop_back();
+	}
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::nvpNull(std::string name)
+{
+	NameValuePair nvp;
+	nvp.mName.setText(std::move(name), isParseTextWithQuotesForName);
+	nvp.mValue.setNull();
+	addPair(nvp);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::nvpBool(std::string name, bool value)
+{
+	NameValuePair nvp;
+	nvp.mName.setText(std::move(name), isParseTextWithQuotesForName);
+	nvp.mValue.setBool(value);
+	addPair(nvp);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::nvpFloat(std::string name, float value)
+{
+	NameValuePair nvp;
+	nvp.mName.setText(std::move(name), isParseTextWithQuotesForName);
+	nvp.mValue.setFloatingPoint(value);
+	addPair(nvp);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::nvpInt(std::string name, int value)
+{
+	NameValuePair nvp;
+	nvp.mName.setText(std::move(name), isParseTextWithQuotesForName);
+	nvp.mValue.setInteger(value);
+	addPair(nvp);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::nvpText(std::string name, std::string value)
+{
+	NameValuePair nvp;
+	nvp.mName.setText(std::move(name), isParseTextWithQuotesForName);
+	nvp.mValue.setText(std::move(value), isParseTextWithQuotesForValue);
+	addPair(nvp);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::valNull()
+{
+	Value value;
+	value.setNull();
+	addValue(value);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::valBool(bool value)
+{
+	Value val;
+	val.setBool(value);
+	addValue(val);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::valFloat(float value)
+{
+	Value val;
+	val.setFloatingPoint(value);
+	addValue(val);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::valInt(int value)
+{
+	Value val;
+	val.setInteger(value);
+	addValue(val);
+	return *this;
+}
+
+cfg::ValueWriter& cfg::ValueWriter::valText(std::string value)
+{
+	Value val;
+	// the text is a name inside an object (without assign), otherwise a value
+	bool isName = !isCurrentArray() && !mAssign;
+	val.setText(std::move(value), isName ? isParseTextWithQuotesForName :
+			isParseTextWithQuotesForValue);
+	addValue(val);
+	return *this;
+}
+
+// this functions does NOT use prepareEntry(). makes no sense here!
+cfg::ValueWriter& cfg::ValueWriter::assign()
+{
+	if (mAssign) {
+		addWarning("assign: is already set");
+		return *this;
+	}
+	if (isCurrentArray()) {
+		addWarning("assign: No object for assign.");
+		return *this;
+	}
+	if (!mHasPendingPair) {
+		addWarning("assign: Not allowed for this name value pair.");
+		return *this;
+	}
+	mAssign = true;
+	return *this;
+}
+
+void cfg::ValueWriter::finish()
+{
+	if (mFinished) {
+		addWarning("finish: is already called.");
+		return;
+	}
+	prepareEntry();
+	while (mIsArrayStack.size() > 1) {
+		if (isCurrentArray()) {
+			endArray();
+		}
+		else {
+			endObject();
+		}
+		mIsArrayStack.pop_back();
+	}
+	endDocument();
+	mFinished = true;
+}
+
+std::string cfg::ValueWriter::getWarningsAsString() const
+{
+	std::stringstream ss;
+	for (const std::string& warning : mWarnings) {
+		ss << warning;
+		ss << "\n";
+	}
+	return ss.str();
+}
+
+void cfg::ValueWriter::addPair(NameValuePair& nvp)
+{
+	prepareEntry();
+	if (isCurrentArray()) {
+		// inside an array each name value pair is an own object
+		beginObject(nullptr);
+		writePair(nvp);
+		endObject();
+	}
+	else {
+		writePair(nvp);
+	}
+}
+
+void cfg::ValueWriter::addValue(Value& value)
+{
+	if (mAssign) {
+		// --> assign() has checked that a pending pair exists
+		mPendingPair.mValue = std::move(value);
+		mAssign = false;
+		flushPendingPair();
+		return;
+	}
+	prepareEntry();
+	if (isCurrentArray()) {
+		writeElement(value);
+	}
+	else {
+		// the value is the name of a pair. The pair can get a value by assign().
+		mPendingPair.clear();
+		mPendingPair.mName = std::move(value);
+		mHasPendingPair = true;
+	}
+}
+
+void cfg::ValueWriter::flushPendingPair()
+{
+	if (mHasPendingPair) {
+		mHasPendingPair = false;
+		writePair(mPendingPair);
+	}
+}
+
+void cfg::ValueWriter::addWarning(const std::string& warning)
+{
+	mWarnings.push_back(warning);
+}
+
+void cfg::ValueWriter::prepareEntry()
+{
+	if (mAssign) {
+		addWarning("assign: is not used --> reset assign.");
+		mAssign = false;
+	}
+	flushPendingPair();
+}
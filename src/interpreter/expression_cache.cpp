@@ -0,0 +1,234 @@
+#include <interpreter/expression_cache.h>
+#include <cstring>
+
+namespace cfg
+{
+	namespace interpreter
+	{
+		namespace
+		{
+			void appendToKey(std::string& key, const Value& val)
+			{
+				switch (val.mType) {
+					case Value::TYPE_NONE:
+						key += 'e';
+						break;
+					case Value::TYPE_NULL:
+						key += 'N';
+						break;
+					case Value::TYPE_BOOL:
+						key += val.mBool ? 'T' : 'F';
+						break;
+					case Value::TYPE_FLOAT: {
+						key += 'f';
+						char buf[sizeof(val.mFloatingPoint)];
+						memcpy(buf, &val.mFloatingPoint, sizeof(buf));
+						key.append(buf, sizeof(buf));
+						break;
+					}
+					case Value::TYPE_INT:
+						// the parse base is also part of the key because
+						// the result of an operation uses it.
+						key += 'i';
+						key += std::to_string(val.mInteger);
+						key += ',';
+						key += std::to_string(val.mParseBase);
+						break;
+					case Value::TYPE_INT64:
+						key += 'I';
+						key += std::to_string(val.mInteger64);
+						key += ',';
+						key += std::to_string(val.mParseBase);
+						break;
+					case Value::TYPE_DOUBLE: {
+						key += 'd';
+						char buf[sizeof(val.mDouble)];
+						memcpy(buf, &val.mDouble, sizeof(buf));
+						key.append(buf, sizeof(buf));
+						break;
+					}
+					case Value::TYPE_TEXT:
+					case Value::TYPE_COMMENT:
+						key += val.isComment() ? 'c' : (val.mParseTextWithQuotes ? 'S' : 's');
+						key += std::to_string(val.mText.size());
+						key += ':';
+						key += val.mText;
+						break;
+					case Value::TYPE_ARRAY:
+						// e.g. the result of an element-array which was interpreted before
+						key += '[';
+						for (const Value& element : val.mArray) {
+							appendToKey(key, element);
+						}
+						key += ']';
+						break;
+					case Value::TYPE_OBJECT:
+						key += '{';
+						for (const NameValuePair& nvp : val.mObject) {
+							appendToKey(key, nvp.mName);
+							key += '=';
+							appendToKey(key, nvp.mValue);
+						}
+						key += '}';
+						break;
+				}
+				key += ' ';
+			}
+
+			bool hasPosition(const Value& val)
+			{
+				return val.mFilename || val.mLineNumber >= 0 || val.mOffset >= 0;
+			}
+
+			bool isSamePosition(const Value& a, const Value& b)
+			{
+				return a.mFilename == b.mFilename && a.mLineNumber == b.mLineNumber &&
+						a.mOffset == b.mOffset;
+			}
+
+			// the value and its children in a fixed order (pre-order)
+			template <typename V>
+			void getNodes(V& val, std::vector<V*>& outNodes)
+			{
+				outNodes.push_back(&val);
+				for (V& element : val.mArray) {
+					getNodes(element, outNodes);
+				}
+				for (auto& nvp : val.mObject) {
+					getNodes(nvp.mName, outNodes);
+					getNodes(nvp.mValue, outNodes);
+				}
+			}
+
+			// nodes of the tokens which are used for the key (same order for the same key)
+			void getTokenNodes(const Value* tokens, size_t count,
+					std::vector<const Value*>& outNodes)
+			{
+				for (size_t i = 0; i < count; ++i) {
+					if (!tokens[i].isEmpty() && !tokens[i].isComment()) {
+						getNodes(tokens[i], outNodes);
+					}
+				}
+			}
+		}
+	}
+}
+
+std::string cfg::interpreter::ExpressionCache::createKey(const Value* tokens,
+		size_t count, bool allowInterpretationWithQuotes)
+{
+	std::string key;
+	key.reserve(count * 4 + 1);
+	key += allowInterpretationWithQuotes ? 'q' : 'n';
+	for (size_t i = 0; i < count; ++i) {
+		if (tokens[i].isEmpty() || tokens[i].isComment()) {
+			// ignored by the lexer --> also ignored for the key
+			continue;
+		}
+		appendToKey(key, tokens[i]);
+	}
+	return key;
+}
+
+bool cfg::interpreter::ExpressionCache::find(const std::string& key,
+		const Value* tokens, size_t count, Value& outResult)
+{
+	std::vector<int> positionTokens;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		std::unordered_map<std::string, Entry>::const_iterator it = mEntries.find(key);
+		if (it == mEntries.end() || !it->second.mIsCacheable) {
+			++mMissCount;
+			return false;
+		}
+		++mHitCount;
+		outResult = it->second.mResult;
+		positionTokens = it->second.mPositionTokens;
+	}
+	if (positionTokens.empty()) {
+		// --> the result doesn't depend on the source
+		return true;
+	}
+	std::vector<Value*> nodes;
+	getNodes(outResult, nodes);
+	std::vector<const Value*> tokenNodes;
+	getTokenNodes(tokens, count, tokenNodes);
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		if (positionTokens[i] >= 0) {
+			// the key is equal --> the tokens have the same structure
+			const Value& token = *tokenNodes[static_cast<size_t>(positionTokens[i])];
+			nodes[i]->mFilename = token.mFilename;
+			nodes[i]->mLineNumber = token.mLineNumber;
+			nodes[i]->mOffset = token.mOffset;
+		}
+	}
+	return true;
+}
+
+void cfg::interpreter::ExpressionCache::add(const std::string& key,
+		const Value& result, const Value* tokens, size_t count)
+{
+	bool isCacheable = true;
+	std::vector<int> positionTokens;
+	std::vector<const Value*> nodes;
+	getNodes(result, nodes);
+	std::vector<const Value*> tokenNodes;
+	for (size_t i = 0; i < nodes.size() && isCacheable; ++i) {
+		if (!hasPosition(*nodes[i])) {
+			continue;
+		}
+		if (positionTokens.empty()) {
+			// only necessary for a result with a position
+			positionTokens.resize(nodes.size(), -1);
+			getTokenNodes(tokens, count, tokenNodes);
+		}
+		isCacheable = false;
+		for (size_t ti = 0; ti < tokenNodes.size(); ++ti) {
+			if (isSamePosition(*nodes[i], *tokenNodes[ti])) {
+				positionTokens[i] = static_cast<int>(ti);
+				isCacheable = true;
+				break;
+			}
+		}
+	}
+	std::lock_guard<std::mutex> lock(mMutex);
+	// if another thread has added the same key in the meantime then
+	// the existing entry is unchanged
+	std::pair<std::unordered_map<std::string, Entry>::iterator, bool> inserted =
+			mEntries.emplace(key, Entry());
+	if (!inserted.second) {
+		return;
+	}
+	Entry& entry = inserted.first->second;
+	entry.mIsCacheable = isCacheable;
+	if (isCacheable) {
+		entry.mResult = result;
+		entry.mPositionTokens = std::move(positionTokens);
+	}
+}
+
+void cfg::interpreter::ExpressionCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEntries.clear();
+	mHitCount = 0;
+	mMissCount = 0;
+}
+
+size_t cfg::interpreter::ExpressionCache::getHitCount() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mHitCount;
+}
+
+size_t cfg::interpreter::ExpressionCache::getMissCount() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mMissCount;
+}
+
+size_t cfg::interpreter::ExpressionCache::size() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mEntries.size();
+}
@@ -25,6 +25,55 @@ namespace cfg
 				return getValueAsString(value);
 			}
 
+			template <typename T>
+			T calc(TokenType op, T left, T right)
+			{
+				switch (op) {
+					case TokenType::PLUS:
+						return left + right;
+					case TokenType::MINUS:
+						return left - right;
+					case TokenType::ASTERISK:
+						return left * right;
+					default:
+						return left / right;
+				}
+			}
+
+			/**
+			 * + - * / of two numbers. int with int is calculated as int,
+			 * int64 with int or int64 as int64. If at least one number is
+			 * an int64 or a double the others are calculated as double,
+			 * otherwise as float.
+			 */
+			bool calcNumbers(TokenType op, const cfg::Value& left,
+					const cfg::Value& right, cfg::Value& result, std::ostream& errMsg)
+			{
+				if ((left.isInteger() || left.isInteger64()) &&
+						(right.isInteger() || right.isInteger64())) {
+					if (op == TokenType::SLASH && right.getInteger64() == 0) {
+						errMsg << "Division by zero.";
+						return false;
+					}
+					unsigned int parseBase = (left.mParseBase == right.mParseBase) ?
+							left.mParseBase : 10;
+					if (left.isInteger() && right.isInteger()) {
+						result.setInteger(calc(op, left.mInteger, right.mInteger), parseBase);
+					}
+					else {
+						result.setInteger64(calc(op, left.getInteger64(), right.getInteger64()), parseBase);
+					}
+				}
+				else if (left.isInteger64() || left.isDouble() ||
+						right.isInteger64() || right.isDouble()) {
+					result.setDouble(calc(op, left.getDouble(), right.getDouble()));
+				}
+				else {
+					result.setFloatingPoint(calc(op, left.mFloatingPoint, right.mFloatingPoint));
+				}
+				return true;
+			}
+
 			bool isParameterCountCorrect(const std::string& funcName,
 					const std::vector<cfg::Value>& args,
 					unsigned int expectedParamCount, std::ostream& errMsg)
@@ -81,6 +130,12 @@ namespace cfg
 				if (arg.isInteger()) {
 					result.setInteger(arg.mInteger < 0 ? -arg.mInteger : arg.mInteger, arg.mParseBase);
 				}
+				else if (arg.isInteger64()) {
+					result.setInteger64(arg.mInteger64 < 0 ? -arg.mInteger64 : arg.mInteger64, arg.mParseBase);
+				}
+				else if (arg.isDouble()) {
+					result.setDouble(std::fabs(arg.mDouble));
+				}
 				else {
 					// --> can only be a float
 					result.setFloatingPoint(arg.mFloatingPoint < 0.0f ? -arg.mFloatingPoint : arg.mFloatingPoint);
@@ -106,6 +161,9 @@ namespace cfg
 					result.setBool(std::fpclassify(arg.mFloatingPoint) != FP_ZERO);
 					//result.setBool(static_cast<bool>(arg.mFloatingPoint));
 				}
+				else if (arg.isInteger64() || arg.isDouble()) {
+					result.setBool(std::fpclassify(arg.getDouble()) != FP_ZERO);
+				}
 				else if (arg.isText()) {
 					result.setBool(arg.mText == "true");
 				}
@@ -126,12 +184,17 @@ namespace cfg
 				if (arg.isBool()) {
 					result.setInteger(static_cast<int>(arg.mBool), 2);
 				}
-				else if (arg.isInteger()) {
+				else if (arg.isInteger() || arg.isInteger64()) {
 					result = arg;
 				}
 				else if (arg.isFloat()) {
 					result.setInteger(static_cast<int>(arg.mFloatingPoint), 10);
 				}
+				else if (arg.isDouble()) {
+					// getInteger64() is rounded and clamped to the range of int64_t
+					result.setInteger64((std::fabs(arg.mDouble) < 9.2e18) ?
+							static_cast<int64_t>(arg.mDouble) : arg.getInteger64(), 10);
+				}
 				else if (arg.isText()) {
 					errMsg << "TODO: impl text to int for int()" << std::endl;
 					return false;
@@ -182,6 +245,7 @@ bool cfg::expressions::CallExpression::interpret(Context& context,
 		if (!arg->interpret(context, argsResults[i], errMsg)) {
 			errMsg << "Can't interpret parameter " << (i + 1) <<
 					" for functioncall '" << funcName << "'" << std::endl;
+			return false;
 		}
 		++i;
 	}
@@ -237,59 +301,12 @@ bool cfg::expressions::OperatorExpression::interpret(Context& context,
 				result.setText(convertToText(leftResult) + convertToText(rightResult));
 				return true;
 			}
-			if (leftResult.isNumber() && rightResult.isNumber()) {
-				if (leftResult.isInteger() && rightResult.isInteger()) {
-					unsigned int parseBase =
-							(leftResult.mParseBase == rightResult.mParseBase) ?
-									leftResult.mParseBase : 10;
-					result.setInteger(leftResult.mInteger + rightResult.mInteger, parseBase);
-					return true;
-				}
-				// --> calc as floats
-				result.setFloatingPoint(leftResult.mFloatingPoint + rightResult.mFloatingPoint);
-				return true;
-			}
-			break;
+			// fall through
 		case TokenType::MINUS:    //  -
-			if (leftResult.isNumber() && rightResult.isNumber()) {
-				if (leftResult.isInteger() && rightResult.isInteger()) {
-					unsigned int parseBase =
-							(leftResult.mParseBase == rightResult.mParseBase) ?
-									leftResult.mParseBase : 10;
-					result.setInteger(leftResult.mInteger - rightResult.mInteger, parseBase);
-					return true;
-				}
-				// --> calc as floats
-				result.setFloatingPoint(leftResult.mFloatingPoint - rightResult.mFloatingPoint);
-				return true;
-			}
-			break;
 		case TokenType::ASTERISK: //  *
-			if (leftResult.isNumber() && rightResult.isNumber()) {
-				if (leftResult.isInteger() && rightResult.isInteger()) {
-					unsigned int parseBase =
-							(leftResult.mParseBase == rightResult.mParseBase) ?
-									leftResult.mParseBase : 10;
-					result.setInteger(leftResult.mInteger * rightResult.mInteger, parseBase);
-					return true;
-				}
-				// --> calc as floats
-				result.setFloatingPoint(leftResult.mFloatingPoint * rightResult.mFloatingPoint);
-				return true;
-			}
-			break;
 		case TokenType::SLASH:    //  /
 			if (leftResult.isNumber() && rightResult.isNumber()) {
-				if (leftResult.isInteger() && rightResult.isInteger()) {
-					unsigned int parseBase =
-							(leftResult.mParseBase == rightResult.mParseBase) ?
-									leftResult.mParseBase : 10;
-					result.setInteger(leftResult.mInteger / rightResult.mInteger, parseBase);
-					return true;
-				}
-				// --> calc as floats
-				result.setFloatingPoint(leftResult.mFloatingPoint / rightResult.mFloatingPoint);
-				return true;
+				return calcNumbers(mOperator, leftResult, rightResult, result, errMsg);
 			}
 			break;
 		default: {
@@ -329,6 +346,14 @@ bool cfg::expressions::PrefixExpression::interpret(Context& context,
 					result.setInteger(-rightResult.mInteger, rightResult.mParseBase);
 					return true;
 				}
+				if (rightResult.isInteger64()) {
+					result.setInteger64(-rightResult.mInteger64, rightResult.mParseBase);
+					return true;
+				}
+				if (rightResult.isDouble()) {
+					result.setDouble(-rightResult.mDouble);
+					return true;
+				}
 				// --> calc as floats
 				result.setFloatingPoint(-rightResult.mFloatingPoint);
 				return true;
@@ -1,10 +1,77 @@
 #include <interpreter/interpreter.h>
 #include <interpreter/cfg_parser.h>
 #include <interpreter/cfg_lexer.h>
+#include <atomic>
+#include <sstream>
+#include <thread>
 //#include <cfg/cfg_string.h>
 
+namespace cfg
+{
+	namespace interpreter
+	{
+		namespace
+		{
+			/**
+			 * A task is an array (which can contain expressions) of the
+			 * tree. The result and the error messages of the task are
+			 * stored separately for merging after all tasks are finished.
+			 */
+			struct InterpretTask
+			{
+				Value* mValue = nullptr;
+				int mRv = 0;
+				std::ostringstream mErrMsg;
+
+				explicit InterpretTask(Value* value) :mValue(value) {}
+			};
+
+			/**
+			 * Collect the tasks of an object in document order.
+			 * Nested objects are split further. Arrays are tasks.
+			 */
+			void collectObjectTasks(Value& obj,
+					bool allowNameInterpretation,
+					bool allowValueInterpretation,
+					std::vector<std::unique_ptr<InterpretTask>>& tasks)
+			{
+				for (NameValuePair& nvp : obj.mObject) {
+					if (allowNameInterpretation) {
+						if (nvp.mName.isArray()) {
+							tasks.emplace_back(new InterpretTask(&nvp.mName));
+						}
+						else if (nvp.mName.isObject()) {
+							collectObjectTasks(nvp.mName,
+									allowNameInterpretation,
+									allowValueInterpretation, tasks);
+						}
+					}
+					if (allowValueInterpretation) {
+						if (nvp.mValue.isArray()) {
+							tasks.emplace_back(new InterpretTask(&nvp.mValue));
+						}
+						else if (nvp.mValue.isObject()) {
+							collectObjectTasks(nvp.mValue,
+									allowNameInterpretation,
+									allowValueInterpretation, tasks);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
 int cfg::interpreter::interpretAndReplaceExprValue(cfg::Value& exprResultValue,
 		bool allowInterpretationWithQuotes, std::ostream& errMsg)
+{
+	return interpretAndReplaceExprValue(exprResultValue,
+			allowInterpretationWithQuotes, nullptr, errMsg);
+}
+
+int cfg::interpreter::interpretAndReplaceExprValue(cfg::Value& exprResultValue,
+		bool allowInterpretationWithQuotes, ExpressionCache* cache,
+		std::ostream& errMsg)
 {
 	if (!exprResultValue.isArray()) {
 		// nothing to do
@@ -41,10 +108,6 @@ int cfg::interpreter::interpretAndReplaceExprValue(cfg::Value& exprResultValue,
 		// --> expression for interpreter start with
 		// '_i (',  '_ii (',  '_fi ('  or  '_ti ('
 		++expressionCount;
-		if (!parser) {
-			std::unique_ptr<cfg::CfgLexer> lexer(new cfg::CfgLexer(exprResultValue, allowInterpretationWithQuotes));
-			parser = std::unique_ptr<cfg::CfgParser>(new cfg::CfgParser(std::move(lexer)));
-		}
 		unsigned int curStartIndex = i - 1;
 
 		// ci ... copy index
@@ -72,10 +135,6 @@ int cfg::interpreter::interpretAndReplaceExprValue(cfg::Value& exprResultValue,
 			errMsg << "Can't find ending" << std::endl;
 			return -1;
 		}
-		if (!parser->getTokenIterator().setRangePosition(curStartIndex, i)) {
-			return -1;
-		}
-		parser->reset();
 		nextStartIndex = i;
 		//std::cout << "interpreter start with '" << prev.mText << " " << val.mText << "'" << std::endl;
 		//std::cout << "interpreter from index '" << curStartIndex << "' to '" << (i - 1) << "'" << std::endl;
@@ -85,24 +144,52 @@ int cfg::interpreter::interpretAndReplaceExprValue(cfg::Value& exprResultValue,
 		// to token like '_i (',  '_ii (',  '_fi ('  or  '_ti ('
 		// not necessary: --i;
 
-		unsigned int errorCount = 0;
-		std::unique_ptr<expressions::Expression> expr = parser->parseFullExpression(errorCount);
-		if (errorCount) {
-			errMsg << "error count " << errorCount << std::endl;
-			return -1;
-		}
-		expressions::Context context(allowInterpretationWithQuotes);
+		std::string cacheKey;
 		cfg::Value exprResult;
-		if (!expr->interpret(context, exprResult, errMsg)) {
-			return -1;
+		bool resultIsCached = false;
+		if (cache) {
+			cacheKey = ExpressionCache::createKey(
+					exprResultValue.mArray.data() + curStartIndex,
+					i - curStartIndex, allowInterpretationWithQuotes);
+			resultIsCached = cache->find(cacheKey,
+					exprResultValue.mArray.data() + curStartIndex,
+					i - curStartIndex, exprResult);
 		}
-		fullResult.mArray.push_back(std::move(exprResult));
+		if (!resultIsCached) {
+			if (!parser) {
+				std::unique_ptr<cfg::CfgLexer> lexer(new cfg::CfgLexer(exprResultValue, allowInterpretationWithQuotes));
+				parser = std::unique_ptr<cfg::CfgParser>(new cfg::CfgParser(std::move(lexer)));
+			}
+			if (!parser->getTokenIterator().setRangePosition(curStartIndex, i)) {
+				return -1;
+			}
+			parser->reset();
 
-		unsigned int newTokenPosition = parser->getTokenIterator().getPosition();
-		if (newTokenPosition != i) {
-			errMsg << "wrong internal state" << std::endl;
-			return -1;
+			unsigned int errorCount = 0;
+			std::unique_ptr<expressions::Expression> expr = parser->parseFullExpression(errorCount);
+			if (errorCount) {
+				errMsg << "error count " << errorCount << std::endl;
+				return -1;
+			}
+
+			unsigned int newTokenPosition = parser->getTokenIterator().getPosition();
+			if (newTokenPosition != i) {
+				errMsg << "wrong internal state" << std::endl;
+				return -1;
+			}
+			expressions::Context context(allowInterpretationWithQuotes);
+			if (!expr->interpret(context, exprResult, errMsg)) {
+				return -1;
+			}
+			if (cache) {
+				// a file position of the result is taken from the tokens
+				// of the occurrence which uses the cache (e.g. '_i ( abc )')
+				cache->add(cacheKey, exprResult,
+						exprResultValue.mArray.data() + curStartIndex,
+						i - curStartIndex);
+			}
 		}
+		fullResult.mArray.push_back(std::move(exprResult));
 		//std::cout << "parsed from " << curStartIndex << " to " << (newTokenPosition - 1) << std::endl;
 	}
 	if (expressionCount > 0) {
@@ -128,6 +215,18 @@ int cfg::interpreter::interpretAndReplace(cfg::Value& cfgValueTree,
 		bool allowArrayElementInterpretation,
 		bool allowNameInterpretation,
 		bool allowValueInterpretation, std::ostream& errMsg)
+{
+	return interpretAndReplace(cfgValueTree, allowInterpretationWithQuotes,
+			allowArrayElementInterpretation, allowNameInterpretation,
+			allowValueInterpretation, nullptr, errMsg);
+}
+
+int cfg::interpreter::interpretAndReplace(cfg::Value& cfgValueTree,
+		bool allowInterpretationWithQuotes,
+		bool allowArrayElementInterpretation,
+		bool allowNameInterpretation,
+		bool allowValueInterpretation,
+		ExpressionCache* cache, std::ostream& errMsg)
 {
 	if (cfgValueTree.isArray()) {
 		int rvSum = 0;
@@ -138,7 +237,7 @@ int cfg::interpreter::interpretAndReplace(cfg::Value& cfgValueTree,
 							allowInterpretationWithQuotes,
 							allowArrayElementInterpretation,
 							allowNameInterpretation,
-							allowValueInterpretation, errMsg);
+							allowValueInterpretation, cache, errMsg);
 					if (rv == -1) {
 						return -1;
 					}
@@ -147,7 +246,7 @@ int cfg::interpreter::interpretAndReplace(cfg::Value& cfgValueTree,
 			}
 		}
 		int rv = interpretAndReplaceExprValue(cfgValueTree,
-				allowInterpretationWithQuotes, errMsg);
+				allowInterpretationWithQuotes, cache, errMsg);
 		if (rv == -1) {
 			return -1;
 		}
@@ -167,7 +266,7 @@ int cfg::interpreter::interpretAndReplace(cfg::Value& cfgValueTree,
 						allowInterpretationWithQuotes,
 						allowArrayElementInterpretation,
 						allowNameInterpretation,
-						allowValueInterpretation, errMsg);
+						allowValueInterpretation, cache, errMsg);
 				if (rv == -1) {
 					return -1;
 				}
@@ -179,7 +278,7 @@ int cfg::interpreter::interpretAndReplace(cfg::Value& cfgValueTree,
 						allowInterpretationWithQuotes,
 						allowArrayElementInterpretation,
 						allowNameInterpretation,
-						allowValueInterpretation, errMsg);
+						allowValueInterpretation, cache, errMsg);
 				if (rv == -1) {
 					return -1;
 				}
@@ -190,3 +289,105 @@ int cfg::interpreter::interpretAndReplace(cfg::Value& cfgValueTree,
 	}
 	return 0;
 }
+
+int cfg::interpreter::interpretAndReplaceParallel(cfg::Value& cfgValueTree,
+		bool allowInterpretationWithQuotes,
+		bool allowArrayElementInterpretation,
+		bool allowNameInterpretation,
+		bool allowValueInterpretation,
+		unsigned int threadCount, std::ostream& errMsg)
+{
+	return interpretAndReplaceParallel(cfgValueTree,
+			allowInterpretationWithQuotes, allowArrayElementInterpretation,
+			allowNameInterpretation, allowValueInterpretation,
+			threadCount, nullptr, errMsg);
+}
+
+int cfg::interpreter::interpretAndReplaceParallel(cfg::Value& cfgValueTree,
+		bool allowInterpretationWithQuotes,
+		bool allowArrayElementInterpretation,
+		bool allowNameInterpretation,
+		bool allowValueInterpretation,
+		unsigned int threadCount, ExpressionCache* cache,
+		std::ostream& errMsg)
+{
+	std::vector<std::unique_ptr<InterpretTask>> tasks;
+	if (cfgValueTree.isArray()) {
+		if (allowArrayElementInterpretation) {
+			for (Value& element: cfgValueTree.mArray) {
+				if (element.isArray() || element.isObject()) {
+					tasks.emplace_back(new InterpretTask(&element));
+				}
+			}
+		}
+	}
+	else if (cfgValueTree.isObject()) {
+		if (allowNameInterpretation || allowValueInterpretation) {
+			collectObjectTasks(cfgValueTree, allowNameInterpretation,
+					allowValueInterpretation, tasks);
+		}
+	}
+
+	if (threadCount == 0) {
+		threadCount = std::thread::hardware_concurrency();
+	}
+	if (threadCount <= 1 || tasks.size() < 2) {
+		return interpretAndReplace(cfgValueTree,
+				allowInterpretationWithQuotes,
+				allowArrayElementInterpretation,
+				allowNameInterpretation,
+				allowValueInterpretation, cache, errMsg);
+	}
+	if (threadCount > tasks.size()) {
+		threadCount = static_cast<unsigned int>(tasks.size());
+	}
+
+	std::atomic<size_t> nextTaskIndex(0);
+	auto worker = [&]() {
+		for (size_t i = nextTaskIndex++; i < tasks.size(); i = nextTaskIndex++) {
+			InterpretTask& task = *tasks[i];
+			task.mRv = interpretAndReplace(*task.mValue,
+					allowInterpretationWithQuotes,
+					allowArrayElementInterpretation,
+					allowNameInterpretation,
+					allowValueInterpretation, cache, task.mErrMsg);
+		}
+	};
+	// the calling thread is also a worker --> one thread less must be created
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (unsigned int i = 1; i < threadCount; ++i) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& t : threads) {
+		t.join();
+	}
+
+	// merge results and error messages in document order
+	bool hasError = false;
+	int rvSum = 0;
+	for (const std::unique_ptr<InterpretTask>& task : tasks) {
+		errMsg << task->mErrMsg.str();
+		if (task->mRv == -1) {
+			hasError = true;
+		}
+		else {
+			rvSum += task->mRv;
+		}
+	}
+	if (hasError) {
+		return -1;
+	}
+	if (cfgValueTree.isArray()) {
+		// the array itself can also be an expression (e.g. with results of
+		// the element-arrays) --> must be done after all elements are finished
+		int rv = interpretAndReplaceExprValue(cfgValueTree,
+				allowInterpretationWithQuotes, cache, errMsg);
+		if (rv == -1) {
+			return -1;
+		}
+		rvSum += rv;
+	}
+	return rvSum;
+}
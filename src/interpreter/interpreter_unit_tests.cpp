@@ -5,6 +5,7 @@
 #include <interpreter/cfg_lexer.h>
 #include <tml/tml_parser.h>
 #include <cfg/cfg_string.h>
+#include <cmath>
 #include <iostream>
 
 static int sPassed = 0;
@@ -352,6 +353,236 @@ static bool interpretAndReplaceTests()
 	return true;
 }
 
+static bool interpretAndReplaceWithCache(const std::string& tmlSource,
+		cfg::interpreter::ExpressionCache& cache)
+{
+	cfg::Value value;
+	if (!getCfgValueWithArray(tmlSource, value)) {
+		std::cout << "failed" << std::endl;
+		return false;
+	}
+	cfg::Value cachedValue = value;
+	int rv = cfg::interpreter::interpretAndReplaceExprValue(value, false, std::cout);
+	int cachedRv = cfg::interpreter::interpretAndReplaceExprValue(cachedValue, false, &cache, std::cout);
+	std::string str = cfg::tmlstring::valueToString(0, value);
+	std::string cachedStr = cfg::tmlstring::valueToString(0, cachedValue);
+	if (rv != cachedRv || str != cachedStr) {
+		std::cout << "[FAIL] cache: " << tmlSource << std::endl;
+		std::cout << "         Expected: " << str;
+		std::cout << "           Actual: " << cachedStr;
+		return false;
+	}
+	return true;
+}
+
+// a result which is taken from the source must have the position of its occurrence
+static bool interpretAndReplaceWithCachePositions()
+{
+	const std::string tml =
+			"a = _i ( abc )\n"
+			"b = 1\n"
+			"c = _i ( abc )\n"
+			"d = _i ( 1 + 2 )\n"
+			"e = _i ( 1 + 2 )\n"
+			"ff = _i ( abc )\n";
+	cfg::TmlParser parser;
+	parser.setStringBuffer("tml-expression", tml);
+	cfg::Value value;
+	if (!parser.getAsTree(value)) {
+		std::cout << "[FAIL] cache positions: parsing failed" << std::endl;
+		return false;
+	}
+	cfg::interpreter::ExpressionCache cache;
+	if (cfg::interpreter::interpretAndReplace(value, false, true, true, true, &cache, std::cout) < 0) {
+		std::cout << "[FAIL] cache positions: interpretation failed" << std::endl;
+		return false;
+	}
+	const cfg::Value* a = value.objectGetValue("a");
+	const cfg::Value* c = value.objectGetValue("c");
+	const cfg::Value* e = value.objectGetValue("e");
+	const cfg::Value* ff = value.objectGetValue("ff");
+	if (!a || !c || !e || !ff || a->mLineNumber != 1 || c->mLineNumber != 3 ||
+			c->mOffset != a->mOffset || !c->isText() || c->mText != "abc" ||
+			ff->mLineNumber != 6 || ff->mOffset != a->mOffset + 1 ||
+			!e->isInteger() || e->mInteger != 3 || cache.getHitCount() != 3) {
+		std::cout << "[FAIL] cache positions: line of a " << (a ? a->mLineNumber : -1) <<
+				", line of c " << (c ? c->mLineNumber : -1) <<
+				", hits " << cache.getHitCount() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// int64 and double are calculated without the loss of int or float
+static bool interpretWideNumbers()
+{
+	const std::string tml =
+			"a = _i ( 3000000000 + 1 )\n"
+			"b = _i ( 2.5 * 1.000000001 )\n"
+			"c = _i ( - 3000000000 )\n"
+			"d = _i ( 1 + 2 )\n"
+			"e = _i ( 6000000000 / 2 - 1 )\n";
+	cfg::TmlParser parser;
+	parser.setStringBuffer("tml-expression", tml);
+	cfg::Value value;
+	if (!parser.getAsTree(value) ||
+			cfg::interpreter::interpretAndReplace(value, false, true, true, true, nullptr, std::cout) < 0) {
+		std::cout << "[FAIL] wide numbers: interpretation failed" << std::endl;
+		return false;
+	}
+	const cfg::Value* a = value.objectGetValue("a");
+	const cfg::Value* b = value.objectGetValue("b");
+	const cfg::Value* c = value.objectGetValue("c");
+	const cfg::Value* d = value.objectGetValue("d");
+	const cfg::Value* e = value.objectGetValue("e");
+	if (!a || !a->isInteger64() || a->mInteger64 != 3000000001LL ||
+			!b || !b->isDouble() || std::fabs(b->mDouble - 2.5000000025) > 1e-12 ||
+			!c || !c->isInteger64() || c->mInteger64 != -3000000000LL ||
+			!d || !d->isInteger() || d->mInteger != 3 ||
+			!e || !e->isInteger64() || e->mInteger64 != 2999999999LL) {
+		std::cout << "[FAIL] wide numbers: " << cfg::tmlstring::valueToString(0, value);
+		return false;
+	}
+	cfg::Value division;
+	std::stringstream errMsg;
+	if (!getCfgValueWithArray("_i ( 3000000000 / 0 )", division) ||
+			cfg::interpreter::interpretAndReplaceExprValue(division, false, errMsg) >= 0 ||
+			errMsg.str().find("Division by zero.") != 0) {
+		std::cout << "[FAIL] wide numbers: division by zero" << std::endl;
+		return false;
+	}
+	std::cout << "wide number tests passed" << std::endl;
+	return true;
+}
+
+static bool interpretAndReplaceWithCacheTests()
+{
+	cfg::interpreter::ExpressionCache cache;
+	bool rv = true;
+	for (int i = 0; i < 2; ++i) {
+		rv = interpretAndReplaceWithCache("a1 _i ( 123 ) aa _i ( abc ) zz", cache) && rv;
+		rv = interpretAndReplaceWithCache("a1 b2 _i ( 123 + 23 + 123 ) aa _i ( 1920 / 2 ) zz", cache) && rv;
+		rv = interpretAndReplaceWithCache("_i ( 1920 / 2 )", cache) && rv;
+	}
+	// different parse bases are different expressions
+	rv = interpretAndReplaceWithCache("_i ( 0x10 + 1 )", cache) && rv;
+	rv = interpretAndReplaceWithCache("_i ( 16 + 1 )", cache) && rv;
+	// '_i ( 123 )' and '_i ( abc )' take the result from the source --> a hit
+	// takes the position from the current tokens
+	if (cache.size() != 6 || cache.getMissCount() != 6 || cache.getHitCount() != 6) {
+		std::cout << "[FAIL] cache: entries " << cache.size() <<
+				", misses " << cache.getMissCount() <<
+				", hits " << cache.getHitCount() << std::endl;
+		rv = false;
+	}
+	rv = interpretAndReplaceWithCachePositions() && rv;
+	std::cout << "expression cache tests " << (rv ? "passed" : "failed") << std::endl;
+	return rv;
+}
+
+static bool interpretTree(const std::string& tml, unsigned int threadCount,
+		cfg::Value& outValue, int& outRv, std::string& outErrMsg)
+{
+	cfg::TmlParser parser;
+	parser.setStringBuffer("tml-expression", tml);
+	if (!parser.getAsTree(outValue)) {
+		std::cout << "[FAIL] parallel: parsing failed" << std::endl;
+		return false;
+	}
+	std::stringstream errMsg;
+	outRv = (threadCount == 0) ?
+			cfg::interpreter::interpretAndReplace(outValue, false, true, true, true, errMsg) :
+			cfg::interpreter::interpretAndReplaceParallel(outValue, false, true, true, true,
+					threadCount, errMsg);
+	outErrMsg = errMsg.str();
+	return true;
+}
+
+// threadCount 0 is the serial interpretAndReplace()
+static bool interpretToText(const std::string& tml, unsigned int threadCount,
+		std::string& outResult, int& outRv, std::string& outErrMsg)
+{
+	cfg::Value value;
+	if (!interpretTree(tml, threadCount, value, outRv, outErrMsg)) {
+		return false;
+	}
+	outResult = cfg::tmlstring::valueToString(0, value);
+	return true;
+}
+
+static bool interpretAndReplaceParallelTests()
+{
+	bool rv = true;
+	std::string tml;
+	for (int i = 0; i < 50; ++i) {
+		std::string index = std::to_string(i);
+		tml += "k" + index + " = _i ( " + index + " * 2 + 1 ) and _i ( abc )\n";
+		tml += "obj" + index + "\n\tsub = _i ( 3000000000 + " + index + " )\n";
+	}
+	std::string serial;
+	int serialRv = 0;
+	std::string serialErrMsg;
+	rv = interpretToText(tml, 0, serial, serialRv, serialErrMsg) && rv;
+	const unsigned int threadCounts[] = {1, 2, 4, 8};
+	for (unsigned int threadCount : threadCounts) {
+		std::string parallel;
+		int parallelRv = 0;
+		std::string parallelErrMsg;
+		if (!interpretToText(tml, threadCount, parallel, parallelRv, parallelErrMsg) ||
+				parallel != serial || parallelRv != serialRv || parallelRv != 150 ||
+				!parallelErrMsg.empty()) {
+			std::cout << "[FAIL] parallel: " << threadCount << " threads, rv " <<
+					parallelRv << " (serial " << serialRv << ")" << std::endl;
+			rv = false;
+		}
+	}
+
+	// the errors of all failing subtrees in document order
+	const std::string failing =
+			"a = _i ( 1 / 0 )\n"
+			"b = _i ( 1 + 2 )\n"
+			"c = _i ( 1 - abc )\n"
+			"d = _i ( 3 )\n";
+	for (int i = 0; i < 20; ++i) {
+		std::string result;
+		int failingRv = 0;
+		std::string errMsg;
+		std::size_t divisionPos = std::string::npos;
+		std::size_t typePos = std::string::npos;
+		if (interpretToText(failing, 4, result, failingRv, errMsg)) {
+			divisionPos = errMsg.find("Division by zero.");
+			typePos = errMsg.find("is not supported");
+		}
+		if (failingRv != -1 || divisionPos == std::string::npos ||
+				typePos == std::string::npos || divisionPos > typePos) {
+			std::cout << "[FAIL] parallel errors: " << errMsg << std::endl;
+			rv = false;
+			break;
+		}
+	}
+
+	// the fallbacks use interpretAndReplace() which stops at the first error
+	std::string result;
+	int fallbackRv = 0;
+	std::string errMsg;
+	if (!interpretToText(failing, 1, result, fallbackRv, errMsg) || fallbackRv != -1 ||
+			errMsg.find("Division by zero.") == std::string::npos ||
+			errMsg.find("is not supported") != std::string::npos) {
+		std::cout << "[FAIL] parallel with one thread: " << errMsg << std::endl;
+		rv = false;
+	}
+	cfg::Value single;
+	errMsg.clear();
+	if (!interpretTree("a = _i ( 1 + 2 )\nb = 5\n", 4, single, fallbackRv, errMsg) ||
+			fallbackRv != 1 || single.objectGetValue("a") == nullptr ||
+			!single.objectGetValue("a")->isInteger() || single.objectGetValue("a")->mInteger != 3) {
+		std::cout << "[FAIL] parallel with less than two tasks: " << errMsg << std::endl;
+		rv = false;
+	}
+	std::cout << "parallel interpretation tests " << (rv ? "passed" : "failed") << std::endl;
+	return rv;
+}
+
 bool cfg::interpreter::unitTests()
 {
 	bool rv = true;
@@ -359,5 +590,8 @@ bool cfg::interpreter::unitTests()
 	rv = testsWithCfgLexer() && rv;
 	rv = interpretWithCfgLexer() && rv;
 	rv = interpretAndReplaceTests() && rv;
+	rv = interpretWideNumbers() && rv;
+	rv = interpretAndReplaceWithCacheTests() && rv;
+	rv = interpretAndReplaceParallelTests() && rv;
 	return rv;
 }
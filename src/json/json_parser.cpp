@@ -1,8 +1,12 @@
 #include <json/json_parser.h>
 #include <cfg/cfg.h>
+#include <cfg/cfg_number.h>
+#include <cfg/cfg_schema_validator.h>
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include <map>
+#include <cstring>
 
 #define JSMN_STRICT
 #include <json/jsmn.h>
@@ -125,9 +129,11 @@ namespace cfg
 		 * Dump the token t and its children into value val.
 		 * @return Count of dumped values/tokens.
 		 */
+		// packArrays: see ValueParser::setPackNumericArrays()
 		int dumpToValue(Value& val,
 				const std::shared_ptr<const std::string>& filenamePtr,
-				const char* js, jsmntok_t* t, size_t count, int indent)
+				const char* js, jsmntok_t* t, size_t count, int indent,
+				bool packArrays = false)
 		{
 			int i, j;
 			jsmntok_t* key;
@@ -150,23 +156,35 @@ namespace cfg
 								js, key, count - j, indent + 1);
 						if (key->size > 0) {
 							j += dumpToValue(val.mObject[i].mValue, filenamePtr,
-									js, t + 1 + j, count - j, indent + 1);
+									js, t + 1 + j, count - j, indent + 1, packArrays);
 						}
 					}
 					return j + 1;
 				case JSMN_ARRAY:
+					if (packArrays) {
+						// the numbers are packed while they are converted
+						ArrayBuilder builder(val, static_cast<std::size_t>(t->size), true);
+						Value element;
+						j = 0;
+						for (i = 0; i < t->size; i++) {
+							j += dumpToValue(element, filenamePtr,
+									js, t + 1 + j, count - j, indent + 1, packArrays);
+							builder.add(std::move(element));
+						}
+						builder.finish();
+						return j + 1;
+					}
 					val.setArray();
 					val.mArray.resize(t->size);
 					j = 0;
 					for (i = 0; i < t->size; i++) {
 						j += dumpToValue(val.mArray[i], filenamePtr,
-								js, t + 1 + j, count - j, indent + 1);
+								js, t + 1 + j, count - j, indent + 1, packArrays);
 					}
 					return j + 1;
 				case JSMN_STRING: {
 					//printf("'%.*s'", t->end - t->start, js + t->start);
-					std::string text;
-					text.insert(text.end(), js + t->start, js + t->end);
+					std::string text(js + t->start, js + t->end);
 					// in json only a text with quotes at begin and end is allowed.
 					// --> set parameter parseTextWithQuotes always to true.
 					val.setText(convertEscapeSequences(text), true);
@@ -174,45 +192,346 @@ namespace cfg
 				}
 				case JSMN_PRIMITIVE: {
 					//printf("%.*s", t->end - t->start, js + t->start);
-					std::string text;
-					text.insert(text.end(), js + t->start, js + t->end);
-					if (text == "null") {
+					// compare in place --> no string for null, true, false
+					// and valid numbers
+					const char* begin = js + t->start;
+					std::size_t len = static_cast<std::size_t>(t->end - t->start);
+					if (len == 4 && strncmp(begin, "null", 4) == 0) {
 						val.setNull();
-					} else if (text == "true" || text == "false") {
-						val.setBool(text == "true");
+					} else if (len == 4 && strncmp(begin, "true", 4) == 0) {
+						val.setBool(true);
+					} else if (len == 5 && strncmp(begin, "false", 5) == 0) {
+						val.setBool(false);
 					} else {
-						std::size_t len = text.length();
-						std::size_t i = 0;
-						unsigned int signCount = 0;
-						unsigned int digitCount = 0;
-						if (len > 0 && (text[0] == '+' || text[0] == '-')) {
-							++i;
-							signCount = 1;
+						if (!number::parseNumber(begin, js + t->end, true, val)) {
+							// --> no valid number
+							val.setFloatingPoint(static_cast<float>(
+									number::stringToDouble(std::string(begin, len))));
 						}
-						for (; i < len; ++i) {
-							if (text[i] >= '0' && text[i] <= '9') {
-								++digitCount;
-							}
+					}
+					return 1;
+				}
+			}
+			return 0;
+		}
+
+		// total byte offset of line start --> line number
+		typedef std::map<std::size_t, unsigned int> TLineNumbers;
+
+		unsigned int getLineNumber(const TLineNumbers& lines, unsigned int lineCount,
+				std::size_t offset)
+		{
+			const auto it = lines.upper_bound(offset);
+			return (it == lines.end()) ? lineCount : (it->second - 1);
+		}
+
+		// add the line starts of the len bytes at js (first line is firstLineNumber)
+		void addLineNumbers(const char* js, std::size_t len, unsigned int firstLineNumber,
+				TLineNumbers& lines, unsigned int& lineCount)
+		{
+			lines.clear();
+			lineCount = firstLineNumber;
+			lines[0] = lineCount;
+			for (std::size_t i = 0; i < len; ++i) {
+				if (js[i] == '\n') {
+					lines[i + 1] = ++lineCount;
+				}
+			}
+		}
+
+		/**
+		 * Read the full content of the stream. A 0-termination is added.
+		 */
+		bool readContent(std::istream& stream, std::vector<char>& fullContent,
+				TLineNumbers& lines, unsigned int& lineCount,
+				unsigned int& outLineNumber, std::string& outErrorMsg)
+		{
+			std::string line;
+			fullContent.clear();
+			lines.clear();
+			lineCount = 0;
+			for (;;) {
+				getline(stream, line);
+				if (stream.fail() && !stream.eof()) {
+					outLineNumber = lineCount;
+					outErrorMsg = "Can't read the full content of the file.";
+					return false;
+				}
+				if (stream.eof() && line.empty()) {
+					break;
+				}
+				++lineCount;
+				lines[fullContent.size()] = lineCount;
+				fullContent.insert(fullContent.end(), line.begin(), line.end());
+				fullContent.push_back('\n');
+				//std::cout << "Add line " << lineNumber << " length " << line.size() << std::endl;
+				if (stream.eof()) {
+					break;
+				}
+			}
+			fullContent.push_back('\0'); // termination --> char-array is a compatible c-string
+			return true;
+		}
+
+		/**
+		 * Create the tokens of the len bytes at js.
+		 * @param offset Offset of js at the full content (for the line number
+		 *        of an error).
+		 */
+		bool parseTokens(const char* js, std::size_t len, std::size_t offset,
+				const TLineNumbers& lines, unsigned int lineCount,
+				std::vector<jsmntok_t>& tok, unsigned int& outTokenCount,
+				unsigned int& outLineNumber, std::string& outErrorMsg)
+		{
+			jsmn_parser p;
+			jsmn_init(&p); // Prepare parser
+
+			if (tok.size() < 128) {
+				tok.resize(128);
+			}
+
+			int rv = 0;
+			do {
+				rv = jsmn_parse(&p, js, len, tok.data(), static_cast<unsigned int>(tok.size()));
+				if (rv < 0) {
+					switch (rv) {
+						case JSMN_ERROR_INVAL:
+						case JSMN_ERROR_PART:
+						{
+							outLineNumber = getLineNumber(lines, lineCount, offset + p.pos);
+							outErrorMsg =
+									(rv == JSMN_ERROR_INVAL) ?
+									"Bad token, JSON string is corrupted." :
+									"JSON string is too short, expecting more JSON data";
+							return false;
 						}
-						if (signCount + digitCount == len) {
-							// --> integer value
-							val.setInteger(atoi(text.c_str()), 10);
+						case JSMN_ERROR_NOMEM:
+							tok.resize(tok.size() * 2);
+							//std::cout << "not enough tokens, JSON string is too large --> resize tokens" << std::endl;
+							break;
+					}
+				}
+				//std::cout << "parser returned: " << rv << std::endl;
+			} while (rv == JSMN_ERROR_NOMEM);
+
+			if (rv < 0) {
+				// should not really be possible.
+				outLineNumber = lineCount;
+				outErrorMsg = "Unexpected error.";
+				return false;
+			}
+			outTokenCount = p.toknext;
+			return true;
+		}
+
+		/**
+		 * Read the full content of the stream and create the tokens.
+		 */
+		bool tokenize(std::istream& stream, std::vector<char>& fullContent,
+				std::vector<jsmntok_t>& tok, unsigned int& outTokenCount,
+				unsigned int& outLineNumber, std::string& outErrorMsg)
+		{
+			TLineNumbers lines;
+			unsigned int lineCount = 0;
+			if (!readContent(stream, fullContent, lines, lineCount,
+					outLineNumber, outErrorMsg)) {
+				return false;
+			}
+			return parseTokens(fullContent.data(), fullContent.size() - 1, 0,
+					lines, lineCount, tok, outTokenCount, outLineNumber, outErrorMsg);
+		}
+
+		std::size_t skipSpaces(const char* js, std::size_t pos)
+		{
+			while (js[pos] == ' ' || js[pos] == '\t' || js[pos] == '\n' || js[pos] == '\r') {
+				++pos;
+			}
+			return pos;
+		}
+
+		// js[pos] must be ". return the position after the string, 0 for error
+		std::size_t skipString(const char* js, std::size_t pos)
+		{
+			for (++pos; js[pos]; ++pos) {
+				if (js[pos] == '\\') {
+					if (!js[pos + 1]) {
+						return 0;
+					}
+					++pos;
+				}
+				else if (js[pos] == '"') {
+					return pos + 1;
+				}
+			}
+			return 0;
+		}
+
+		/**
+		 * Return the position after the value which begins at pos, 0 for
+		 * error. Objects and arrays are skipped by bracket matching
+		 * (only the strings are respected, the content isn't checked).
+		 */
+		std::size_t skipValue(const char* js, std::size_t pos)
+		{
+			if (js[pos] == '"') {
+				return skipString(js, pos);
+			}
+			if (js[pos] == '{' || js[pos] == '[') {
+				int depth = 0;
+				for (; js[pos]; ++pos) {
+					char ch = js[pos];
+					if (ch == '"') {
+						pos = skipString(js, pos);
+						if (!pos) {
+							return 0;
 						}
-						else {
-							// --> floating point
-							val.setFloatingPoint(static_cast<float>(atof(text.c_str())));
+						--pos; // last character of the string
+					}
+					else if (ch == '{' || ch == '[') {
+						++depth;
+					}
+					else if ((ch == '}' || ch == ']') && --depth == 0) {
+						return pos + 1;
+					}
+				}
+				return 0;
+			}
+			// primitive
+			std::size_t begin = pos;
+			while (js[pos] && !strchr(" \t\r\n,]}", js[pos])) {
+				++pos;
+			}
+			return (pos > begin) ? pos : 0;
+		}
+
+		/**
+		 * Convert only the members of the root object with a name of
+		 * projection. The values of the other members are skipped
+		 * without creating tokens.
+		 */
+		bool dumpProjectionToValue(Value& root,
+				const std::shared_ptr<const std::string>& filenamePtr,
+				const std::vector<char>& fullContent, const TLineNumbers& lines,
+				unsigned int lineCount, const std::set<std::string>& projection,
+				bool packArrays, unsigned int& outLineNumber, std::string& outErrorMsg)
+		{
+			const char* js = fullContent.data();
+			std::size_t pos = skipSpaces(js, 0);
+			if (js[pos] != '{') {
+				outLineNumber = getLineNumber(lines, lineCount, pos);
+				outErrorMsg = "The root value must be an object.";
+				return false;
+			}
+			root.setObject();
+			root.mFilename = filenamePtr;
+			pos = skipSpaces(js, pos + 1);
+			if (js[pos] == '}') {
+				return true;
+			}
+			std::vector<jsmntok_t> tok;
+			for (;;) {
+				std::size_t nameEnd = (js[pos] == '"') ? skipString(js, pos) : 0;
+				std::size_t valuePos = nameEnd ? skipSpaces(js, nameEnd) : 0;
+				if (!nameEnd || js[valuePos] != ':') {
+					outLineNumber = getLineNumber(lines, lineCount, pos);
+					outErrorMsg = "Bad token, JSON string is corrupted.";
+					return false;
+				}
+				valuePos = skipSpaces(js, valuePos + 1);
+				std::size_t valueEnd = skipValue(js, valuePos);
+				if (!valueEnd) {
+					outLineNumber = getLineNumber(lines, lineCount, valuePos);
+					outErrorMsg = "Bad token, JSON string is corrupted.";
+					return false;
+				}
+				std::string name(js + pos + 1, js + nameEnd - 1);
+				name = convertEscapeSequences(name);
+				if (projection.count(name)) {
+					root.mObject.emplace_back();
+					NameValuePair& nvp = root.mObject.back();
+					nvp.mDeep = 0;
+					nvp.mName.mFilename = filenamePtr;
+					nvp.mName.setText(std::move(name), true);
+					const char* valueJs = js + valuePos;
+					std::size_t valueLen = valueEnd - valuePos;
+					unsigned int tokenCount = 1;
+					if (*valueJs == '"' || *valueJs == '{' || *valueJs == '[') {
+						if (!parseTokens(valueJs, valueLen, valuePos, lines, lineCount,
+								tok, tokenCount, outLineNumber, outErrorMsg)) {
+							return false;
 						}
 					}
-					return 1;
+					else {
+						// jsmn (strict) needs a following delimiter for a primitive
+						tok.resize(1);
+						tok[0].type = JSMN_PRIMITIVE;
+						tok[0].start = 0;
+						tok[0].end = static_cast<int>(valueLen);
+						tok[0].size = 0;
+					}
+					dumpToValue(nvp.mValue, filenamePtr, valueJs, tok.data(), tokenCount, 1,
+							packArrays);
 				}
+				pos = skipSpaces(js, valueEnd);
+				if (js[pos] == '}') {
+					return true;
+				}
+				if (js[pos] != ',') {
+					outLineNumber = getLineNumber(lines, lineCount, pos);
+					outErrorMsg = "Bad token, JSON string is corrupted.";
+					return false;
+				}
+				pos = skipSpaces(js, pos + 1);
 			}
-			return 0;
+		}
+
+		/**
+		 * Validate the members of the object token t with the validator.
+		 * Only the members (and not the full object) are converted to values.
+		 * @return Count of used tokens or -1 if stopped.
+		 */
+		int dumpToValidator(SchemaValidator& validator,
+				const std::shared_ptr<const std::string>& filenamePtr,
+				const char* js, jsmntok_t* t, size_t count,
+				bool stopAtFirstViolation, std::string& outErrorMsg)
+		{
+			if (count == 0 || t->type != JSMN_OBJECT) {
+				return 0;
+			}
+			NameValuePair nvp;
+			int j = 0;
+			for (int i = 0; i < t->size; i++) {
+				jsmntok_t* key = t + 1 + j;
+				j += dumpToValue(nvp.mName, filenamePtr, js, key, count - j, 1);
+				if (key->size > 0 && (t + 1 + j)->type == JSMN_OBJECT) {
+					validator.streamBeginObject(nvp.mName, outErrorMsg);
+					int rv = dumpToValidator(validator, filenamePtr, js,
+							t + 1 + j, count - j, stopAtFirstViolation, outErrorMsg);
+					if (rv < 0) {
+						return -1;
+					}
+					j += rv;
+					validator.streamEndObject(outErrorMsg);
+				}
+				else {
+					nvp.mValue.clear();
+					if (key->size > 0) {
+						j += dumpToValue(nvp.mValue, filenamePtr, js,
+								t + 1 + j, count - j, 1);
+					}
+					validator.streamNameValuePair(nvp, outErrorMsg);
+				}
+				if (stopAtFirstViolation && validator.getViolationCount()) {
+					return -1;
+				}
+			}
+			return j + 1;
 		}
 	}
 }
 
 cfg::JsonParser::JsonParser()
-	:mFilename(), mErrorMsg(), mLineNumber(0)
+	:mFilename(), mErrorMsg(), mLineNumber(0), mStrBuffer(), mUseStrBuffer(false)
 {
 }
 
@@ -230,6 +549,7 @@ void cfg::JsonParser::reset()
 {
 	mErrorMsg.clear();
 	mLineNumber = 0;
+	mFeedActive = false;
 }
 
 bool cfg::JsonParser::setFilename(const std::string& filename)
@@ -237,6 +557,19 @@ bool cfg::JsonParser::setFilename(const std::string& filename)
 	reset();
 
 	mFilename = filename;
+	mStrBuffer.clear();
+	mUseStrBuffer = false;
+	return true;
+}
+
+bool cfg::JsonParser::setStringBuffer(const std::string& pseudoFilename,
+		const std::string& strBuffer)
+{
+	reset();
+
+	mFilename = pseudoFilename;
+	mStrBuffer = strBuffer;
+	mUseStrBuffer = true;
 	return true;
 }
 
@@ -253,17 +586,44 @@ bool cfg::JsonParser::getAsTree(NameValuePair &root)
 
 bool cfg::JsonParser::getAsTree(Value &root)
 {
-	return getAsTree(root, mFilename, mLineNumber, mErrorMsg);
+	bool success = false;
+	if (!mProjection.empty()) {
+		if (mUseStrBuffer) {
+			std::istringstream iss(mStrBuffer);
+			success = getAsTree(root, mFilename, iss, mProjection, mLineNumber, mErrorMsg,
+					mPackNumericArrays);
+		}
+		else {
+			std::ifstream ifs(mFilename, std::ifstream::in);
+			if (ifs.fail()) {
+				root.clear();
+				mLineNumber = 0;
+				mErrorMsg = "Can't open file.";
+			}
+			else {
+				success = getAsTree(root, mFilename, ifs, mProjection, mLineNumber, mErrorMsg,
+						mPackNumericArrays);
+			}
+		}
+	}
+	else if (mUseStrBuffer) {
+		std::istringstream iss(mStrBuffer);
+		success = getAsTree(root, mFilename, iss, mLineNumber, mErrorMsg, mPackNumericArrays);
+	}
+	else {
+		success = getAsTree(root, mFilename, mLineNumber, mErrorMsg, mPackNumericArrays);
+	}
+	return success;
 }
 
 bool cfg::JsonParser::getAsTree(Value& root,
 		bool /*inclEmptyLines*/, bool /*inclComments*/)
 {
-	return getAsTree(root, mFilename, mLineNumber, mErrorMsg);
+	return getAsTree(root);
 }
 
 bool cfg::JsonParser::getAsTree(Value &root, const std::string& filename,
-		unsigned int& outLineNumber, std::string& outErrorMsg)
+		unsigned int& outLineNumber, std::string& outErrorMsg, bool packNumericArrays)
 {
 	root.clear();
 
@@ -274,86 +634,343 @@ bool cfg::JsonParser::getAsTree(Value &root, const std::string& filename,
 		outErrorMsg = "Can't open file.";
 		return false;
 	}
-	bool rv = getAsTree(root, filename, ifs, outLineNumber, outErrorMsg);
+	bool rv = getAsTree(root, filename, ifs, outLineNumber, outErrorMsg, packNumericArrays);
 	ifs.close();
 	return rv;
 }
 
 bool cfg::JsonParser::getAsTree(Value &root, const std::string& filenameInfo,
 		std::istream& stream, unsigned int& outLineNumber,
-		std::string& outErrorMsg)
+		std::string& outErrorMsg, bool packNumericArrays)
 {
 	root.clear();
 
-	std::map<std::size_t /* total byte offset of line start */, unsigned int /* line number */> lines;
-	std::string line;
 	std::vector<char> fullContent;
+	std::vector<jsmntok_t> tok;
+	unsigned int tokenCount = 0;
+	if (!tokenize(stream, fullContent, tok, tokenCount, outLineNumber, outErrorMsg)) {
+		return false;
+	}
+
+	std::shared_ptr<const std::string> filenamePtr = std::make_shared<const std::string>(filenameInfo);
+	dumpToValue(root, filenamePtr, fullContent.data(), tok.data(), tokenCount, 0,
+			packNumericArrays);
+	return true;
+}
+
+bool cfg::JsonParser::getAsTree(Value& root, const std::string& filenameInfo,
+		std::istream& stream, const std::set<std::string>& projection,
+		unsigned int& outLineNumber, std::string& outErrorMsg, bool packNumericArrays)
+{
+	root.clear();
+
+	std::vector<char> fullContent;
+	TLineNumbers lines;
 	unsigned int lineCount = 0;
-	for (;;) {
-		getline(stream, line);
-		if (stream.fail() && !stream.eof()) {
-			outLineNumber = lineCount;
-			outErrorMsg = "Can't read the full content of the file.";
-			return false;
-		}
-		if (stream.eof() && line.empty()) {
-			break;
-		}
-		++lineCount;
-		lines[fullContent.size()] = lineCount;
-		fullContent.insert(fullContent.end(), line.begin(), line.end());
-		fullContent.push_back('\n');
-		//std::cout << "Add line " << lineNumber << " length " << line.size() << std::endl;
-		if (stream.eof()) {
-			break;
-		}
+	if (!readContent(stream, fullContent, lines, lineCount, outLineNumber, outErrorMsg)) {
+		return false;
 	}
-	fullContent.push_back('\0'); // termination --> char-array is a compatible c-string
+	std::shared_ptr<const std::string> filenamePtr = std::make_shared<const std::string>(filenameInfo);
+	if (!dumpProjectionToValue(root, filenamePtr, fullContent, lines, lineCount,
+			projection, packNumericArrays, outLineNumber, outErrorMsg)) {
+		root.clear();
+		return false;
+	}
+	return true;
+}
 
-	jsmn_parser p;
-	jsmn_init(&p); // Prepare parser
+bool cfg::JsonParser::beginFeed(const std::string& pseudoFilename)
+{
+	reset();
 
-	std::vector<jsmntok_t> tok;
-	tok.resize(128);
-
-	int rv = 0;
-	do {
-		rv = jsmn_parse(&p, fullContent.data(), fullContent.size() - 1, tok.data(), static_cast<unsigned int>(tok.size()));
-		if (rv < 0) {
-			switch (rv) {
-				case JSMN_ERROR_INVAL:
-				case JSMN_ERROR_PART:
-				{
-					const auto it = lines.upper_bound(p.pos);
-					outLineNumber = (it == lines.end()) ?
-							lineCount : (it->second - 1);
-					outErrorMsg =
-							(rv == JSMN_ERROR_INVAL) ?
-							"Bad token, JSON string is corrupted." :
-							"JSON string is too short, expecting more JSON data";
+	mFilename = pseudoFilename;
+	mStrBuffer.clear();
+	mUseStrBuffer = true;
+	mFeedActive = true;
+	mFeedRootChar = 0;
+	mFeedRootEnd = false;
+	mFeedStopped = false;
+	mFeedDepth = 0;
+	mFeedInString = false;
+	mFeedEscape = false;
+	mFeedBuffer.clear();
+	mFeedBufferLineNumber = 1;
+	mLineNumber = 1;
+	if (!mFeedRoot) {
+		mFeedRoot.reset(new Value());
+	}
+	mFeedRoot->clear();
+	mFeedFilenamePtr = std::make_shared<const std::string>(pseudoFilename);
+	return true;
+}
+
+bool cfg::JsonParser::feed(const char* data, std::size_t size)
+{
+	if (!mFeedActive) {
+		if (mErrorMsg.empty()) {
+			mErrorMsg = "No feed is started (see beginFeed()).";
+		}
+		return false;
+	}
+	for (const char* end = data + size; data < end && !mFeedStopped; ++data) {
+		char ch = *data;
+		if (ch == '\n') {
+			++mLineNumber;
+		}
+		if (mFeedRootEnd) {
+			// only white spaces are allowed after the root (same as getAsTree())
+			if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+				continue;
+			}
+			return feedError("Bad token, JSON string is corrupted.");
+		}
+		if (mFeedRootChar == 0) {
+			if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+				continue;
+			}
+			if (mFeedValidator && ch != '{') {
+				return feedError("The root value must be an object.");
+			}
+			if (ch == '{' || ch == '[') {
+				mFeedRootChar = ch;
+				mFeedDepth = 1;
+				if (ch == '{') {
+					mFeedRoot->setObject();
+				}
+				else {
+					mFeedRoot->setArray();
+				}
+				mFeedRoot->mFilename = mFeedFilenamePtr;
+				mFeedBufferLineNumber = mLineNumber;
+				continue;
+			}
+			// a string or a primitive is parsed by finish()
+			mFeedRootChar = ' ';
+			mFeedBufferLineNumber = mLineNumber;
+		}
+		if (mFeedRootChar == ' ') {
+			mFeedBuffer.push_back(ch);
+			continue;
+		}
+		// only the strings and the brackets are respected to find the end
+		// of a member (same as skipValue()), the member is checked by jsmn
+		if (mFeedInString) {
+			if (mFeedEscape) {
+				mFeedEscape = false;
+			}
+			else if (ch == '\\') {
+				mFeedEscape = true;
+			}
+			else if (ch == '"') {
+				mFeedInString = false;
+			}
+		}
+		else if (ch == '"') {
+			mFeedInString = true;
+		}
+		else if (ch == '{' || ch == '[') {
+			++mFeedDepth;
+		}
+		else if (ch == '}' || ch == ']') {
+			if (--mFeedDepth == 0) {
+				if (ch != (mFeedRootChar == '{' ? '}' : ']')) {
+					return feedError("Bad token, JSON string is corrupted.");
+				}
+				mFeedRootEnd = true;
+				if (!feedMember()) {
 					return false;
 				}
-				case JSMN_ERROR_NOMEM:
-					tok.resize(tok.size() * 2);
-					//std::cout << "not enough tokens, JSON string is too large --> resize tokens" << std::endl;
-					break;
+				continue;
+			}
+		}
+		else if (ch == ',' && mFeedDepth == 1) {
+			if (!feedMember()) {
+				return false;
 			}
+			mFeedBufferLineNumber = mLineNumber;
+			continue;
 		}
-		//std::cout << "parser returned: " << rv << std::endl;
-	} while (rv == JSMN_ERROR_NOMEM);
+		mFeedBuffer.push_back(ch);
+	}
+	return true;
+}
 
-	if (rv < 0) {
-		// should not really be possible.
-		outLineNumber = lineCount;
-		outErrorMsg = "Unexpected error.";
+bool cfg::JsonParser::finish(Value& root)
+{
+	root.clear();
+	if (!mFeedActive) {
+		if (mErrorMsg.empty()) {
+			mErrorMsg = "No feed is started (see beginFeed()).";
+		}
 		return false;
 	}
+	if (mFeedRootChar == ' ') {
+		TLineNumbers lines;
+		unsigned int lineCount = 0;
+		addLineNumbers(mFeedBuffer.data(), mFeedBuffer.size(), mFeedBufferLineNumber,
+				lines, lineCount);
+		std::vector<jsmntok_t> tok;
+		unsigned int tokenCount = 0;
+		if (!parseTokens(mFeedBuffer.c_str(), mFeedBuffer.size(), 0, lines, lineCount,
+				tok, tokenCount, mLineNumber, mErrorMsg)) {
+			mFeedActive = false;
+			return false;
+		}
+		dumpToValue(root, mFeedFilenamePtr, mFeedBuffer.c_str(), tok.data(), tokenCount, 0,
+				mPackNumericArrays);
+	}
+	else if (mFeedRootChar) {
+		if (!mFeedRootEnd) {
+			return feedError("JSON string is too short, expecting more JSON data");
+		}
+		root = std::move(*mFeedRoot);
+		if (mPackNumericArrays) {
+			// the elements of a root array are fed one by one
+			root.packArray();
+		}
+	}
+	mFeedActive = false;
+	mFeedBuffer.clear();
+	mFeedRoot->clear();
+	return true;
+}
 
-	std::shared_ptr<const std::string> filenamePtr = std::make_shared<const std::string>(filenameInfo);
-	dumpToValue(root, filenamePtr, fullContent.data(), tok.data(), p.toknext, 0);
+bool cfg::JsonParser::feedMember()
+{
+	// the member is parsed as the only member of a container
+	std::string& js = mFeedBuffer;
+	if (js.find_first_not_of(" \t\r\n") == std::string::npos) {
+		// empty container or an empty member (e.g. "[1,,2]" or "[1,]"),
+		// which jsmn accepts too
+		js.clear();
+		return true;
+	}
+	bool isObject = mFeedRootChar == '{';
+	if (!mProjection.empty() && isObject && !mFeedValidator) {
+		std::size_t pos = skipSpaces(js.c_str(), 0);
+		std::size_t nameEnd = (js[pos] == '"') ? skipString(js.c_str(), pos) : 0;
+		if (nameEnd && !mProjection.count(
+				convertEscapeSequences(js.substr(pos + 1, nameEnd - pos - 2)))) {
+			js.clear();
+			return true;
+		}
+	}
+	js.insert(js.begin(), isObject ? '{' : '[');
+	js.push_back(isObject ? '}' : ']');
+	TLineNumbers lines;
+	unsigned int lineCount = 0;
+	addLineNumbers(js.data(), js.size(), mFeedBufferLineNumber, lines, lineCount);
+	std::vector<jsmntok_t> tok;
+	unsigned int tokenCount = 0;
+	std::string errorMsg;
+	if (!parseTokens(js.c_str(), js.size(), 0, lines, lineCount,
+			tok, tokenCount, mLineNumber, errorMsg)) {
+		return feedError(errorMsg);
+	}
+	if (tok[0].size != 1) {
+		mLineNumber = mFeedBufferLineNumber;
+		return feedError("Bad token, JSON string is corrupted.");
+	}
+	if (mFeedValidator) {
+		if (dumpToValidator(*mFeedValidator, mFeedFilenamePtr, js.c_str(), tok.data(),
+				tokenCount, mFeedStopAtFirstViolation, *mFeedViolations) < 0) {
+			// the rest of the stream isn't read
+			mFeedStopped = true;
+			mFeedRootEnd = true;
+		}
+		js.clear();
+		return true;
+	}
+	Value container;
+	dumpToValue(container, mFeedFilenamePtr, js.c_str(), tok.data(), tokenCount, 0,
+			mPackNumericArrays);
+	// the wrapper "[member]" of a number is packed
+	container.unpackArray();
+	if (isObject) {
+		mFeedRoot->mObject.push_back(std::move(container.mObject[0]));
+	}
+	else {
+		mFeedRoot->mArray.push_back(std::move(container.mArray[0]));
+	}
+	js.clear();
 	return true;
 }
 
+bool cfg::JsonParser::feedError(const std::string& errorMsg)
+{
+	mErrorMsg = errorMsg;
+	mFeedActive = false;
+	mFeedBuffer.clear();
+	mFeedRoot->clear();
+	return false;
+}
+
+bool cfg::JsonParser::validateStream(SchemaValidator& validator,
+		bool stopAtFirstViolation, std::string& outErrorMsg)
+{
+	if (mUseStrBuffer) {
+		std::istringstream iss(mStrBuffer);
+		return validateStream(validator, mFilename, iss, stopAtFirstViolation,
+				mLineNumber, outErrorMsg);
+	}
+	std::ifstream ifs;
+	ifs.open(mFilename, std::ifstream::in);
+	if (ifs.fail()) {
+		mLineNumber = 0;
+		mErrorMsg = "Can't open file.";
+		outErrorMsg = getExtendedErrorMsg();
+		return false;
+	}
+	bool rv = validateStream(validator, mFilename, ifs, stopAtFirstViolation,
+			mLineNumber, outErrorMsg);
+	ifs.close();
+	return rv;
+}
+
+bool cfg::JsonParser::validateStream(SchemaValidator& validator,
+		const std::string& filenameInfo, std::istream& stream,
+		bool stopAtFirstViolation, unsigned int& outLineNumber,
+		std::string& outErrorMsg)
+{
+	outErrorMsg.clear();
+	validator.beginStream(std::make_shared<const std::string>(filenameInfo));
+
+	JsonParser parser;
+	parser.beginFeed(filenameInfo);
+	parser.mFeedValidator = &validator;
+	parser.mFeedStopAtFirstViolation = stopAtFirstViolation;
+	parser.mFeedViolations = &outErrorMsg;
+	std::vector<char> buffer(16 * 1024);
+	bool success = true;
+	while (success && !parser.mFeedStopped && stream) {
+		stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		std::streamsize n = stream.gcount();
+		if (n <= 0) {
+			break;
+		}
+		success = parser.feed(buffer.data(), static_cast<std::size_t>(n));
+	}
+	if (parser.mFeedStopped) {
+		return false;
+	}
+	if (success && stream.bad()) {
+		success = parser.feedError("Can't read the full content of the file.");
+	}
+	if (success && parser.mFeedRootChar == 0) {
+		success = parser.feedError("The root value must be an object.");
+	}
+	if (success && !parser.mFeedRootEnd) {
+		success = parser.feedError("JSON string is too short, expecting more JSON data");
+	}
+	if (!success) {
+		outLineNumber = parser.mLineNumber;
+		outErrorMsg = filenameInfo + ":" + std::to_string(outLineNumber) + ": " +
+				parser.mErrorMsg;
+		return false;
+	}
+	return validator.endStream(outErrorMsg);
+}
+
 std::string cfg::JsonParser::getExtendedErrorMsg() const
 {
 	return mFilename + ":" + std::to_string(mLineNumber) + ": " + mErrorMsg;
@@ -1,5 +1,6 @@
 #include <json/json_string.h>
 #include <cfg/cfg.h>
+#include <cfg/cfg_number.h>
 #include <sstream>
 
 namespace cfg
@@ -104,11 +105,17 @@ namespace cfg
 				case Value::TYPE_INT:
 					ss << cfgValue.mInteger;
 					break;
+				case Value::TYPE_INT64:
+					ss << cfgValue.mInteger64;
+					break;
+				case Value::TYPE_DOUBLE:
+					ss << number::doubleToString(cfgValue.mDouble, true);
+					break;
 				case Value::TYPE_TEXT:
 					addTextForJson(ss, cfgValue.mText);
 					break;
 				case Value::TYPE_ARRAY:
-					if (cfgValue.isArray() && cfgValue.mArray.empty()) {
+					if (cfgValue.isArray() && !cfgValue.arraySize()) {
 						ss << "[]";
 						break;
 					}
@@ -134,6 +141,12 @@ namespace cfg
 				addSimpleValueToStream(cfgValue, ss);
 				return;
 			}
+			if (cfgValue.isPackedArray()) {
+				Value unpacked = cfgValue;
+				unpacked.unpackArray();
+				addValueToStream(deep, unpacked, ss, indentMode);
+				return;
+			}
 			if (cfgValue.isArray()) {
 				std::size_t cnt = cfgValue.mArray.size();
 				// for a "full array is simple" only these three values are allowed:
@@ -143,7 +156,7 @@ namespace cfg
 				bool fullArrayIsSimple = true;
 				for (std::size_t i = 0; i < cnt; ++i) {
 					if (!cfgValue.mArray[i].isSimple() &&
-							!(cfgValue.mArray[i].isArray() && cfgValue.mArray[i].mArray.empty()) &&
+							!(cfgValue.mArray[i].isArray() && !cfgValue.mArray[i].arraySize()) &&
 							!(cfgValue.mArray[i].isObject() && cfgValue.mArray[i].mObject.empty())) {
 						fullArrayIsSimple = false;
 						break;
@@ -0,0 +1,209 @@
+#include <json/json_writer.h>
+#include <json/json_string.h>
+#include <sstream>
+
+namespace cfg
+{
+	namespace
+	{
+		std::string getJsonText(unsigned int deep, const Value& value, int indentMode)
+		{
+			std::ostringstream oss;
+			jsonstring::valueToStream(deep, value, oss, indentMode, false, false);
+			return oss.str();
+		}
+	}
+}
+
+cfg::JsonWriter::JsonWriter(std::ostream& s, int indentMode)
+		:mStream(s),
+		mIndentMode(indentMode)
+{
+	mFrames.emplace_back(false, 0, true);
+}
+
+void cfg::JsonWriter::writePair(const NameValuePair& nvp)
+{
+	std::size_t index = mFrames.size() - 1;
+	prepareChild(index);
+	jsonstring::nameValuePairToStream(mFrames[index].mDeep + 1, nvp,
+			mStream, mIndentMode);
+}
+
+void cfg::JsonWriter::writeElement(const Value& value)
+{
+	addElementText(getJsonText(mFrames.back().mDeep + 1, value, mIndentMode),
+			value.isSimple());
+}
+
+void cfg::JsonWriter::beginObject(const Value* name)
+{
+	std::size_t parentIndex = mFrames.size() - 1;
+	unsigned int deep = mFrames[parentIndex].mDeep + 1;
+	if (name) {
+		// --> child of an object
+		prepareChild(parentIndex);
+		addIndent(deep);
+		mStream << getJsonText(deep, *name, mIndentMode) << ": ";
+	}
+	mFrames.emplace_back(false, deep, name != nullptr);
+}
+
+void cfg::JsonWriter::endObject()
+{
+	Frame& frame = mFrames.back();
+	if (frame.mCount) {
+		addNewline();
+		addIndent(frame.mDeep);
+		mStream << "}";
+		mFrames.pop_back();
+	}
+	else if (frame.mIsStarted) {
+		mStream << "{}";
+		mFrames.pop_back();
+	}
+	else {
+		mFrames.pop_back();
+		addElementText("{}", true);
+	}
+}
+
+void cfg::JsonWriter::beginArray(const Value* name)
+{
+	std::size_t parentIndex = mFrames.size() - 1;
+	unsigned int deep = mFrames[parentIndex].mDeep + 1;
+	if (name) {
+		prepareChild(parentIndex);
+		addIndent(deep);
+		mStream << getJsonText(deep, *name, mIndentMode) << ": ";
+	}
+	mFrames.emplace_back(true, deep, name != nullptr);
+}
+
+void cfg::JsonWriter::endArray()
+{
+	Frame& frame = mFrames.back();
+	if (frame.mIsComplex) {
+		addNewline();
+		addIndent(frame.mDeep);
+		mStream << "]";
+		mFrames.pop_back();
+	}
+	else if (!frame.mSimpleTexts.empty()) {
+		// --> started by the first element
+		mStream << "[";
+		for (std::size_t i = 0; i < frame.mSimpleTexts.size(); ++i) {
+			if (i) {
+				mStream << ", ";
+			}
+			mStream << frame.mSimpleTexts[i];
+		}
+		mStream << "]";
+		mFrames.pop_back();
+	}
+	else if (frame.mIsStarted) {
+		mStream << "[]";
+		mFrames.pop_back();
+	}
+	else {
+		mFrames.pop_back();
+		addElementText("[]", true);
+	}
+}
+
+void cfg::JsonWriter::endDocument()
+{
+	// the root object is always started
+	mFrames.back().mIsStarted = true;
+	endObject();
+}
+
+void cfg::JsonWriter::start(std::size_t frameIndex)
+{
+	if (mFrames[frameIndex].mIsStarted) {
+		return;
+	}
+	// --> element of an array (all other frames are started at the begin)
+	std::size_t parentIndex = frameIndex - 1;
+	makeComplex(parentIndex);
+	prepareChild(parentIndex);
+	addIndent(mFrames[parentIndex].mDeep + 1);
+	mFrames[frameIndex].mIsStarted = true;
+}
+
+void cfg::JsonWriter::prepareChild(std::size_t frameIndex)
+{
+	Frame& frame = mFrames[frameIndex];
+	if (frame.mCount) {
+		mStream << ",";
+		addNewline();
+	}
+	else if (!frame.mIsArray) {
+		start(frameIndex);
+		mStream << "{";
+		addNewline();
+	}
+	// else: "[" is written by makeComplex()
+	++frame.mCount;
+}
+
+void cfg::JsonWriter::makeComplex(std::size_t frameIndex)
+{
+	if (mFrames[frameIndex].mIsComplex) {
+		return;
+	}
+	start(frameIndex);
+	Frame& frame = mFrames[frameIndex];
+	frame.mIsComplex = true;
+	mStream << "[";
+	addNewline();
+	for (const std::string& text : frame.mSimpleTexts) {
+		prepareChild(frameIndex);
+		addIndent(frame.mDeep + 1);
+		mStream << text;
+	}
+	frame.mSimpleTexts.clear();
+}
+
+void cfg::JsonWriter::addElementText(const std::string& text, bool isSimple)
+{
+	std::size_t index = mFrames.size() - 1;
+	// an array with an element is written in any case
+	start(index);
+	if (!isSimple) {
+		makeComplex(index);
+	}
+	Frame& frame = mFrames[index];
+	if (frame.mIsComplex) {
+		prepareChild(index);
+		addIndent(frame.mDeep + 1);
+		mStream << text;
+	}
+	else {
+		frame.mSimpleTexts.push_back(text);
+	}
+}
+
+void cfg::JsonWriter::addIndent(unsigned int deep)
+{
+	if (mIndentMode < 0) {
+		return;
+	}
+	if (mIndentMode == 0) {
+		for (unsigned int i = 0; i < deep; ++i) {
+			mStream << '\t';
+		}
+		return;
+	}
+	unsigned int count = deep * static_cast<unsigned int>(mIndentMode);
+	for (unsigned int i = 0; i < count; ++i) {
+		mStream << ' ';
+	}
+}
+
+void cfg::JsonWriter::addNewline()
+{
+	if (mIndentMode >= -1) {
+		mStream << '\n';
+	}
+}
@@ -0,0 +1,360 @@
+#include <tml/tml_index.h>
+#include <tml/tml_parser.h>
+#include <tml/tml_string.h>
+#include <btml/btml_parser.h>
+#include <btml/btml_stream.h>
+#include <cfg/cfg.h>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+#include <fstream>
+
+namespace cfg
+{
+	namespace
+	{
+		const int INDEX_VERSION = 1;
+
+		// outModificationTime in nanoseconds since 1970, a change within
+		// the same second (e.g. a file which is written twice) must be
+		// detected
+		bool getFileInfo(const std::string& filename, uint64_t& outSize,
+				int64_t& outModificationTime)
+		{
+#if defined(_WIN32)
+			// _stat64() has only seconds, the file time has 100 ns
+			WIN32_FILE_ATTRIBUTE_DATA data;
+			if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &data)) {
+				return false;
+			}
+			outSize = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+			uint64_t fileTime = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) |
+					data.ftLastWriteTime.dwLowDateTime;
+			// 100 ns intervals since 1601 --> nanoseconds since 1970
+			outModificationTime = (static_cast<int64_t>(fileTime) - 116444736000000000LL) * 100;
+#else
+			struct stat st;
+			if (stat(filename.c_str(), &st) != 0) {
+				return false;
+			}
+			outSize = static_cast<uint64_t>(st.st_size);
+#if defined(__APPLE__)
+			outModificationTime = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 +
+					static_cast<int64_t>(st.st_mtimespec.tv_nsec);
+#else
+			outModificationTime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+					static_cast<int64_t>(st.st_mtim.tv_nsec);
+#endif
+#endif
+			return true;
+		}
+
+		void addPair(Value& object, const char* name, Value&& value)
+		{
+			Value nameValue;
+			nameValue.setText(name);
+			object.mObject.emplace_back(std::move(nameValue), std::move(value));
+		}
+
+		Value getInteger64Value(int64_t number)
+		{
+			Value value;
+			value.setInteger64(number);
+			return value;
+		}
+
+		Value getIntegerValue(int number)
+		{
+			Value value;
+			value.setInteger(number);
+			return value;
+		}
+
+		bool getInteger64(const Value& object, const std::string& name, int64_t& outNumber)
+		{
+			const Value* value = object.objectGetValue(name);
+			if (!value) {
+				return false;
+			}
+			if (value->isInteger64()) {
+				outNumber = value->mInteger64;
+				return true;
+			}
+			if (value->isInteger()) {
+				outNumber = value->mInteger;
+				return true;
+			}
+			return false;
+		}
+	}
+}
+
+bool cfg::TmlIndex::build(const std::string& filename, std::string& outErrorMsg)
+{
+	clear();
+	mFilename = filename;
+	std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+	if (!getFileInfo(filename, mFileSize, mModificationTime) ||
+			!ifs.is_open() || ifs.fail()) {
+		outErrorMsg = "Can't open '" + filename + "'.";
+		return false;
+	}
+	// only the lines with a deep of 0 or 1 are parsed (without their
+	// indention) to get the names of the entries
+	TmlParser parser;
+	NameValuePair entry;
+	std::string line;
+	std::string content;
+	uint64_t offset = 0;
+	unsigned int lineNumber = 0;
+	int topLevelIndex = -1;
+	int childIndex = -1;
+	// the lines of a multiple line array are elements and no entries
+	bool isArrayParent = false;
+	while (std::getline(ifs, line)) {
+		++lineNumber;
+		uint64_t lineBegin = offset;
+		offset += line.size() + 1;
+		std::size_t len = line.size();
+		if (len > 0 && line[len - 1] == '\r') {
+			--len;
+		}
+		// the first indented line defines the indention (same as TmlParser)
+		if (!mIndentChar && len > 0 && (line[0] == ' ' || line[0] == '\t')) {
+			mIndentChar = line[0];
+			for (mIndentCharCount = 1; mIndentCharCount < len &&
+					line[mIndentCharCount] == mIndentChar; ++mIndentCharCount)
+				;
+		}
+		std::size_t indent = 0;
+		if (mIndentChar) {
+			for (; indent < len && line[indent] == mIndentChar; ++indent)
+				;
+		}
+		if (indent >= len || line[indent] == '#' || indent > mIndentCharCount ||
+				(indent && isArrayParent)) {
+			// empty line, comment, a deep greater than 1 or an array element
+			continue;
+		}
+		int deep = 0;
+		if (indent) {
+			if (indent != mIndentCharCount) {
+				outErrorMsg = filename + ":" + std::to_string(lineNumber) +
+						": Wrong indention. Is not a multiple of the indention count";
+				return false;
+			}
+			deep = 1;
+		}
+		content.assign(line, indent, std::string::npos);
+		if (parser.getNextTmlEntry(content, entry, static_cast<int>(lineNumber)) < 0) {
+			outErrorMsg = filename + ":" + std::to_string(lineNumber) + ": " +
+					parser.getErrorMsg();
+			return false;
+		}
+		if (childIndex >= 0) {
+			mEntries[childIndex].mEnd = lineBegin;
+			childIndex = -1;
+		}
+		if (deep == 0 && topLevelIndex >= 0) {
+			mEntries[topLevelIndex].mEnd = lineBegin;
+		}
+		else if (deep == 1 && topLevelIndex < 0) {
+			outErrorMsg = filename + ":" + std::to_string(lineNumber) +
+					": No parent entry exist.";
+			return false;
+		}
+		Entry indexEntry;
+		indexEntry.mName = entry.mName.isText() ? entry.mName.mText :
+				tmlstring::plainValueToString(entry.mName);
+		indexEntry.mDeep = deep;
+		indexEntry.mParentIndex = deep ? topLevelIndex : -1;
+		indexEntry.mLineNumber = lineNumber;
+		indexEntry.mBegin = lineBegin;
+		int index = static_cast<int>(mEntries.size());
+		mEntries.push_back(std::move(indexEntry));
+		if (deep == 0) {
+			topLevelIndex = index;
+			isArrayParent = entry.mValue.isArray();
+		}
+		else {
+			childIndex = index;
+		}
+	}
+	if (ifs.bad()) {
+		outErrorMsg = "Can't read '" + filename + "'.";
+		return false;
+	}
+	// the last line can be without a line break
+	uint64_t end = std::min(offset, mFileSize);
+	if (childIndex >= 0) {
+		mEntries[childIndex].mEnd = end;
+	}
+	if (topLevelIndex >= 0) {
+		mEntries[topLevelIndex].mEnd = end;
+	}
+	return true;
+}
+
+bool cfg::TmlIndex::save(const std::string& indexFilename, std::string& outErrorMsg) const
+{
+	Value root;
+	root.setObject();
+	addPair(root, "tml-index", getIntegerValue(INDEX_VERSION));
+	Value filename;
+	filename.setText(mFilename);
+	addPair(root, "filename", std::move(filename));
+	addPair(root, "file-size", getInteger64Value(static_cast<int64_t>(mFileSize)));
+	addPair(root, "modification-time-ns", getInteger64Value(mModificationTime));
+	addPair(root, "indent-char", getIntegerValue(mIndentChar));
+	addPair(root, "indent-char-count", getIntegerValue(static_cast<int>(mIndentCharCount)));
+	Value entries;
+	entries.setArray();
+	entries.mArray.reserve(mEntries.size());
+	for (const Entry& entry : mEntries) {
+		// name deep parent-index line-number begin end
+		Value values;
+		values.setArray();
+		values.mArray.resize(6);
+		values.mArray[0].setText(entry.mName);
+		values.mArray[1].setInteger(entry.mDeep);
+		values.mArray[2].setInteger(entry.mParentIndex);
+		values.mArray[3].setInteger64(entry.mLineNumber);
+		values.mArray[4].setInteger64(static_cast<int64_t>(entry.mBegin));
+		values.mArray[5].setInteger64(static_cast<int64_t>(entry.mEnd));
+		entries.mArray.push_back(std::move(values));
+	}
+	addPair(root, "entries", std::move(entries));
+
+	std::vector<uint8_t> data;
+	if (!btmlstream::valueToStreamWithHeader(root, data, true)) {
+		outErrorMsg = "Can't convert the index to btml.";
+		return false;
+	}
+	std::ofstream ofs(indexFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+	ofs.write(reinterpret_cast<const char*>(data.data()),
+			static_cast<std::streamsize>(data.size()));
+	if (!ofs.is_open() || ofs.fail()) {
+		outErrorMsg = "Can't write '" + indexFilename + "'.";
+		return false;
+	}
+	return true;
+}
+
+bool cfg::TmlIndex::load(const std::string& indexFilename, std::string& outErrorMsg)
+{
+	clear();
+	BtmlParser parser;
+	Value root;
+	if (!parser.setFilename(indexFilename) || !parser.getAsTree(root, false, false)) {
+		outErrorMsg = parser.getExtendedErrorMsg();
+		return false;
+	}
+	int64_t version = 0;
+	int64_t fileSize = 0;
+	int64_t indentChar = 0;
+	int64_t indentCharCount = 0;
+	const Value* entries = root.objectGetValue("entries");
+	if (!getInteger64(root, "tml-index", version) || version != INDEX_VERSION ||
+			!root.objectGetText("filename", mFilename) ||
+			!getInteger64(root, "file-size", fileSize) ||
+			!getInteger64(root, "modification-time-ns", mModificationTime) ||
+			!getInteger64(root, "indent-char", indentChar) ||
+			!getInteger64(root, "indent-char-count", indentCharCount) ||
+			!entries || !entries->isArray()) {
+		clear();
+		outErrorMsg = indexFilename + ": is no tml index (version " +
+				std::to_string(INDEX_VERSION) + ").";
+		return false;
+	}
+	mFileSize = static_cast<uint64_t>(fileSize);
+	mIndentChar = static_cast<char>(indentChar);
+	mIndentCharCount = static_cast<unsigned int>(indentCharCount);
+	mEntries.resize(entries->mArray.size());
+	for (std::size_t i = 0; i < mEntries.size(); ++i) {
+		const Value& values = entries->mArray[i];
+		if (!values.isArray() || values.mArray.size() != 6 ||
+				!values.mArray[0].isText() || !values.mArray[1].isInteger() ||
+				!values.mArray[2].isInteger() || !values.mArray[3].isInteger64() ||
+				!values.mArray[4].isInteger64() || !values.mArray[5].isInteger64()) {
+			clear();
+			outErrorMsg = indexFilename + ": wrong entry " + std::to_string(i) + ".";
+			return false;
+		}
+		Entry& entry = mEntries[i];
+		entry.mName = values.mArray[0].mText;
+		entry.mDeep = values.mArray[1].mInteger;
+		entry.mParentIndex = values.mArray[2].mInteger;
+		entry.mLineNumber = static_cast<unsigned int>(values.mArray[3].getInteger64());
+		entry.mBegin = static_cast<uint64_t>(values.mArray[4].getInteger64());
+		entry.mEnd = static_cast<uint64_t>(values.mArray[5].getInteger64());
+	}
+	return true;
+}
+
+bool cfg::TmlIndex::loadOrBuild(const std::string& filename, std::string& outErrorMsg)
+{
+	std::string indexFilename = getIndexFilename(filename);
+	std::string loadErrorMsg;
+	if (load(indexFilename, loadErrorMsg) && mFilename == filename && isUpToDate()) {
+		return true;
+	}
+	return build(filename, outErrorMsg) && save(indexFilename, outErrorMsg);
+}
+
+bool cfg::TmlIndex::isUpToDate() const
+{
+	uint64_t size = 0;
+	int64_t modificationTime = 0;
+	return !mFilename.empty() && getFileInfo(mFilename, size, modificationTime) &&
+			size == mFileSize && modificationTime == mModificationTime;
+}
+
+void cfg::TmlIndex::clear()
+{
+	mFilename.clear();
+	mFileSize = 0;
+	mModificationTime = 0;
+	mIndentChar = 0;
+	mIndentCharCount = 1;
+	mEntries.clear();
+}
+
+int cfg::TmlIndex::find(const std::string& name) const
+{
+	for (std::size_t i = 0; i < mEntries.size(); ++i) {
+		if (mEntries[i].mDeep == 0 && mEntries[i].mName == name) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+int cfg::TmlIndex::find(const std::string& parentName, const std::string& name) const
+{
+	int parentIndex = find(parentName);
+	if (parentIndex < 0) {
+		return -1;
+	}
+	// the children follow their parent
+	for (std::size_t i = static_cast<std::size_t>(parentIndex) + 1; i < mEntries.size() &&
+			mEntries[i].mDeep == 1; ++i) {
+		if (mEntries[i].mName == name) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+std::string cfg::TmlIndex::getIndexFilename(const std::string& filename)
+{
+	return filename + ".idx";
+}
@@ -1,7 +1,13 @@
 #include <tml/tml_parser.h>
+#include <tml/tml_index.h>
 #include <cfg/cfg.h>
+#include <cfg/cfg_number.h>
+#include <cfg/cfg_schema_validator.h>
 #include <string.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <iterator>
+#include <thread>
 //#include <iostream>
 
 namespace cfg
@@ -100,14 +106,16 @@ namespace cfg
 
 		/**
 		 * Only empty and comment are supported!
+		 * tmp is only a buffer (is empty after the call) which can be reused.
 		 */
-		void moveFromChildToParent(Value& child, Value& parent, std::size_t moveIndex)
+		void moveFromChildToParent(Value& child, Value& parent, std::size_t moveIndex,
+				std::vector<Value>& tmp)
 		{
 			if (!parent.isObject() && !parent.isArray()) {
 				return;
 			}
 
-			std::vector<Value> tmp;
+			tmp.clear();
 			if (child.isObject()) {
 				std::vector<NameValuePair>& obj = child.mObject;
 				std::size_t size = obj.size();
@@ -141,7 +149,7 @@ namespace cfg
 					NameValuePair nvp;
 					nvp.mDeep = val.mNvpDeep;
 					nvp.mName = std::move(val);
-					obj.push_back(nvp);
+					obj.push_back(std::move(nvp));
 				}
 			}
 			else if (parent.isArray()) {
@@ -150,6 +158,212 @@ namespace cfg
 					array.push_back(std::move(val));
 				}
 			}
+			tmp.clear();
+		}
+
+		/**
+		 * Count of indention characters which define one deep.
+		 * line[0] must be the indention character.
+		 * Only the first indented line of a file defines it.
+		 */
+		unsigned int getIndentCharCount(const char* line, std::size_t len)
+		{
+			unsigned int count = 1;
+			for (; count < len && line[count] == line[0]; ++count)
+				;
+			return count;
+		}
+
+		/**
+		 * The rules for the names and the parents are shared by getAsTree()
+		 * and validateStream(). They return the error message or nullptr.
+		 */
+		const char* getPairNameError(const Value& name)
+		{
+			if (name.isArray() && name.mArray.empty()) {
+				return "An empty array as name of a name-value-pair is not allowed.";
+			}
+			if (name.isObject() && name.mObject.empty()) {
+				return "An empty object as name of a name-value-pair is not allowed.";
+			}
+			return nullptr;
+		}
+
+		// outIsArrayParent is set to true for a parent with = [] (array with multiple lines)
+		const char* getObjectParentError(const NameValuePair& parent, bool& outIsArrayParent)
+		{
+			outIsArrayParent = false;
+			if (parent.mName.isEmpty()) {
+				return "The name of the parent is empty.";
+			}
+			if (parent.mName.isComment()) {
+				return "The name of the parent is a comment which is not allowed.";
+			}
+			if (parent.mName.isArray() && parent.mName.mArray.empty()) {
+				return "The name of the parent is an empty array which is not allowed.";
+			}
+			if (parent.mName.isObject() && parent.mName.mObject.empty()) {
+				return "The name of the parent is an empty object which is not allowed.";
+			}
+			if (parent.mValue.isArray()) {
+				if (parent.mValue.arraySize()) {
+					return "The value of the parent is a non empty array. Only = [] is allowed for an array with multiple lines.";
+				}
+				outIsArrayParent = true;
+			}
+			else if (!parent.mValue.isEmpty()) {
+				return "The value of the parent is not empty (no = is allowed at parent, excepted = []).";
+			}
+			return nullptr;
+		}
+
+		// only an empty object or an empty array can be the parent inside an array
+		const char* getArrayParentError(const Value& parent, bool& outIsArrayParent)
+		{
+			outIsArrayParent = false;
+			if (parent.isEmpty()) {
+				return "Parent is empty.";
+			}
+			if (parent.isComment()) {
+				return "The parent is a comment which is not allowed.";
+			}
+			if (parent.isArray()) {
+				if (parent.arraySize()) {
+					return "The parent must be an empty array with [].";
+				}
+				outIsArrayParent = true;
+			}
+			else if (parent.isObject()) {
+				if (!parent.mObject.empty()) {
+					return "The parent must be an empty object with {}.";
+				}
+			}
+			else {
+				return "The parent must be use [] or {} to add a child to an array.";
+			}
+			return nullptr;
+		}
+
+		/**
+		 * A chunk for parallel parsing can start with this character.
+		 * Then the line has a deep of 0 and it isn't an empty line and
+		 * not a comment. The comments and empty lines in front of such a
+		 * line are never moved into the entry of this line.
+		 */
+		bool isChunkStartChar(char ch)
+		{
+			return ch != ' ' && ch != '\t' && ch != '#' && ch != '\r' && ch != '\n';
+		}
+
+		/**
+		 * Count the lines of a chunk and find the first indented line
+		 * (nullptr if no line is indented).
+		 */
+		void scanChunk(const char* begin, const char* end,
+				std::size_t& outLineCount, const char*& outFirstIndentedLine)
+		{
+			outLineCount = 0;
+			outFirstIndentedLine = nullptr;
+			const char* line = begin;
+			while (line < end) {
+				if (!outFirstIndentedLine && (*line == ' ' || *line == '\t')) {
+					outFirstIndentedLine = line;
+				}
+				const char* lineEnd = static_cast<const char*>(
+						memchr(line, '\n', end - line));
+				if (!lineEnd) {
+					break;
+				}
+				++outLineCount;
+				line = lineEnd + 1;
+			}
+		}
+
+		/**
+		 * Read only stream buffer for an existing memory area (no copy).
+		 */
+		class MemoryStreamBuf: public std::streambuf
+		{
+		public:
+			MemoryStreamBuf(const char* begin, const char* end)
+			{
+				setg(const_cast<char*>(begin), const_cast<char*>(begin),
+						const_cast<char*>(end));
+			}
+		protected:
+			virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+					std::ios_base::openmode which) override
+			{
+				if (!(which & std::ios_base::in)) {
+					return pos_type(off_type(-1));
+				}
+				off_type pos = off;
+				if (dir == std::ios_base::cur) {
+					pos += gptr() - eback();
+				}
+				else if (dir == std::ios_base::end) {
+					pos += egptr() - eback();
+				}
+				if (pos < 0 || pos > egptr() - eback()) {
+					return pos_type(off_type(-1));
+				}
+				setg(eback(), eback() + pos, egptr());
+				return pos_type(pos);
+			}
+			virtual pos_type seekpos(pos_type pos,
+					std::ios_base::openmode which) override
+			{
+				return seekoff(off_type(pos), std::ios_base::beg, which);
+			}
+		};
+
+		/**
+		 * Call func(chunkIndex) for each chunk. Chunk 0 is processed by the
+		 * calling thread, all others by an own thread.
+		 */
+		template<typename Func>
+		void forEachChunkParallel(std::size_t chunkCount, const Func& func)
+		{
+			std::vector<std::thread> threads;
+			threads.reserve(chunkCount);
+			for (std::size_t i = 1; i < chunkCount; ++i) {
+				threads.emplace_back(func, i);
+			}
+			func(0);
+			for (std::thread& t : threads) {
+				t.join();
+			}
+		}
+
+		void addIndention(Value& value, int deep, int offset);
+
+		/**
+		 * Add deep and offset to the positions of the pair and its children
+		 * (for an entry which is parsed without its indention).
+		 */
+		void addIndention(NameValuePair& pair, int deep, int offset)
+		{
+			if (pair.mDeep >= 0) {
+				pair.mDeep += deep;
+			}
+			addIndention(pair.mName, deep, offset);
+			addIndention(pair.mValue, deep, offset);
+		}
+
+		void addIndention(Value& value, int deep, int offset)
+		{
+			if (value.mOffset >= 0) {
+				value.mOffset += offset;
+			}
+			if (value.mNvpDeep >= 0) {
+				value.mNvpDeep += deep;
+			}
+			for (Value& element : value.mArray) {
+				addIndention(element, deep, offset);
+			}
+			for (NameValuePair& pair : value.mObject) {
+				addIndention(pair, deep, offset);
+			}
 		}
 	}
 }
@@ -158,7 +372,8 @@ cfg::TmlParser::TmlParser()
 		mInStream(&mIss), mLine(), mErrorCode(0), mErrorMsg(),
 		mLineNumber(0),
 		mIndentChar(0),
-		mIndentCharCount(1)
+		mIndentCharCount(1),
+		mLineNumberOffset(0)
 {
 }
 
@@ -183,12 +398,23 @@ void cfg::TmlParser::reset()
 	mIss.str(std::string());
 	mIfs.clear();
 	mIss.clear();
+	// clear() keeps the capacity of the buffers for the next file
 	mLine.clear();
+	mStack.clear();
+	mMoveBuffer.clear();
+	mEntryLines.clear();
+	mNextEntryLine.clear();
+	mHasNextEntryLine = false;
+	mEntriesEnd = false;
+	mEntries.clear();
+	mEntryIndex = 0;
+	mFeedEntries.clear();
 	mErrorCode = 0;
 	mErrorMsg.clear();
 	mLineNumber = 0;
 	mIndentChar = 0;
 	mIndentCharCount = 1;
+	mLineNumberOffset = 0;
 }
 
 bool cfg::TmlParser::setFilename(const std::string& filename)
@@ -225,9 +451,19 @@ bool cfg::TmlParser::setCustomStream(const std::string& pseudoFilename,
 	return true;
 }
 
+const std::shared_ptr<const std::string>& cfg::TmlParser::getFilenamePtr()
+{
+	// All values of a tree share the same filename. The pointer is reused
+	// as long as the filename doesn't change (e.g. same file parsed again).
+	if (!mFilenamePtr || *mFilenamePtr != mFilename) {
+		mFilenamePtr = std::make_shared<const std::string>(mFilename);
+	}
+	return mFilenamePtr;
+}
+
 bool cfg::TmlParser::begin()
 {
-	mLineNumber = 0;
+	mLineNumber = mLineNumberOffset;
 
 	switch (mSource) {
 		case Source::NONE:
@@ -256,6 +492,10 @@ bool cfg::TmlParser::begin()
 		case Source::STRING_STREAM:
 			mIss.str(mStrBuffer);
 			return true;
+		case Source::FEED:
+			mErrorMsg = "Source is FEED. Use feed() and finish().";
+			mErrorCode = -1;
+			return false;
 		case Source::CUSTOM_STREAM:
 			if (!mInStream) {
 				mErrorMsg = "Null pointer. Can't seek to the beginning.";
@@ -274,12 +514,26 @@ int cfg::TmlParser::getNextTmlEntry(NameValuePair& entry)
 }
 
 int cfg::TmlParser::getNextTmlEntry(NameValuePair& entry, std::string* outLine, int* outLineNumber)
+{
+	if (!readLine()) {
+		return -2;
+	}
+	if (outLine) {
+		*outLine = mLine;
+	}
+	if (outLineNumber) {
+		*outLineNumber = mLineNumber;
+	}
+	return getNextTmlEntry(mLine, entry, mLineNumber);
+}
+
+bool cfg::TmlParser::readLine()
 {
 	if (mSource == Source::FILE) {
 		// --> file is used
 		if (!mIfs.is_open()) {
 			mErrorCode = -3;
-			return -2;
+			return false;
 		}
 	}
 	getline(*mInStream, mLine);
@@ -289,20 +543,36 @@ int cfg::TmlParser::getNextTmlEntry(NameValuePair& entry, std::string* outLine,
 		// has no line break at the end then eof() is already true, but
 		// the line should not be discard --> no error and no return.
 		//mErrorCode = -3; // would be wrong here
-		//return -2; // would be wrong here
+		//return false; // would be wrong here
 	}
 	if (mInStream->fail()) {
 		mErrorCode = -3;
-		return -2;
+		return false;
 	}
 	++mLineNumber;
-	if (outLine) {
-		*outLine = mLine;
-	}
-	if (outLineNumber) {
-		*outLineNumber = mLineNumber;
+	return true;
+}
+
+int cfg::TmlParser::getNextProjectedTmlEntry(NameValuePair& entry)
+{
+	int deep = getNextTmlEntry(entry);
+	while (deep == 0 && !mProjection.empty() && !entry.isEmptyOrComment() &&
+			!(entry.mName.isText() && mProjection.count(entry.mName.mText))) {
+		// Skip the children of the entry (and the following empty lines
+		// and comments) without parsing them. Only the first character
+		// of a line is needed to find the next top level entry.
+		do {
+			if (!readLine()) {
+				return -2;
+			}
+			if (!mIndentChar && !mLine.empty() && (mLine[0] == ' ' || mLine[0] == '\t')) {
+				mIndentChar = mLine[0];
+				mIndentCharCount = getIndentCharCount(mLine.c_str(), mLine.length());
+			}
+		} while (mLine.empty() || !isChunkStartChar(mLine[0]));
+		deep = getNextTmlEntry(mLine, entry, mLineNumber);
 	}
-	return getNextTmlEntry(mLine, entry, mLineNumber);
+	return deep;
 }
 
 int cfg::TmlParser::getNextTmlEntry(std::string& utf8Line, NameValuePair& entry,
@@ -327,9 +597,7 @@ int cfg::TmlParser::getNextTmlEntry(std::string& utf8Line, NameValuePair& entry,
 
 	if (!mIndentChar && len > 0 && (utf8Line[0] == ' ' || utf8Line[0] == '\t')) {
 		mIndentChar = utf8Line[0];
-		// mIndentCharCount already has the value 1 from init
-		for (; mIndentCharCount < len && utf8Line[mIndentCharCount] == mIndentChar; ++mIndentCharCount)
-			;
+		mIndentCharCount = getIndentCharCount(utf8Line.c_str(), len);
 	}
 	unsigned int deep = 0;
 	unsigned int i = 0;
@@ -502,11 +770,12 @@ int cfg::TmlParser::getNextTmlEntry(std::string& utf8Line, NameValuePair& entry,
 				mErrorMsg = "{} is not allowed in a single line array.";
 				return -1;
 			}
-			Value cv = *value;
+			Value cv = std::move(*value);
 			value->setArray();
+			value->mFilename = cv.mFilename;
 			value->mLineNumber = cv.mLineNumber;
 			value->mOffset = cv.mOffset;
-			value->mArray.push_back(cv);
+			value->mArray.push_back(std::move(cv));
 		}
 		if (wordCountPerValue >= 2) {
 			array->mArray.push_back(Value());
@@ -523,13 +792,9 @@ int cfg::TmlParser::getNextTmlEntry(std::string& utf8Line, NameValuePair& entry,
 			value->setText(word, true);
 			//value->setText(word, word + wordLen, true);
 		}
-		else if (isNumber && digitCount && dotCount == 0) {
-			//std::cout << "type: int" << std::endl;
-			value->setInteger(atoi(word), 10);
-		}
-		else if (isNumber && digitCount && dotCount == 1) {
-			//std::cout << "type: float" << std::endl;
-			value->setFloatingPoint(static_cast<float>(atof(word)));
+		else if (isNumber && digitCount && dotCount <= 1 &&
+				number::parseNumber(word, utf8Line.c_str() + i, false, *value)) {
+			//std::cout << "type: int or float" << std::endl;
 		}
 		else if (!strcmp(word, "true")) {
 			//std::cout << "type: bool" << std::endl;
@@ -608,14 +873,17 @@ bool cfg::TmlParser::getAsTree(Value &root,
 		root.clear();
 		return false;
 	}
-	std::shared_ptr<const std::string> filenamePtr = std::make_shared<const std::string>(mFilename);
+	const std::shared_ptr<const std::string>& filenamePtr = getFilenamePtr();
 
 	NameValuePair cfgPair;
 	cfgPair.mName.mFilename = filenamePtr;
 	cfgPair.mValue.mFilename = filenamePtr;
-	std::vector<Value*> stack;
-	stack.reserve(10);
+	// the buffers are members to keep their capacity for the next file
+	std::vector<Value*>& stack = mStack;
+	stack.clear();
+	std::vector<Value>& tmp = mMoveBuffer;
 	root.setObject();
+	root.mFilename = filenamePtr;
 	root.mLineNumber = 1;
 	root.mOffset = 0;
 	stack.push_back(&root);
@@ -640,7 +908,7 @@ bool cfg::TmlParser::getAsTree(Value &root,
 	 * and empty line must be included into the root object between entry2
 	 * and entry3.
 	 * For this there is a extra logic which moves the comments and empty lines
-	 * to the correct object (or array). For this std::vector<Value> tmp; is used.
+	 * to the correct object (or array). For this the buffer tmp is used.
 	 */
 	std::size_t currentContiguousEmptyOrCommentCount = 0;
 
@@ -649,7 +917,7 @@ bool cfg::TmlParser::getAsTree(Value &root,
 	 * into an object or
 	 * into a multiple line array (In this case the value of the name-value-pair must be empty).
 	 */
-	while ((deep = getNextTmlEntry(cfgPair)) >= 0) {
+	while ((deep = getNextProjectedTmlEntry(cfgPair)) >= 0) {
 
 		if (!cfgPair.isEmptyOrComment()) {
 			if (deep > prevDeep) {
@@ -672,7 +940,7 @@ bool cfg::TmlParser::getAsTree(Value &root,
 					return false;
 				}
 
-				std::vector<Value> tmp;
+				tmp.clear();
 				int lineNumber = mLineNumber;
 				bool childIsArrayEntry = false;
 
@@ -687,16 +955,15 @@ bool cfg::TmlParser::getAsTree(Value &root,
 							return false;
 						}
 
-						tmp.reserve(currentContiguousEmptyOrCommentCount);
 						std::size_t startIndex = obj.size() -
 								currentContiguousEmptyOrCommentCount;
-						for (std::size_t i = 0;
-								i < currentContiguousEmptyOrCommentCount; ++i) {
-							tmp.push_back(obj[startIndex + i].mName);
-						}
 						if (obj[startIndex].mName.mLineNumber >= 0) {
 							lineNumber = obj[startIndex].mName.mLineNumber;
 						}
+						for (std::size_t i = 0;
+								i < currentContiguousEmptyOrCommentCount; ++i) {
+							tmp.push_back(std::move(obj[startIndex + i].mName));
+						}
 						obj.resize(startIndex); // truncate --> drop the moved entries
 					}
 
@@ -707,45 +974,17 @@ bool cfg::TmlParser::getAsTree(Value &root,
 						return false;
 					}
 
-					if (stack.back()->mObject.back().mName.isEmpty()) {
-						mErrorMsg = "The name of the parent is empty.";
-						root.clear();
-						return false;
-					}
-					if (stack.back()->mObject.back().mName.isComment()) {
-						mErrorMsg = "The name of the parent is a comment which is not allowed.";
-						root.clear();
-						return false;
-					}
-					if (stack.back()->mObject.back().mName.isArray() &&
-							stack.back()->mObject.back().mName.mArray.empty()) {
-						mErrorMsg = "The name of the parent is an empty array which is not allowed.";
+					const char* error = getObjectParentError(stack.back()->mObject.back(),
+							childIsArrayEntry);
+					if (error) {
+						mErrorMsg = error;
 						root.clear();
 						return false;
 					}
-					if (stack.back()->mObject.back().mName.isObject() &&
-							stack.back()->mObject.back().mName.mObject.empty()) {
-						mErrorMsg = "The name of the parent is an empty object which is not allowed.";
-						root.clear();
-						return false;
-					}
-
-					if (stack.back()->mObject.back().mValue.isArray()) {
-						if (!stack.back()->mObject.back().mValue.mArray.empty()) {
-							mErrorMsg = "The value of the parent is a non empty array. Only = [] is allowed for an array with multiple lines.";
-							root.clear();
-							return false;
-						}
+					if (childIsArrayEntry) {
 						// --> an empty array --> array with multiple lines
-						childIsArrayEntry = true;
 						stack.back()->mObject.back().mValue.clear();
 					}
-					else if (!stack.back()->mObject.back().mValue.isEmpty()) {
-						// --> not an empty array but also not empty --> not allowed
-						mErrorMsg = "The value of the parent is not empty (no = is allowed at parent, excepted = []).";
-						root.clear();
-						return false;
-					}
 
 					stack.push_back(&stack.back()->mObject.back().mValue);
 				}
@@ -760,16 +999,15 @@ bool cfg::TmlParser::getAsTree(Value &root,
 							return false;
 						}
 
-						tmp.reserve(currentContiguousEmptyOrCommentCount);
 						std::size_t startIndex = array.size() -
 								currentContiguousEmptyOrCommentCount;
-						for (unsigned int i = 0;
-								i < currentContiguousEmptyOrCommentCount; ++i) {
-							tmp.push_back(array[startIndex + i]);
-						}
 						if (array[startIndex].mLineNumber >= 0) {
 							lineNumber = array[startIndex].mLineNumber;
 						}
+						for (unsigned int i = 0;
+								i < currentContiguousEmptyOrCommentCount; ++i) {
+							tmp.push_back(std::move(array[startIndex + i]));
+						}
 						array.resize(startIndex); // truncate --> drop the moved entries
 					}
 
@@ -780,35 +1018,10 @@ bool cfg::TmlParser::getAsTree(Value &root,
 						return false;
 					}
 
-					if (stack.back()->mArray.back().isEmpty()) {
-						mErrorMsg = "Parent is empty.";
-						root.clear();
-						return false;
-					}
-					if (stack.back()->mArray.back().isComment()) {
-						mErrorMsg = "The parent is a comment which is not allowed.";
-						root.clear();
-						return false;
-					}
-
-					// only an empty object or an empty array as child is here allowed!
-					if (stack.back()->mArray.back().isArray()) {
-						if (!stack.back()->mArray.back().mArray.empty()) {
-							mErrorMsg = "The parent must be an empty array with [].";
-							root.clear();
-							return false;
-						}
-						childIsArrayEntry = true;
-					}
-					else if (stack.back()->mArray.back().isObject()) {
-						if (!stack.back()->mArray.back().mObject.empty()) {
-							mErrorMsg = "The parent must be an empty object with {}.";
-							root.clear();
-							return false;
-						}
-					}
-					else {
-						mErrorMsg = "The parent must be use [] or {} to add a child to an array.";
+					const char* error = getArrayParentError(stack.back()->mArray.back(),
+							childIsArrayEntry);
+					if (error) {
+						mErrorMsg = error;
 						root.clear();
 						return false;
 					}
@@ -834,7 +1047,11 @@ bool cfg::TmlParser::getAsTree(Value &root,
 					// copy is no problem because the new object is empty
 					//std::cout << "move tmp with " << tmp.size() << " entries." << std::endl; // only for info
 					if (childIsArrayEntry) {
-						stack.back()->mArray = std::move(tmp);
+						std::vector<Value>& array = stack.back()->mArray;
+						array.reserve(tmp.size());
+						for (Value& val : tmp) {
+							array.push_back(std::move(val));
+						}
 					}
 					else {
 						std::size_t tmpSize = tmp.size();
@@ -843,9 +1060,10 @@ bool cfg::TmlParser::getAsTree(Value &root,
 							nvp.mName = std::move(tmp[i]);
 							nvp.mDeep = nvp.mName.mNvpDeep;
 							nvp.mValue.mNvpDeep = nvp.mName.mNvpDeep;
-							stack.back()->mObject.emplace_back(nvp);
+							stack.back()->mObject.push_back(std::move(nvp));
 						}
 					}
+					tmp.clear();
 				}
 				prevDeep = deep;
 			}
@@ -856,7 +1074,11 @@ bool cfg::TmlParser::getAsTree(Value &root,
 					std::size_t moveIndex = getMoveIndexForEmptyAndComment(*stack.back(), curDeep);
 					Value* child = stack.back();
 					stack.pop_back();
-					moveFromChildToParent(*child, *stack.back(), moveIndex);
+					moveFromChildToParent(*child, *stack.back(), moveIndex, tmp);
+					if (mPackNumericArrays) {
+						// a multiple line array is complete
+						child->packArray();
+					}
 				}
 				prevDeep = deep;
 			}
@@ -873,18 +1095,21 @@ bool cfg::TmlParser::getAsTree(Value &root,
 			}
 
 			if (stack.back()->isObject()) {
-				if (cfgPair.mName.isArray() && cfgPair.mName.mArray.empty()) {
-					mErrorMsg = "An empty array as name of a name-value-pair is not allowed.";
-					root.clear();
-					return false;
-				}
-				if (cfgPair.mName.isObject() && cfgPair.mName.mObject.empty()) {
-					mErrorMsg = "An empty object as name of a name-value-pair is not allowed.";
+				const char* error = getPairNameError(cfgPair.mName);
+				if (error) {
+					mErrorMsg = error;
 					root.clear();
 					return false;
 				}
 
-				stack.back()->mObject.push_back(cfgPair);
+				if (mPackNumericArrays) {
+					// a single line array is complete
+					cfgPair.mValue.packArray();
+				}
+				stack.back()->mObject.push_back(std::move(cfgPair));
+				// the moved pair is reused for the next entry
+				cfgPair.mName.mFilename = filenamePtr;
+				cfgPair.mValue.mFilename = filenamePtr;
 			}
 			else if (stack.back()->isArray()) {
 				if (!cfgPair.mValue.isEmpty()) {
@@ -892,7 +1117,11 @@ bool cfg::TmlParser::getAsTree(Value &root,
 					root.clear();
 					return false;
 				}
-				stack.back()->mArray.push_back(cfgPair.mName);
+				if (mPackNumericArrays) {
+					cfgPair.mName.packArray();
+				}
+				stack.back()->mArray.push_back(std::move(cfgPair.mName));
+				cfgPair.mName.mFilename = filenamePtr;
 			}
 			else {
 				mErrorMsg = "The parent must be an object or an array.";
@@ -914,14 +1143,622 @@ bool cfg::TmlParser::getAsTree(Value &root,
 		std::size_t moveIndex = getMoveIndexForEmptyAndComment(*stack.back(), prevDeep);
 		Value* child = stack.back();
 		stack.pop_back();
-		moveFromChildToParent(*child, *stack.back(), moveIndex);
+		moveFromChildToParent(*child, *stack.back(), moveIndex, tmp);
+		if (mPackNumericArrays) {
+			child->packArray();
+		}
 		--prevDeep;
 	}
 	//std::cout << "prev deep: after " << prevDeep << std::endl;
+	// the pointers into root must not survive
+	stack.clear();
 	// deep should be -2 for end of file and not -1 which is a error
 	return true;
 }
 
+bool cfg::TmlParser::getAsTreeParallel(Value& root,
+		bool inclEmptyLines, bool inclComments, unsigned int threadCount)
+{
+	root.clear();
+	if (mSource != Source::FILE && mSource != Source::STRING_STREAM) {
+		return getAsTree(root, inclEmptyLines, inclComments);
+	}
+	std::string fileContent;
+	if (mSource == Source::FILE) {
+		mLineNumber = 0;
+		std::ifstream ifs(mFilename.c_str(), std::ifstream::in | std::ifstream::binary);
+		if (ifs.is_open()) {
+			ifs.seekg(0, std::ifstream::end);
+			std::streamoff size = ifs.tellg();
+			ifs.seekg(0, std::ifstream::beg);
+			if (size > 0) {
+				fileContent.resize(static_cast<std::size_t>(size));
+				ifs.read(&fileContent[0], size);
+			}
+		}
+		if (!ifs.is_open() || ifs.fail()) {
+			mErrorMsg = "Can't open file.";
+			mErrorCode = -2;
+			return false;
+		}
+	}
+	const std::string& buffer = (mSource == Source::FILE) ? fileContent : mStrBuffer;
+
+	// Split the buffer into chunks at lines with a deep of 0
+	// (see isChunkStartChar()). Small chunks aren't worth a thread.
+	const std::size_t minChunkSize = 64 * 1024;
+	if (threadCount == 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	std::size_t maxChunkCount = std::max<std::size_t>(1,
+			std::min<std::size_t>(threadCount, buffer.size() / minChunkSize));
+	std::vector<std::size_t> chunkStarts;
+	chunkStarts.reserve(maxChunkCount + 1);
+	chunkStarts.push_back(0);
+	for (std::size_t i = 1; i < maxChunkCount; ++i) {
+		std::size_t pos = std::max(chunkStarts.back(), i * (buffer.size() / maxChunkCount));
+		while (pos < buffer.size()) {
+			pos = buffer.find('\n', pos);
+			if (pos == std::string::npos) {
+				pos = buffer.size();
+				break;
+			}
+			++pos; // begin of next line
+			if (pos < buffer.size() && isChunkStartChar(buffer[pos])) {
+				break;
+			}
+		}
+		if (pos >= buffer.size()) {
+			break;
+		}
+		chunkStarts.push_back(pos);
+	}
+	std::size_t chunkCount = chunkStarts.size();
+	chunkStarts.push_back(buffer.size());
+	const char* data = buffer.data();
+
+	// first pass: line numbers and indention are defined by the previous chunks
+	std::vector<std::size_t> lineCounts(chunkCount, 0);
+	std::vector<const char*> firstIndentedLines(chunkCount, nullptr);
+	forEachChunkParallel(chunkCount, [&](std::size_t i) {
+		scanChunk(data + chunkStarts[i], data + chunkStarts[i + 1],
+				lineCounts[i], firstIndentedLines[i]);
+	});
+	char indentChar = 0;
+	unsigned int indentCharCount = 1;
+	for (const char* line : firstIndentedLines) {
+		if (line) {
+			const char* end = data + buffer.size();
+			const char* lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+			std::size_t len = (lineEnd ? lineEnd : end) - line;
+			if (len > 0 && line[len - 1] == '\r') {
+				--len;
+			}
+			indentChar = line[0];
+			indentCharCount = getIndentCharCount(line, len);
+			break;
+		}
+	}
+
+	// second pass: parse each chunk with an own parser
+	const std::shared_ptr<const std::string>& filenamePtr = getFilenamePtr();
+	std::vector<std::unique_ptr<TmlParser>> parsers(chunkCount);
+	std::vector<Value> chunkRoots(chunkCount);
+	std::vector<char> chunkSuccess(chunkCount, 0); // no vector<bool> (threads)
+	std::size_t lineNumberOffset = 0;
+	for (std::size_t i = 0; i < chunkCount; ++i) {
+		parsers[i].reset(new TmlParser());
+		TmlParser& p = *parsers[i];
+		p.mSource = Source::CUSTOM_STREAM;
+		p.mFilename = mFilename;
+		p.mFilenamePtr = filenamePtr;
+		p.mIndentChar = indentChar;
+		p.mIndentCharCount = indentCharCount;
+		p.mProjection = mProjection;
+		p.mPackNumericArrays = mPackNumericArrays;
+		p.mLineNumberOffset = static_cast<unsigned int>(lineNumberOffset);
+		lineNumberOffset += lineCounts[i];
+	}
+	forEachChunkParallel(chunkCount, [&](std::size_t i) {
+		MemoryStreamBuf streamBuf(data + chunkStarts[i], data + chunkStarts[i + 1]);
+		std::istream is(&streamBuf);
+		TmlParser& p = *parsers[i];
+		p.mInStream = &is;
+		chunkSuccess[i] = p.getAsTree(chunkRoots[i], inclEmptyLines, inclComments);
+		p.mInStream = nullptr;
+	});
+
+	for (std::size_t i = 0; i < chunkCount; ++i) {
+		if (!chunkSuccess[i] || i + 1 == chunkCount) {
+			// same state as after getAsTree() (first error or end of file)
+			mErrorCode = parsers[i]->mErrorCode;
+			mErrorMsg = parsers[i]->mErrorMsg;
+			mLineNumber = parsers[i]->mLineNumber;
+			mIndentChar = parsers[i]->mIndentChar;
+			mIndentCharCount = parsers[i]->mIndentCharCount;
+			if (!chunkSuccess[i]) {
+				return false;
+			}
+		}
+	}
+
+	// concatenate the top level entries of all chunks
+	std::size_t entryCount = 0;
+	for (const Value& chunkRoot : chunkRoots) {
+		entryCount += chunkRoot.mObject.size();
+	}
+	root = std::move(chunkRoots[0]);
+	root.mObject.reserve(entryCount);
+	for (std::size_t i = 1; i < chunkCount; ++i) {
+		std::vector<NameValuePair>& obj = chunkRoots[i].mObject;
+		root.mObject.insert(root.mObject.end(),
+				std::make_move_iterator(obj.begin()),
+				std::make_move_iterator(obj.end()));
+	}
+	return true;
+}
+
+bool cfg::TmlParser::beginTopLevelEntries()
+{
+	mEntryLines.clear();
+	mNextEntryLine.clear();
+	mHasNextEntryLine = false;
+	mEntriesEnd = false;
+	mEntries.clear();
+	mEntryIndex = 0;
+	mIndentChar = 0;
+	mIndentCharCount = 1;
+	return begin();
+}
+
+int cfg::TmlParser::getNextTopLevelEntry(NameValuePair& entry,
+		bool inclEmptyLines, bool inclComments)
+{
+	// a top level entry can also result in no entry (projection) or in
+	// more than one entry (moved empty lines and comments)
+	while (mEntryIndex >= mEntries.size()) {
+		if (mEntriesEnd) {
+			return -2;
+		}
+		if (!readTopLevelEntry(inclEmptyLines, inclComments)) {
+			mEntriesEnd = true;
+			mEntries.clear();
+			mEntryIndex = 0;
+			return -1;
+		}
+	}
+	entry = std::move(mEntries[mEntryIndex]);
+	++mEntryIndex;
+	return 0;
+}
+
+bool cfg::TmlParser::readTopLevelEntry(bool inclEmptyLines, bool inclComments)
+{
+	mEntries.clear();
+	mEntryIndex = 0;
+	// Same split as for getAsTreeParallel(): an entry ends before the
+	// next line with a deep of 0 (see isChunkStartChar()).
+	std::string& lines = mEntryLines;
+	lines.clear();
+	unsigned int lineNumberOffset = mLineNumber;
+	bool hasEntryStart = false;
+	if (mHasNextEntryLine) {
+		lines = mNextEntryLine;
+		lines.push_back('\n');
+		mHasNextEntryLine = false;
+		hasEntryStart = true;
+		--lineNumberOffset;
+	}
+	while (readLine()) {
+		bool isEntryStart = !mLine.empty() && isChunkStartChar(mLine[0]);
+		if (isEntryStart && hasEntryStart) {
+			mNextEntryLine.swap(mLine);
+			mHasNextEntryLine = true;
+			break;
+		}
+		hasEntryStart = hasEntryStart || isEntryStart;
+		lines += mLine;
+		lines.push_back('\n');
+	}
+	if (!mHasNextEntryLine) {
+		mEntriesEnd = true;
+		if (lines.empty()) {
+			return true;
+		}
+	}
+
+	Value root;
+	if (!parseEntryLines(lines, lineNumberOffset, inclEmptyLines, inclComments, root)) {
+		return false;
+	}
+	mEntries = std::move(root.mObject);
+	return true;
+}
+
+bool cfg::TmlParser::parseEntryLines(const std::string& lines,
+		unsigned int lineNumberOffset, bool inclEmptyLines, bool inclComments,
+		Value& outRoot)
+{
+	if (!mEntryParser) {
+		mEntryParser.reset(new TmlParser());
+	}
+	TmlParser& p = *mEntryParser;
+	p.mSource = Source::CUSTOM_STREAM;
+	p.mFilename = mFilename;
+	p.mFilenamePtr = getFilenamePtr();
+	p.mIndentChar = mIndentChar;
+	p.mIndentCharCount = mIndentCharCount;
+	p.mLineNumberOffset = lineNumberOffset;
+	p.mPackNumericArrays = mPackNumericArrays;
+	p.mProjection = mProjection;
+	MemoryStreamBuf streamBuf(lines.data(), lines.data() + lines.size());
+	std::istream is(&streamBuf);
+	p.mInStream = &is;
+	bool success = p.getAsTree(outRoot, inclEmptyLines, inclComments);
+	p.mInStream = nullptr;
+	// the first indented line of the file defines the indention
+	mIndentChar = p.mIndentChar;
+	mIndentCharCount = p.mIndentCharCount;
+	if (!success) {
+		mErrorCode = p.mErrorCode;
+		mErrorMsg = p.mErrorMsg;
+		mLineNumber = p.mLineNumber;
+		return false;
+	}
+	return true;
+}
+
+bool cfg::TmlParser::beginFeed(const std::string& pseudoFilename,
+		bool inclEmptyLines, bool inclComments)
+{
+	reset();
+
+	mSource = Source::FEED;
+	mFilename = pseudoFilename;
+	mStrBuffer.clear();
+	mFeedInclEmptyLines = inclEmptyLines;
+	mFeedInclComments = inclComments;
+	mFeedHasEntryStart = false;
+	mFeedLineNumberOffset = 0;
+	mFeedEntries.clear();
+	return true;
+}
+
+bool cfg::TmlParser::feed(const char* data, std::size_t size)
+{
+	if (mSource != Source::FEED) {
+		if (mErrorMsg.empty()) {
+			mErrorMsg = "No feed is started (see beginFeed()).";
+		}
+		return false;
+	}
+	const char* end = data + size;
+	while (data < end) {
+		const char* lineEnd = static_cast<const char*>(memchr(data, '\n',
+				static_cast<std::size_t>(end - data)));
+		if (!lineEnd) {
+			// keep the partial line for the next call
+			mLine.append(data, end);
+			break;
+		}
+		mLine.append(data, lineEnd);
+		data = lineEnd + 1;
+		++mLineNumber;
+		if (!feedLine()) {
+			return false;
+		}
+		mLine.clear();
+	}
+	return true;
+}
+
+bool cfg::TmlParser::finish(Value& root)
+{
+	root.clear();
+	if (mSource != Source::FEED) {
+		if (mErrorMsg.empty()) {
+			mErrorMsg = "No feed is started (see beginFeed()).";
+		}
+		return false;
+	}
+	// the last line can be without a line break
+	if (!mLine.empty()) {
+		++mLineNumber;
+		if (!feedLine()) {
+			return false;
+		}
+		mLine.clear();
+	}
+	if (!mEntryLines.empty() && !feedEntryLines()) {
+		return false;
+	}
+	mSource = Source::NONE;
+	root.setObject();
+	root.mLineNumber = 1;
+	root.mOffset = 0;
+	root.mObject.swap(mFeedEntries);
+	return true;
+}
+
+bool cfg::TmlParser::feedLine()
+{
+	// same split as for getNextTopLevelEntry()
+	bool isEntryStart = !mLine.empty() && isChunkStartChar(mLine[0]);
+	if (isEntryStart && mFeedHasEntryStart) {
+		if (!feedEntryLines()) {
+			return false;
+		}
+		mFeedLineNumberOffset = mLineNumber - 1;
+	}
+	mFeedHasEntryStart = mFeedHasEntryStart || isEntryStart;
+	mEntryLines += mLine;
+	mEntryLines.push_back('\n');
+	return true;
+}
+
+bool cfg::TmlParser::feedEntryLines()
+{
+	Value root;
+	if (!parseEntryLines(mEntryLines, mFeedLineNumberOffset,
+			mFeedInclEmptyLines, mFeedInclComments, root)) {
+		mSource = Source::NONE;
+		mFeedEntries.clear();
+		return false;
+	}
+	mEntryLines.clear();
+	if (mFeedEntries.empty()) {
+		mFeedEntries.swap(root.mObject);
+	}
+	else {
+		std::move(root.mObject.begin(), root.mObject.end(),
+				std::back_inserter(mFeedEntries));
+	}
+	return true;
+}
+
+bool cfg::TmlParser::getIndexedEntry(const TmlIndex& index, std::size_t entryIndex,
+		NameValuePair& entry, bool inclEmptyLines, bool inclComments)
+{
+	reset();
+	mSource = Source::NONE;
+	mFilename = index.getFilename();
+	const std::vector<TmlIndex::Entry>& entries = index.getEntries();
+	if (entryIndex >= entries.size()) {
+		mErrorMsg = "Index entry " + std::to_string(entryIndex) + " doesn't exist.";
+		return false;
+	}
+	if (!index.isUpToDate()) {
+		mErrorMsg = "The index isn't up to date.";
+		return false;
+	}
+	const TmlIndex::Entry& indexEntry = entries[entryIndex];
+	std::ifstream ifs(mFilename, std::ios::in | std::ios::binary);
+	std::string& block = mEntryLines;
+	block.resize(static_cast<std::size_t>(indexEntry.mEnd - indexEntry.mBegin));
+	ifs.seekg(static_cast<std::streamoff>(indexEntry.mBegin));
+	ifs.read(&block[0], static_cast<std::streamsize>(block.size()));
+	if (!ifs.is_open() || ifs.fail()) {
+		mErrorMsg = "Can't read the entry.";
+		return false;
+	}
+	// a child of a top level entry is parsed without its indention
+	std::string indent(index.getIndentCharCount(), index.getIndentChar());
+	if (indexEntry.mDeep > 0) {
+		std::string lines;
+		lines.swap(block);
+		std::size_t pos = 0;
+		while (pos < lines.size()) {
+			std::size_t lineEnd = lines.find('\n', pos);
+			lineEnd = lineEnd == std::string::npos ? lines.size() : lineEnd + 1;
+			if (lines.compare(pos, indent.size(), indent) == 0) {
+				pos += indent.size();
+			}
+			block.append(lines, pos, lineEnd - pos);
+			pos = lineEnd;
+		}
+	}
+
+	if (!mEntryParser) {
+		mEntryParser.reset(new TmlParser());
+	}
+	TmlParser& p = *mEntryParser;
+	p.mSource = Source::CUSTOM_STREAM;
+	p.mFilename = mFilename;
+	p.mFilenamePtr = getFilenamePtr();
+	p.mIndentChar = index.getIndentChar();
+	p.mIndentCharCount = index.getIndentCharCount();
+	p.mLineNumberOffset = indexEntry.mLineNumber - 1;
+	p.mPackNumericArrays = mPackNumericArrays;
+	p.mProjection.clear();
+	MemoryStreamBuf streamBuf(block.data(), block.data() + block.size());
+	std::istream is(&streamBuf);
+	p.mInStream = &is;
+	Value root;
+	bool success = p.getAsTree(root, inclEmptyLines, inclComments);
+	p.mInStream = nullptr;
+	block.clear();
+	if (!success) {
+		mErrorCode = p.mErrorCode;
+		mErrorMsg = p.mErrorMsg;
+		mLineNumber = p.mLineNumber;
+		return false;
+	}
+	// the empty lines and comments after the entry belong to the root
+	for (NameValuePair& pair : root.mObject) {
+		if (!pair.isEmptyOrComment()) {
+			if (indexEntry.mDeep > 0) {
+				addIndention(pair, indexEntry.mDeep, static_cast<int>(indent.size()));
+			}
+			entry = std::move(pair);
+			return true;
+		}
+	}
+	mErrorMsg = "The index doesn't match the file.";
+	mLineNumber = indexEntry.mLineNumber;
+	return false;
+}
+
+bool cfg::TmlParser::validateStream(SchemaValidator& validator,
+		bool stopAtFirstViolation, std::string& outErrorMsg)
+{
+	outErrorMsg.clear();
+	validator.beginStream(getFilenamePtr());
+	if (!begin()) {
+		outErrorMsg = getExtendedErrorMsg();
+		return false;
+	}
+	const std::shared_ptr<const std::string>& filenamePtr = getFilenamePtr();
+
+	NameValuePair entry;
+	entry.mName.mFilename = filenamePtr;
+	entry.mValue.mFilename = filenamePtr;
+	// A name without a value can be the parent of an object or an array.
+	// This is only known with the next entry --> the previous entry
+	// is pending until the next entry is read.
+	NameValuePair pending;
+	pending.mName.mFilename = filenamePtr;
+	pending.mValue.mFilename = filenamePtr;
+	int pendingDeep = -1;
+	int openObjectCount = 0;
+	int deep = getNextValueEntry(entry);
+	while (deep >= 0) {
+		if (pendingDeep >= 0) {
+			if (deep > pendingDeep + 1) {
+				mErrorMsg = "Can't increase the deep more than one per entry.";
+				outErrorMsg = getExtendedErrorMsg();
+				return false;
+			}
+			if (deep == pendingDeep + 1) {
+				// --> pending entry is the parent of the current entry
+				bool isArrayParent = false;
+				const char* error = getObjectParentError(pending, isArrayParent);
+				if (error) {
+					mErrorMsg = error;
+					outErrorMsg = getExtendedErrorMsg();
+					return false;
+				}
+				if (isArrayParent) {
+					// --> array with multiple lines
+					if (!readSection(pending.mValue, pendingDeep, entry, deep)) {
+						outErrorMsg = getExtendedErrorMsg();
+						return false;
+					}
+					validator.streamNameValuePair(pending, outErrorMsg);
+					pendingDeep = -1;
+					if (stopAtFirstViolation && validator.getViolationCount()) {
+						return false;
+					}
+					// entry and deep are already the next entry
+					continue;
+				}
+				validator.streamBeginObject(pending.mName, outErrorMsg);
+				++openObjectCount;
+			}
+			else {
+				validator.streamNameValuePair(pending, outErrorMsg);
+			}
+			pendingDeep = -1;
+		}
+		else if (deep > openObjectCount) {
+			mErrorMsg = "No parent entry exist.";
+			outErrorMsg = getExtendedErrorMsg();
+			return false;
+		}
+		for (; openObjectCount > deep; --openObjectCount) {
+			validator.streamEndObject(outErrorMsg);
+		}
+		if (stopAtFirstViolation && validator.getViolationCount()) {
+			return false;
+		}
+		const char* error = getPairNameError(entry.mName);
+		if (error) {
+			mErrorMsg = error;
+			outErrorMsg = getExtendedErrorMsg();
+			return false;
+		}
+		std::swap(pending, entry);
+		pendingDeep = deep;
+		deep = getNextValueEntry(entry);
+	}
+	if (deep == -1) {
+		outErrorMsg = getExtendedErrorMsg();
+		return false;
+	}
+	if (pendingDeep >= 0) {
+		validator.streamNameValuePair(pending, outErrorMsg);
+	}
+	for (; openObjectCount > 0; --openObjectCount) {
+		validator.streamEndObject(outErrorMsg);
+	}
+	return validator.endStream(outErrorMsg);
+}
+
+int cfg::TmlParser::getNextValueEntry(NameValuePair& entry)
+{
+	int deep = 0;
+	while ((deep = getNextTmlEntry(entry)) >= 0) {
+		if (!entry.isEmptyOrComment()) {
+			return deep;
+		}
+	}
+	return deep;
+}
+
+bool cfg::TmlParser::readSection(Value& container, int parentDeep,
+		NameValuePair& entry, int& deep)
+{
+	while (deep > parentDeep) {
+		if (deep > parentDeep + 1) {
+			mErrorMsg = "Can't increase the deep more than one per entry.";
+			return false;
+		}
+		Value* last = nullptr;
+		if (container.isArray()) {
+			if (!entry.mValue.isEmpty()) {
+				mErrorMsg = "An array can only store a value as element and no name value pair.";
+				return false;
+			}
+			container.mArray.push_back(std::move(entry.mName));
+			last = &container.mArray.back();
+			entry.mName.mFilename = last->mFilename;
+		}
+		else {
+			const char* error = getPairNameError(entry.mName);
+			if (error) {
+				mErrorMsg = error;
+				return false;
+			}
+			container.mObject.push_back(std::move(entry));
+			last = &container.mObject.back().mValue;
+			// the moved entry is reused for the next entry
+			entry.mName.mFilename = last->mFilename;
+			entry.mValue.mFilename = last->mFilename;
+		}
+		deep = getNextValueEntry(entry);
+		if (deep == parentDeep + 2) {
+			// --> last is the parent of the next entries (same rules as getAsTree())
+			bool isArrayParent = false;
+			const char* error = container.isArray() ?
+					getArrayParentError(*last, isArrayParent) :
+					getObjectParentError(container.mObject.back(), isArrayParent);
+			if (error) {
+				mErrorMsg = error;
+				return false;
+			}
+			if (isArrayParent) {
+				last->setArray();
+			}
+			else {
+				last->setObject();
+			}
+			if (!readSection(*last, parentDeep + 1, entry, deep)) {
+				return false;
+			}
+		}
+	}
+	return deep != -1;
+}
+
 std::string cfg::TmlParser::getExtendedErrorMsg() const
 {
 	return mFilename + ":" + std::to_string(mLineNumber) + ": " + mErrorMsg;
@@ -1,5 +1,6 @@
 #include <tml/tml_string.h>
 #include <cfg/cfg.h>
+#include <cfg/cfg_number.h>
 #include <sstream>
 
 namespace cfg
@@ -148,6 +149,12 @@ namespace cfg
 				case Value::TYPE_INT:
 					ss << cfgValue.mInteger;
 					break;
+				case Value::TYPE_INT64:
+					ss << cfgValue.mInteger64;
+					break;
+				case Value::TYPE_DOUBLE:
+					ss << number::doubleToString(cfgValue.mDouble, false);
+					break;
 				case Value::TYPE_TEXT:
 					ss << getTextForTml(cfgValue.mText, cfgValue.mParseTextWithQuotes);
 					break;
@@ -192,6 +199,12 @@ namespace cfg
 				}
 				return;
 			}
+			if (cfgValue.isPackedArray()) {
+				Value unpacked = cfgValue;
+				unpacked.unpackArray();
+				addValueToStream(deep, unpacked, ss, tl, forceDeepByStoredDeepValue);
+				return;
+			}
 			if (cfgValue.isArray()) {
 				if (cfgValue.mArray.empty()) {
 					if (ss) {
@@ -457,6 +470,11 @@ std::string cfg::tmlstring::plainValueToString(const Value& cfgValue)
 		ss << "#" << cfgValue.mText;
 		return ss.str();
 	}
+	if (cfgValue.isPackedArray()) {
+		Value unpacked = cfgValue;
+		unpacked.unpackArray();
+		return plainValueToString(unpacked);
+	}
 	if (cfgValue.isArray()) {
 		if (cfgValue.isComplexArray()) {
 			return "ERROR";
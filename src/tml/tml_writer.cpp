@@ -0,0 +1,130 @@
+#include <tml/tml_writer.h>
+#include <tml/tml_string.h>
+
+namespace cfg
+{
+	namespace
+	{
+		void addTab(std::ostream& s, int count)
+		{
+			for (int i = 0; i < count; ++i) {
+				s << '\t';
+			}
+		}
+	}
+}
+
+cfg::TmlWriter::TmlWriter(std::ostream& s)
+		:mStream(s)
+{
+	mFrames.emplace_back(false, -1, false);
+}
+
+void cfg::TmlWriter::writePair(const NameValuePair& nvp)
+{
+	prepareObjectChild();
+	tmlstring::nameValuePairToStream(mFrames.back().mDeep + 1, nvp, mStream);
+}
+
+void cfg::TmlWriter::writeElement(const Value& value)
+{
+	Frame& frame = mFrames.back();
+	if (value.isSimple() && !frame.mIsComplex) {
+		frame.mSimpleTexts.push_back(tmlstring::plainValueToString(value));
+		return;
+	}
+	makeComplex(frame);
+	addTab(mStream, frame.mDeep + 1);
+	mStream << tmlstring::plainValueToString(value) << "\n";
+}
+
+void cfg::TmlWriter::beginObject(const Value* name)
+{
+	beginChild(name, "{}");
+	mFrames.emplace_back(false, mFrames.back().mDeep + 1, name != nullptr);
+}
+
+void cfg::TmlWriter::endObject()
+{
+	const Frame& frame = mFrames.back();
+	if (!frame.mHasChildren) {
+		mStream << (frame.mIsNamed ? " = {}\n" : "\n");
+	}
+	mFrames.pop_back();
+}
+
+void cfg::TmlWriter::beginArray(const Value* name)
+{
+	beginChild(name, "");
+	mFrames.emplace_back(true, mFrames.back().mDeep + 1, name != nullptr);
+}
+
+void cfg::TmlWriter::endArray()
+{
+	const Frame& frame = mFrames.back();
+	if (!frame.mIsComplex) {
+		if (frame.mIsNamed) {
+			mStream << " = ";
+		}
+		if (frame.mSimpleTexts.empty()) {
+			mStream << "[]";
+		}
+		for (std::size_t i = 0; i < frame.mSimpleTexts.size(); ++i) {
+			if (i) {
+				mStream << " ";
+			}
+			mStream << frame.mSimpleTexts[i];
+		}
+		mStream << "\n";
+	}
+	mFrames.pop_back();
+}
+
+void cfg::TmlWriter::endDocument()
+{
+	if (!mFrames.back().mHasChildren) {
+		// same as the output of an empty root object
+		mStream << "\n";
+	}
+}
+
+void cfg::TmlWriter::prepareObjectChild()
+{
+	Frame& frame = mFrames.back();
+	if (!frame.mHasChildren) {
+		frame.mHasChildren = true;
+		if (frame.mDeep >= 0) {
+			// finish the line of the object (the root has no line)
+			mStream << "\n";
+		}
+	}
+}
+
+void cfg::TmlWriter::makeComplex(Frame& frame)
+{
+	if (frame.mIsComplex) {
+		return;
+	}
+	frame.mIsComplex = true;
+	mStream << (frame.mIsNamed ? " = []\n" : "[]\n");
+	for (const std::string& text : frame.mSimpleTexts) {
+		addTab(mStream, frame.mDeep + 1);
+		mStream << text << "\n";
+	}
+	frame.mSimpleTexts.clear();
+}
+
+void cfg::TmlWriter::beginChild(const Value* name, const char* arrayElementText)
+{
+	Frame& parent = mFrames.back();
+	if (parent.mIsArray) {
+		makeComplex(parent);
+		addTab(mStream, parent.mDeep + 1);
+		mStream << arrayElementText;
+	}
+	else {
+		prepareObjectChild();
+		addTab(mStream, parent.mDeep + 1);
+		mStream << tmlstring::plainValueToString(*name);
+	}
+}